@@ -5,6 +5,9 @@
 #include "Kernel.h"
 #include "DMA.h"
 #include "Chip8259A.h"
+#include "TimeInterrupt.h"
+
+Timer ATADriver::m_Watchdog = { NULL, NULL, 0, ATADriver::Timeout, 0 };
 
 void ATADriver::ATAHandler(struct pt_regs *reg, struct pt_context *context)
 {
@@ -21,6 +24,7 @@ void ATADriver::ATAHandler(struct pt_regs *reg, struct pt_context *context)
 		return;		/* û */
 	}
 
+	Time::DelTimer(&ATADriver::m_Watchdog);	/* жϰʱȡʱʱ */
 	bp = atab->d_actf;		/* ȡж϶ӦI/OBuf */
 	atab->d_active = 0;		/* ʾ豸Ѿ */
 
@@ -108,9 +112,43 @@ void ATADriver::DevStart(struct Buf* bp)
 		
 		DMA::Start(DMA::WRITE, table.GetPRDTableBaseAddress());
 	}
+
+	/* ж϶ʧʱɳʱʱI/OʹȴûĽԶ˯ */
+	Time::AddTimer(&ATADriver::m_Watchdog, Time::DISK_TIMEOUT);
 	return;
 }
 
+void ATADriver::Timeout(unsigned long arg)
+{
+	Buf* bp;
+	Devtab* atab;
+	short major = Utility::GetMajor(DeviceManager::ROOTDEV);
+
+	BlockDevice& bdev = 
+		Kernel::Instance().GetDeviceManager().GetBlockDevice(major);
+	atab = bdev.d_tab;
+
+	if( atab->d_active == 0 )
+	{
+		return;
+	}
+
+	/* ATAHandler()еĳͬ10ʧԳ */
+	bp = atab->d_actf;
+	atab->d_active = 0;
+	if(++atab->d_errcnt <= 10)
+	{
+		bdev.Start();
+		return;
+	}
+	bp->b_flags |= Buf::B_ERROR;
+
+	atab->d_errcnt = 0;
+	atab->d_actf = bp->av_forw;
+	Kernel::Instance().GetBufferManager().IODone(bp);
+	bdev.Start();
+}
+
 int ATADriver::IsControllerReady()
 {
 	int ticks = 10000;
@@ -1,6 +1,7 @@
 #include "BlockDevice.h"
 #include "Kernel.h"
 #include "ATADriver.h"
+#include "Trace.h"
 
 /*==============================class Devtab===================================*/
 /* 豸devtabʵΪϵͳATAӲһ豸*/
@@ -100,6 +101,8 @@ int ATABlockDevice::Close(short dev, int mode)
 
 int ATABlockDevice::Strategy(Buf* bp)
 {
+	TRACE(Trace::TR_STRATEGY, bp->b_blkno | ((bp->b_flags & Buf::B_READ) ? 0x80000000 : 0), bp);
+
 	/* I/OǷ񳬳˸Ӳ̵ */
 	if(bp->b_blkno >= ATABlockDevice::NSECTOR)
 	{
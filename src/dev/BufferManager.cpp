@@ -1,5 +1,6 @@
 #include "BufferManager.h"
 #include "Kernel.h"
+#include "Trace.h"
 
 BufferManager::BufferManager()
 {
@@ -201,6 +202,8 @@ void BufferManager::IOWait(Buf* bp)
 
 void BufferManager::IODone(Buf* bp)
 {
+	TRACE(Trace::TR_IODONE, bp->b_blkno | ((bp->b_flags & Buf::B_READ) ? 0x80000000 : 0), bp);
+
 	/* I/Oɱ־ */
 	bp->b_flags |= Buf::B_DONE;
 	if(bp->b_flags & Buf::B_ASYNC)
@@ -245,7 +248,6 @@ Buf* BufferManager::Bread(short dev, int blkno)
 Buf* BufferManager::Breada(short adev, int blkno, int rablkno)
 {
 	Buf* bp = NULL;	/* ԤַĻBuf */
-	Buf* abp;		/* ԤַĻBuf */
 	short major = Utility::GetMajor(adev);	/* 豸 */
 
 	/* ǰַǷ豸Buf */
@@ -282,28 +284,9 @@ Buf* BufferManager::Breada(short adev, int blkno, int rablkno)
 	 * 		ͷȻ豸Уڶʱ
 	 * 		ʹһ飬ôȻҵ
 	 * */
-	if( rablkno && !this->InCore(adev, rablkno) )
+	if( rablkno )
 	{
-		abp = this->GetBlk(adev, rablkno);	/* ûҵGetBlk()仺 */
-		
-		/* B_DONE־λͬϡ */
-		if(abp->b_flags & Buf::B_DONE)
-		{
-			/* ԤַڻУͷռõĻ档
-			 * ΪδغһʹԤַ飬
-			 * ҲͲȥͷŸû棬пܵ»Դ
-			 * ĳʱռá
-			 */
-			this->Brelse(abp);
-		}
-		else
-		{
-			/* 첽Ԥַ */
-			abp->b_flags |= (Buf::B_READ | Buf::B_ASYNC);
-			abp->b_wcount = BufferManager::BUFFER_SIZE;
-			/* 豸I/O */
-			this->m_DeviceManager->GetBlockDevice(major).Strategy(abp);
-		}
+		this->Prefetch(adev, rablkno);
 	}
 	
 	/* bp == NULLζInCore()ʱ̣Ԥ豸У
@@ -323,6 +306,38 @@ Buf* BufferManager::Breada(short adev, int blkno, int rablkno)
 	return bp;
 }
 
+void BufferManager::Prefetch(short adev, int blkno)
+{
+	Buf* abp;
+	short major = Utility::GetMajor(adev);
+
+	if( this->InCore(adev, blkno) )
+	{
+		return;
+	}
+
+	abp = this->GetBlk(adev, blkno);	/* ûҵGetBlk()仺 */
+
+	/* B_DONE־λͬBreada() */
+	if(abp->b_flags & Buf::B_DONE)
+	{
+		/* ԤַڻУͷռõĻ档
+		 * ΪδغһʹԤַ飬
+		 * ҲͲȥͷŸû棬пܵ»Դ
+		 * ĳʱռá
+		 */
+		this->Brelse(abp);
+	}
+	else
+	{
+		/* 첽Ԥַ飬I/OIODone()ͷŻ */
+		abp->b_flags |= (Buf::B_READ | Buf::B_ASYNC);
+		abp->b_wcount = BufferManager::BUFFER_SIZE;
+		/* 豸I/O */
+		this->m_DeviceManager->GetBlockDevice(major).Strategy(abp);
+	}
+}
+
 void BufferManager::Bwrite(Buf *bp)
 {
 	unsigned int flags;
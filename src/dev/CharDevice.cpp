@@ -1,6 +1,7 @@
 #include "CharDevice.h"
 #include "Utility.h"
 #include "Kernel.h"
+#include "Serial.h"
 
 /*==============================class CharDevice===============================*/
 CharDevice::CharDevice()
@@ -33,9 +34,10 @@ void CharDevice::Write(short dev)
 	Utility::Panic("ERROR! Base Class: CharDevice::Write()!");
 }
 
-void CharDevice::SgTTy(short dev, TTy* pTTy)
+int CharDevice::SgTTy(short dev, int flags)
 {
 	Utility::Panic("ERROR! Base Class: CharDevice::SgTTy()!");
+	return 0;
 }
 
 
@@ -114,6 +116,67 @@ void ConsoleDevice::Write(short dev)
 	}
 }
 
-void ConsoleDevice::SgTTy(short dev, TTy *pTTy)
+int ConsoleDevice::SgTTy(short dev, int flags)
 {
+	return this->m_TTy->SgTTy(flags);
+}
+
+
+/*==============================class SerialDevice===============================*/
+SerialDevice g_SerialDevice;
+
+SerialDevice::SerialDevice()
+{
+	//nothing to do here
+}
+
+SerialDevice::~SerialDevice()
+{
+	//nothing to do here
+}
+
+void SerialDevice::Open(short dev, int mode)
+{
+	User& u = Kernel::Instance().GetUser();
+
+	/* ûм⵽COM1ѡĲCOM1 */
+	if ( NULL == Serial::m_TTy || Utility::GetMinor(dev) != 0 )
+	{
+		u.u_error = User::ENXIO;
+		return;
+	}
+	this->m_TTy = Serial::m_TTy;
+
+	if ( NULL == u.u_procp->p_ttyp )
+	{
+		u.u_procp->p_ttyp = this->m_TTy;
+	}
+
+	if ( (this->m_TTy->t_state & TTy::ISOPEN) == 0 )
+	{
+		this->m_TTy->t_state = TTy::ISOPEN | TTy::CARR_ON;
+		this->m_TTy->t_flags = TTy::ECHO;
+		this->m_TTy->t_erase = TTy::CERASE;
+		this->m_TTy->t_kill = TTy::CKILL;
+	}
+}
+
+void SerialDevice::Close(short dev, int mode)
+{
+	//nothing to do here
+}
+
+void SerialDevice::Read(short dev)
+{
+	this->m_TTy->TTRead();
+}
+
+void SerialDevice::Write(short dev)
+{
+	this->m_TTy->TTWrite();
+}
+
+int SerialDevice::SgTTy(short dev, int flags)
+{
+	return this->m_TTy->SgTTy(flags);
 }
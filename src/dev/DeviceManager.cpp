@@ -2,6 +2,7 @@
 
 extern ATABlockDevice g_ATADevice;
 extern ConsoleDevice g_ConsoleDevice;
+extern SerialDevice g_SerialDevice;
 
 DeviceManager::DeviceManager()
 {
@@ -17,7 +18,8 @@ void DeviceManager::Initialize()
 	this->nblkdev = 1;
 
 	this->cdevsw[0] = &g_ConsoleDevice;
-	this->nchrdev = 1;
+	this->cdevsw[1] = &g_SerialDevice;
+	this->nchrdev = 2;
 }
 
 int DeviceManager::GetNBlkDev()
@@ -9,6 +9,7 @@ File::File()
 	this->f_flag = 0;
 	this->f_offset = 0;
 	this->f_inode = NULL;
+	this->f_pipe = NULL;
 }
 
 File::~File()
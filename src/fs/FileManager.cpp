@@ -2,6 +2,7 @@
 #include "Kernel.h"
 #include "Utility.h"
 #include "TimeInterrupt.h"
+#include "Assembly.h"
 
 /*==========================class FileManager===============================*/
 FileManager::FileManager()
@@ -147,7 +148,7 @@ void FileManager::Open1(Inode* pInode, int mode, int trf)
 		return;
 	}
 	/* ôļʽFileṹڴInodeĹϵ */
-	pFile->f_flag = mode & (File::FREAD | File::FWRITE);
+	pFile->f_flag = mode & (File::FREAD | File::FWRITE | File::FNDELAY);
 	pFile->f_inode = pInode;
 
 	/* 豸򿪺 */
@@ -268,6 +269,27 @@ void FileManager::FStat()
 		return;
 	}
 
+	/* 
+	 * ܵûInodeṹ0ѺջϵݸƵûռ䣬
+	 * ܵпɶȡֽܵûĿ¼Ϊ0ɶд
+	 */
+	if ( pFile->f_flag & File::FPIPE )
+	{
+		DiskInode dInode;
+		int* pInt = (int *)&dInode;
+		for ( unsigned int i = 0; i < sizeof(DiskInode)/sizeof(int); i++ )
+		{
+			pInt[i] = 0;
+		}
+		dInode.d_mode = Inode::IALLOC | Inode::IREAD | Inode::IWRITE;
+		dInode.d_nlink = 0;
+		dInode.d_uid = u.u_uid;
+		dInode.d_gid = u.u_gid;
+		dInode.d_size = pFile->f_pipe->Count();
+		Utility::DWordCopy( (int *)&dInode, (int *)u.u_arg[1], sizeof(DiskInode)/sizeof(int) );
+		return;
+	}
+
 	/* u.u_arg[1] = pStatBuf */
 	this->Stat1(pFile->f_inode, u.u_arg[1]);
 }
@@ -316,7 +338,9 @@ void FileManager::Write()
 void FileManager::Rdwr( enum File::FileFlags mode )
 {
 	File* pFile;
+	TTy* pTTy;
 	User& u = Kernel::Instance().GetUser();
+	int count = u.u_arg[2];		/* Ҫ/дֽ */
 
 	/* Read()/Write()ϵͳòfdȡļƿṹ */
 	pFile = u.u_ofiles.GetF(u.u_arg[0]);	/* fd */
@@ -336,7 +360,7 @@ void FileManager::Rdwr( enum File::FileFlags mode )
 	}
 
 	u.u_IOParam.m_Base = (unsigned char *)u.u_arg[1];	/* Ŀ껺ַ */
-	u.u_IOParam.m_Count = u.u_arg[2];		/* Ҫ/дֽ */
+	u.u_IOParam.m_Count = count;
 	u.u_segflg = 0;		/* User Space I/OҪݶλûջ */
 
 	/* ܵд */
@@ -356,6 +380,22 @@ void FileManager::Rdwr( enum File::FileFlags mode )
 	ΪInodeҪNFlock()NFrele()
 	ⲻV6ơreadwriteϵͳöڴiڵΪ˸ʵʩIOĽṩһµļͼ*/
 	{
+		/* ʽдնˣûпɶȡ룬ʱ˯ */
+		if ( (pFile->f_flag & File::FNDELAY) && NULL != (pTTy = this->GetTTy(pFile)) )
+		{
+			if ( File::FREAD == mode ? !pTTy->ReadReady() : !pTTy->WriteReady() )
+			{
+				u.u_error = User::EAGAIN;
+				return;
+			}
+			/* жȡ豸ֻдɵµĲ */
+			if ( File::FWRITE == mode && NULL != pTTy->t_oproc )
+			{
+				count = Utility::Min(count, pTTy->t_outq.FreeNum());
+				u.u_IOParam.m_Count = count;
+			}
+		}
+
 		pFile->f_inode->NFlock();
 		/* ļʼλ */
 		u.u_IOParam.m_Offset = pFile->f_offset;
@@ -369,25 +409,514 @@ void FileManager::Rdwr( enum File::FileFlags mode )
 		}
 
 		/* ݶдƶļдƫָ */
-		pFile->f_offset += (u.u_arg[2] - u.u_IOParam.m_Count);
+		pFile->f_offset += (count - u.u_IOParam.m_Count);
 		pFile->f_inode->NFrele();
 	}
 
 	/* ʵʶдֽ޸Ĵϵͳ÷ֵĺջԪ */
-	u.u_ar0[User::EAX] = u.u_arg[2] - u.u_IOParam.m_Count;
+	u.u_ar0[User::EAX] = count - u.u_IOParam.m_Count;
 }
 
-void FileManager::Pipe()
+void FileManager::Pread()
+{
+	this->PRdwr(File::FREAD);
+}
+
+void FileManager::Pwrite()
+{
+	this->PRdwr(File::FWRITE);
+}
+
+void FileManager::PRdwr( enum File::FileFlags mode )
+{
+	File* pFile;
+	User& u = Kernel::Instance().GetUser();
+	int count = u.u_arg[2];
+	int offset = u.u_arg[3];
+
+	pFile = u.u_ofiles.GetF(u.u_arg[0]);
+	if ( NULL == pFile )
+	{
+		return;
+	}
+
+	if ( (pFile->f_flag & mode) == 0 )
+	{
+		u.u_error = User::EACCES;
+		return;
+	}
+
+	/* ܵûждλ */
+	if ( pFile->f_flag & File::FPIPE )
+	{
+		u.u_error = User::ESPIPE;
+		return;
+	}
+
+	if ( offset < 0 || count < 0 )
+	{
+		u.u_error = User::EINVAL;
+		return;
+	}
+
+	u.u_IOParam.m_Base = (unsigned char *)u.u_arg[1];
+	u.u_IOParam.m_Count = count;
+	u.u_IOParam.m_Offset = offset;	/* offsetʼдRdwr()ͬʹҲ޸f_offset */
+	u.u_segflg = 0;
+
+	pFile->f_inode->NFlock();
+	if ( File::FREAD == mode )
+	{
+		pFile->f_inode->ReadI();
+	}
+	else
+	{
+		pFile->f_inode->WriteI();
+	}
+	pFile->f_inode->NFrele();
+
+	u.u_ar0[User::EAX] = count - u.u_IOParam.m_Count;
+}
+
+void FileManager::Readv()
+{
+	this->Rdwrv(File::FREAD);
+}
+
+void FileManager::Writev()
+{
+	this->Rdwrv(File::FWRITE);
+}
+
+void FileManager::Rdwrv( enum File::FileFlags mode )
+{
+	File* pFile;
+	TTy* pTTy = NULL;
+	User& u = Kernel::Instance().GetUser();
+	struct iovec iov[FileManager::IOV_MAX];
+	int iovcnt = u.u_arg[2];
+	int total = 0;
+	int i;
+
+	pFile = u.u_ofiles.GetF(u.u_arg[0]);
+	if ( NULL == pFile )
+	{
+		return;
+	}
+
+	if ( (pFile->f_flag & mode) == 0 )
+	{
+		u.u_error = User::EACCES;
+		return;
+	}
+
+	if ( iovcnt <= 0 || iovcnt > FileManager::IOV_MAX )
+	{
+		u.u_error = User::EINVAL;
+		return;
+	}
+
+	/* ȰѶƵջдû޸iovec鲻Ӱ챾ε */
+	for ( i = 0; i < iovcnt; i++ )
+	{
+		iov[i] = ((struct iovec *)u.u_arg[1])[i];
+		if ( iov[i].iov_len < 0 || total + iov[i].iov_len < total )
+		{
+			u.u_error = User::EINVAL;
+			return;
+		}
+		total += iov[i].iov_len;
+	}
+	total = 0;
+	u.u_segflg = 0;
+
+	if ( pFile->f_flag & File::FPIPE )
+	{
+		for ( i = 0; i < iovcnt; i++ )
+		{
+			/* Ѷݺܵȡգ˯ߵȴĶ */
+			if ( i > 0 && File::FREAD == mode && 0 == pFile->f_pipe->Count() )
+			{
+				break;
+			}
+			u.u_IOParam.m_Base = iov[i].iov_base;
+			u.u_IOParam.m_Count = iov[i].iov_len;
+			if ( File::FREAD == mode )
+			{
+				this->ReadP(pFile);
+			}
+			else
+			{
+				this->WriteP(pFile);
+			}
+			total += iov[i].iov_len - u.u_IOParam.m_Count;
+			if ( User::NOERROR != u.u_error || 0 != u.u_IOParam.m_Count )
+			{
+				break;
+			}
+		}
+	}
+	else
+	{
+		pTTy = this->GetTTy(pFile);
+
+		/* InodeֻһΣξReadI()/WriteI()дm_Offsetڶμ˳ */
+		pFile->f_inode->NFlock();
+		u.u_IOParam.m_Offset = pFile->f_offset;
+		for ( i = 0; i < iovcnt; i++ )
+		{
+			u.u_IOParam.m_Base = iov[i].iov_base;
+			u.u_IOParam.m_Count = iov[i].iov_len;
+
+			/* նˣѶһкٵȴһУʽͬRdwr() */
+			if ( NULL != pTTy && (File::FREAD == mode ? !pTTy->ReadReady() : !pTTy->WriteReady()) )
+			{
+				if ( 0 == i && (pFile->f_flag & File::FNDELAY) )
+				{
+					u.u_error = User::EAGAIN;
+				}
+				if ( i > 0 && (File::FREAD == mode || (pFile->f_flag & File::FNDELAY)) )
+				{
+					break;
+				}
+			}
+			if ( NULL != pTTy && File::FWRITE == mode && NULL != pTTy->t_oproc && (pFile->f_flag & File::FNDELAY) )
+			{
+				u.u_IOParam.m_Count = Utility::Min(iov[i].iov_len, pTTy->t_outq.FreeNum());
+			}
+			if ( User::NOERROR != u.u_error )
+			{
+				break;
+			}
+
+			int count = u.u_IOParam.m_Count;
+			if ( File::FREAD == mode )
+			{
+				pFile->f_inode->ReadI();
+			}
+			else
+			{
+				pFile->f_inode->WriteI();
+			}
+			total += count - u.u_IOParam.m_Count;
+
+			/* ļβʱٶдĶ */
+			if ( User::NOERROR != u.u_error || iov[i].iov_len != count - u.u_IOParam.m_Count )
+			{
+				break;
+			}
+		}
+		pFile->f_offset += total;
+		pFile->f_inode->NFrele();
+	}
+
+	/* Ѷдʱضдֽ */
+	if ( total > 0 && User::EAGAIN == u.u_error )
+	{
+		u.u_error = User::NOERROR;
+	}
+	u.u_ar0[User::EAX] = total;
+}
+
+void FileManager::SendFile()
+{
+	File* pOut;
+	File* pIn;
+	Inode* pInode;
+	Buf* pBuf;
+	User& u = Kernel::Instance().GetUser();
+	BufferManager& bufMgr = Kernel::Instance().GetBufferManager();
+	int count = u.u_arg[2];
+	int total = 0;
+	int lbn, bn, offset, nbytes, remain, n;
+
+	pOut = u.u_ofiles.GetF(u.u_arg[0]);
+	if ( NULL == pOut )
+	{
+		return;
+	}
+	pIn = u.u_ofiles.GetF(u.u_arg[1]);
+	if ( NULL == pIn )
+	{
+		return;
+	}
+
+	if ( (pOut->f_flag & File::FWRITE) == 0 || (pIn->f_flag & File::FREAD) == 0 )
+	{
+		u.u_error = User::EACCES;
+		return;
+	}
+
+	/* ԴļΪͨļȷҿ԰鶨λԴĿ겻ͬһļ */
+	pInode = pIn->f_inode;
+	if ( count < 0 || (pIn->f_flag & File::FPIPE) || (pInode->i_mode & Inode::IFMT) != 0
+		|| pOut->f_inode == pInode )
+	{
+		u.u_error = User::EINVAL;
+		return;
+	}
+
+	while ( count > 0 && User::NOERROR == u.u_error )
+	{
+		/* Դļһ飬仺ڼ䲻ԴļͬʱInode */
+		pInode->NFlock();
+		remain = pInode->i_size - pIn->f_offset;
+		if ( remain <= 0 )
+		{
+			pInode->NFrele();
+			break;
+		}
+		lbn = pIn->f_offset / Inode::BLOCK_SIZE;
+		offset = pIn->f_offset % Inode::BLOCK_SIZE;
+		nbytes = Utility::Min(Utility::Min(Inode::BLOCK_SIZE - offset, count), remain);
+
+		if ( (bn = pInode->Bmap(lbn)) == 0 )
+		{
+			pInode->NFrele();
+			break;
+		}
+		pBuf = bufMgr.Bread(pInode->i_dev, bn);
+
+		/* 
+		 * ʽԤBreada()ڵǰڻʱԤ˳ʱԤĿ
+		 * һβŷһԤڵǰ֮ʼձSENDFILE_RA첽롣
+		 */
+		int last = (pInode->i_size - 1) / Inode::BLOCK_SIZE;
+		for ( int ra = lbn + 1; ra <= lbn + FileManager::SENDFILE_RA && ra <= last; ra++ )
+		{
+			if ( (bn = pInode->Bmap(ra)) != 0 )
+			{
+				bufMgr.Prefetch(pInode->i_dev, bn);
+			}
+		}
+		pInode->i_lastr = lbn;
+		pInode->i_flag |= Inode::IACC;
+		pInode->NFrele();
+
+		/* ԴļĻֱдĿļWriteI()дʱҲ */
+		u.u_IOParam.m_Base = pBuf->b_addr + offset;
+		u.u_IOParam.m_Count = nbytes;
+		u.u_segflg = 1;
+		if ( pOut->f_flag & File::FPIPE )
+		{
+			this->WriteP(pOut);
+		}
+		else
+		{
+			pOut->f_inode->NFlock();
+			u.u_IOParam.m_Offset = pOut->f_offset;
+			pOut->f_inode->WriteI();
+			pOut->f_offset += (nbytes - u.u_IOParam.m_Count);
+			pOut->f_inode->NFrele();
+		}
+		bufMgr.Brelse(pBuf);
+
+		n = nbytes - u.u_IOParam.m_Count;
+		pIn->f_offset += n;
+		total += n;
+		count -= n;
+		if ( n != nbytes )
+		{
+			break;
+		}
+	}
+
+	/* ѸƲʱظƵֽ */
+	if ( total > 0 && User::EAGAIN == u.u_error )
+	{
+		u.u_error = User::NOERROR;
+	}
+	u.u_ar0[User::EAX] = total;
+}
+
+void FileManager::GetDents()
+{
+	File* pFile;
+	Inode* pInode;
+	Buf* pBuf;
+	User& u = Kernel::Instance().GetUser();
+	BufferManager& bufMgr = Kernel::Instance().GetBufferManager();
+	unsigned char* base = (unsigned char *)u.u_arg[1];
+	int nbytes = u.u_arg[2];
+	int plus = u.u_arg[3];
+	int recsize = plus ? sizeof(struct direntplus) : sizeof(DirectoryEntry);
+	DirectoryEntry ents[Inode::BLOCK_SIZE / sizeof(DirectoryEntry)];
+	struct direntplus rec;
+	int total = 0;
+	int offset, bn, n, i;
+
+	pFile = u.u_ofiles.GetF(u.u_arg[0]);
+	if ( NULL == pFile )
+	{
+		return;
+	}
+
+	if ( (pFile->f_flag & File::FREAD) == 0 )
+	{
+		u.u_error = User::EACCES;
+		return;
+	}
+
+	pInode = pFile->f_inode;
+	if ( (pFile->f_flag & File::FPIPE) || (pInode->i_mode & Inode::IFMT) != Inode::IFDIR )
+	{
+		u.u_error = User::ENOTDIR;
+		return;
+	}
+
+	if ( nbytes < recsize )
+	{
+		u.u_error = User::EINVAL;
+		return;
+	}
+
+	pInode->NFlock();
+	offset = pFile->f_offset;
+	while ( offset < pInode->i_size && total + recsize <= nbytes && User::NOERROR == u.u_error )
+	{
+		/* ȡǰĿ¼µЧĿ¼ûС */
+		if ( (bn = pInode->Bmap(offset / Inode::BLOCK_SIZE)) == 0 )
+		{
+			break;
+		}
+		pBuf = bufMgr.Breada(pInode->i_dev, bn, Inode::rablock);
+		n = 0;
+		while ( offset < pInode->i_size && total + (n + 1) * recsize <= nbytes )
+		{
+			DirectoryEntry* pEnt = (DirectoryEntry *)(pBuf->b_addr + offset % Inode::BLOCK_SIZE);
+			offset += sizeof(DirectoryEntry);
+
+			/* InodeΪ0ɾĿĿ¼ */
+			if ( 0 != pEnt->m_ino )
+			{
+				ents[n++] = *pEnt;
+			}
+			if ( 0 == offset % Inode::BLOCK_SIZE )
+			{
+				break;
+			}
+		}
+		bufMgr.Brelse(pBuf);
+
+		if ( plus )
+		{
+			this->PrefetchInodes(pInode->i_dev, ents, n);
+		}
+		for ( i = 0; i < n; i++ )
+		{
+			if ( plus )
+			{
+				rec.d_ent = ents[i];
+				this->StatI(pInode->i_dev, ents[i].m_ino, &rec.d_stat);
+				Utility::IOMove((unsigned char *)&rec, base + total, recsize);
+			}
+			else
+			{
+				Utility::IOMove((unsigned char *)&ents[i], base + total, recsize);
+			}
+			total += recsize;
+		}
+	}
+	pFile->f_offset = offset;
+	pInode->i_flag |= Inode::IACC;
+	pInode->NFrele();
+
+	u.u_ar0[User::EAX] = total;
+}
+
+void FileManager::PrefetchInodes(short dev, DirectoryEntry* ents, int n)
+{
+	BufferManager& bufMgr = Kernel::Instance().GetBufferManager();
+	int sectors[FileManager::GETDENTS_RA];
+	int count = 0;
+	int i, j, blkno;
+
+	/* 
+	 * ȥظŲʹͷɨInode
+	 * ͬһĿ¼µļͨInodeһɸ8Ŀ¼
+	 */
+	for ( i = 0; i < n; i++ )
+	{
+		blkno = FileSystem::INODE_ZONE_START_SECTOR + ents[i].m_ino / FileSystem::INODE_NUMBER_PER_SECTOR;
+		for ( j = count; j > 0 && sectors[j - 1] > blkno; j-- );
+		if ( j > 0 && sectors[j - 1] == blkno )
+		{
+			continue;
+		}
+		if ( FileManager::GETDENTS_RA == count )
+		{
+			/* StatI()ͬ */
+			if ( j == count )
+			{
+				continue;
+			}
+			count--;
+		}
+		for ( int k = count; k > j; k-- )
+		{
+			sectors[k] = sectors[k - 1];
+		}
+		sectors[j] = blkno;
+		count++;
+	}
+
+	for ( i = 0; i < count; i++ )
+	{
+		bufMgr.Prefetch(dev, sectors[i]);
+	}
+}
+
+void FileManager::StatI(short dev, int inumber, DiskInode* pStat)
 {
+	Buf* pBuf;
 	Inode* pInode;
+	BufferManager& bufMgr = Kernel::Instance().GetBufferManager();
+	int index;
+
+	pBuf = bufMgr.Bread(dev, FileSystem::INODE_ZONE_START_SECTOR + inumber / FileSystem::INODE_NUMBER_PER_SECTOR);
+	unsigned char* p = pBuf->b_addr + (inumber % FileSystem::INODE_NUMBER_PER_SECTOR) * sizeof(DiskInode);
+	Utility::DWordCopy( (int *)p, (int *)pStat, sizeof(DiskInode)/sizeof(int) );
+	bufMgr.Brelse(pBuf);
+
+	/* 
+	 * ڴInodeܱInode¡Stat1()IUpdate()дٶﲻд̣
+	 * ֱڴInodeӦֶΣʱ䰴IUpdate()Ĺȡǰʱ䡣
+	 */
+	index = this->m_InodeTable->IsLoaded(dev, inumber);
+	if ( index >= 0 )
+	{
+		pInode = &this->m_InodeTable->m_Inode[index];
+		pStat->d_mode = pInode->i_mode;
+		pStat->d_nlink = pInode->i_nlink;
+		pStat->d_uid = pInode->i_uid;
+		pStat->d_gid = pInode->i_gid;
+		pStat->d_size = pInode->i_size;
+		for ( int i = 0; i < 10; i++ )
+		{
+			pStat->d_addr[i] = pInode->i_addr[i];
+		}
+		if ( pInode->i_flag & Inode::IACC )
+		{
+			pStat->d_atime = Time::time;
+		}
+		if ( pInode->i_flag & Inode::IUPD )
+		{
+			pStat->d_mtime = Time::time;
+		}
+	}
+}
+
+void FileManager::Pipe()
+{
+	::Pipe* pPipe;
 	File* pFileRead;
 	File* pFileWrite;
 	int fd[2];
 	User& u = Kernel::Instance().GetUser();
 
-	/* һInodeڴܵļ */
-	pInode = this->m_FileSystem->IAlloc(DeviceManager::ROOTDEV);
-	if ( NULL == pInode )
+	/* һڴܵռø豸ϵInode */
+	pPipe = g_PipeTable.PAlloc();
+	if ( NULL == pPipe )
 	{
 		return;
 	}
@@ -396,7 +925,7 @@ void FileManager::Pipe()
 	pFileRead = this->m_OpenFileTable->FAlloc();
 	if ( NULL == pFileRead )
 	{
-		this->m_InodeTable->IPut(pInode);
+		g_PipeTable.PFree(pPipe);
 		return;
 	}
 	/* ܵĴļ */
@@ -408,7 +937,7 @@ void FileManager::Pipe()
 	{
 		pFileRead->f_count = 0;
 		u.u_ofiles.SetF(fd[0], NULL);
-		this->m_InodeTable->IPut(pInode);
+		g_PipeTable.PFree(pPipe);
 		return;
 	}
 
@@ -422,115 +951,338 @@ void FileManager::Pipe()
 
 	/* öдܵFileṹ ԺreadwriteϵͳҪʶ*/
 	pFileRead->f_flag = File::FREAD | File::FPIPE;
-	pFileRead->f_inode = pInode;
+	pFileRead->f_inode = NULL;
+	pFileRead->f_pipe = pPipe;
 	pFileWrite->f_flag = File::FWRITE | File::FPIPE;
-	pFileWrite->f_inode = pInode;
-
-	pInode->i_count = 2;
-	pInode->i_flag = Inode::IACC | Inode::IUPD;
-	pInode->i_mode = Inode::IALLOC;
+	pFileWrite->f_inode = NULL;
+	pFileWrite->f_pipe = pPipe;
 }
 
 void FileManager::ReadP(File *pFile)
 {
-	Inode* pInode = pFile->f_inode;
+	::Pipe* pPipe = pFile->f_pipe;
 	User& u = Kernel::Instance().GetUser();
 
 loop:
-	/* Թܵļ֤ ڵV6汾ͨļĶдҲȡַǳصʽ*/
-	pInode->Plock();
+	/* Թ֤ܵ */
+	pPipe->Lock();
 
-	/* ܵûݿɶȡ ܵļβʼдi_sizeдָ롣*/
-	if ( pFile->f_offset == pInode->i_size )
+	/* ܵûݿɶȡ */
+	if ( 0 == pPipe->Count() )
 	{
-		if ( pFile->f_offset != 0 )
-		{
-			/* ܵļƫ͹ܵļСΪ0 */
-			pFile->f_offset = 0;
-			pInode->i_size = 0;
+		pPipe->Unlock(); /* Ļдܵ޷Թܵʵʩϵͳ */
 
-			/* IWRITE־ʾнڵȴд˹ܵԱ뻽ӦĽ̡*/
-			if ( pInode->i_mode & Inode::IWRITE )
-			{
-				pInode->i_mode &= (~Inode::IWRITE);
-				Kernel::Instance().GetProcessManager().WakeUpAll((unsigned long)(pInode + 1));
-			}
+		/* ܵĶߡдѾһرգ򷵻 */
+		if ( pPipe->p_count < 2 )
+		{
+			return;
 		}
 
-		pInode->Prele(); /* Ļдܵ޷Թܵʵʩϵͳ */
-
-		/* ܵĶߡдѾһرգ򷵻 */
-		if ( pInode->i_count < 2 )
+		/* ʽȴд */
+		if ( pFile->f_flag & File::FNDELAY )
 		{
+			u.u_error = User::EAGAIN;
 			return;
 		}
 
-		/* IREAD־ʾн̵ȴPipe */
-		pInode->i_mode |= Inode::IREAD;
-		u.u_procp->Sleep((unsigned long)(pInode + 2), ProcessManager::PPIPE);
+		/* PREAD־ʾн̵ȴPipe */
+		pPipe->p_flag |= ::Pipe::PREAD;
+		u.u_procp->Sleep((unsigned long)&pPipe->p_head, ProcessManager::PPIPE);
 		goto loop;
 	}
 
-	/* ܵпɶȡ */
-	u.u_IOParam.m_Offset = pFile->f_offset;
-	pInode->ReadI();
-	pFile->f_offset = u.u_IOParam.m_Offset;
-	pInode->Prele();
+	/* ܵпɶȡݣָʱֱӸƵû */
+	while ( u.u_IOParam.m_Count > 0 && pPipe->Count() > 0 )
+	{
+		unsigned int offset = pPipe->p_tail & (::Pipe::PIPSIZ - 1);
+		unsigned int nbytes = Utility::Min(Utility::Min(u.u_IOParam.m_Count, pPipe->Count()), ::Pipe::PIPSIZ - offset);
+
+		Utility::IOMove(pPipe->p_buf + offset, u.u_IOParam.m_Base, nbytes);
+		u.u_IOParam.m_Base += nbytes;
+		u.u_IOParam.m_Count -= nbytes;
+		pPipe->p_tail += nbytes;
+	}
+	pPipe->Unlock();
+
+	/* ܵڳ˿ռ䣬дܵ */
+	if ( pPipe->p_flag & ::Pipe::PWRITE )
+	{
+		pPipe->p_flag &= (~::Pipe::PWRITE);
+		Kernel::Instance().GetProcessManager().WakeUpAll((unsigned long)&pPipe->p_tail);
+	}
+	FileManager::PollWakeUp();
 }
 
 void FileManager::WriteP(File* pFile)
 {
-	Inode* pInode = pFile->f_inode;
+	::Pipe* pPipe = pFile->f_pipe;
 	User& u = Kernel::Instance().GetUser();
-
 	int count = u.u_IOParam.m_Count;
 
 loop:
-	pInode->Plock();
+	pPipe->Lock();
 
 	/* дܵԹܵunlock */
-	if ( 0 == count )
+	if ( 0 == u.u_IOParam.m_Count )
 	{
-		pInode->Prele();
-		u.u_IOParam.m_Count = 0;
+		pPipe->Unlock();
 		return;
 	}
 
 	/* ߽ܵѹرնˡźSIGPIPE֪ͨӦó */
-	if ( pInode->i_count < 2 )
+	if ( pPipe->p_count < 2 )
 	{
-		pInode->Prele();
+		pPipe->Unlock();
 		u.u_error = User::EPIPE;
 		u.u_procp->PSignal(User::SIGPIPE);
 		return;
 	}
 
-	/* Ѿܵĵףͬ־˯ߵȴ */
-	if ( Inode::PIPSIZ == pInode->i_size )
+	/* ܵͬ־˯ߵȴ */
+	if ( ::Pipe::PIPSIZ == pPipe->Count() )
 	{
-		pInode->i_mode |= Inode::IWRITE;
-		pInode->Prele();
-		u.u_procp->Sleep((unsigned long)(pInode + 1), ProcessManager::PPIPE);
+		/* ʽд벿ʱдֽһֽҲûдʱ */
+		if ( pFile->f_flag & File::FNDELAY )
+		{
+			pPipe->Unlock();
+			if ( count == u.u_IOParam.m_Count )
+			{
+				u.u_error = User::EAGAIN;
+			}
+			return;
+		}
+
+		pPipe->p_flag |= ::Pipe::PWRITE;
+		pPipe->Unlock();
+		u.u_procp->Sleep((unsigned long)&pPipe->p_tail, ProcessManager::PPIPE);
 		goto loop;
 	}
 
-	/* дݾܶдܵ */
-	u.u_IOParam.m_Offset = pInode->i_size;
-	u.u_IOParam.m_Count = Utility::Min(count, Inode::PIPSIZ - u.u_IOParam.m_Offset);
-	count -= u.u_IOParam.m_Count;
-	pInode->WriteI();
-	pInode->Prele();
+	/* дݾֱܶӴûƵܵдָʱ */
+	while ( u.u_IOParam.m_Count > 0 && pPipe->Count() < ::Pipe::PIPSIZ )
+	{
+		unsigned int offset = pPipe->p_head & (::Pipe::PIPSIZ - 1);
+		unsigned int nbytes = Utility::Min(Utility::Min(u.u_IOParam.m_Count, ::Pipe::PIPSIZ - pPipe->Count()), ::Pipe::PIPSIZ - offset);
+
+		Utility::IOMove(u.u_IOParam.m_Base, pPipe->p_buf + offset, nbytes);
+		u.u_IOParam.m_Base += nbytes;
+		u.u_IOParam.m_Count -= nbytes;
+		pPipe->p_head += nbytes;
+	}
+	pPipe->Unlock();
 
 	/* Ѷܵ */
-	if ( pInode->i_mode & Inode::IREAD )
+	if ( pPipe->p_flag & ::Pipe::PREAD )
 	{
-		pInode->i_mode &= (~Inode::IREAD);
-		Kernel::Instance().GetProcessManager().WakeUpAll((unsigned long)(pInode + 2));
+		pPipe->p_flag &= (~::Pipe::PREAD);
+		Kernel::Instance().GetProcessManager().WakeUpAll((unsigned long)&pPipe->p_head);
 	}
+	FileManager::PollWakeUp();
 	goto loop;
 
 }
 
+unsigned int FileManager::m_PollEvents = 0;
+bool FileManager::m_PollWanted = false;
+
+void FileManager::Poll()
+{
+	User& u = Kernel::Instance().GetUser();
+	struct pollfd* fds = (struct pollfd *)u.u_arg[0];
+	int nfds = u.u_arg[1];
+	int timeout = u.u_arg[2];
+	Process* current = u.u_procp;
+	Timer* pTimer = &current->p_timer;
+	unsigned int events;
+	int n;
+
+	if ( nfds < 0 || nfds > OpenFiles::NOFILES )
+	{
+		u.u_error = User::EINVAL;
+		return;
+	}
+
+	/* ʱԺƣһʱжڵĲȡС0ʾһֱȴ0ʾȴ */
+	if ( timeout > 0 )
+	{
+		pTimer->t_func = FileManager::PollTimeout;
+		pTimer->t_arg = (unsigned long)current;
+		Time::AddTimer(pTimer, (timeout * Time::HZ + 999) / 1000);
+	}
+
+	while ( true )
+	{
+		events = FileManager::m_PollEvents;
+		n = 0;
+		for ( int i = 0; i < nfds; i++ )
+		{
+			int fd = fds[i].fd;
+			File* pFile;
+
+			fds[i].revents = 0;
+			if ( fd < 0 )
+			{
+				continue;
+			}
+			/* Чֻreventsб棬Ϊϵͳó */
+			if ( NULL == (pFile = u.u_ofiles.GetF(fd)) )
+			{
+				u.u_error = User::NOERROR;
+				fds[i].revents = FileManager::POLLNVAL;
+			}
+			else
+			{
+				fds[i].revents = this->PollFile(pFile, fds[i].events);
+			}
+			if ( 0 != fds[i].revents )
+			{
+				n++;
+			}
+		}
+		if ( n > 0 || 0 == timeout )
+		{
+			break;
+		}
+
+		/* жϺ鳬ʱɨڼ״̬仯ֱ˯ߣжеĻѲᶪʧ */
+		X86Assembly::CLI();
+		if ( timeout > 0 && (int)(pTimer->t_expire - Time::ticks) <= 0 )
+		{
+			X86Assembly::STI();
+			break;
+		}
+		if ( events != FileManager::m_PollEvents )
+		{
+			X86Assembly::STI();
+			continue;
+		}
+		FileManager::m_PollWanted = true;
+		current->Sleep((unsigned long)&FileManager::m_PollWanted, ProcessManager::PSLEP);
+	}
+
+	if ( timeout > 0 )
+	{
+		Time::DelTimer(pTimer);
+	}
+	u.u_ar0[User::EAX] = n;
+}
+
+void FileManager::Fcntl()
+{
+	File* pFile;
+	User& u = Kernel::Instance().GetUser();
+	int cmd = u.u_arg[1];
+	int arg = u.u_arg[2];
+
+	pFile = u.u_ofiles.GetF(u.u_arg[0]);
+	if ( NULL == pFile )
+	{
+		return;
+	}
+
+	switch ( cmd )
+	{
+	case FileManager::F_GETFL:
+		u.u_ar0[User::EAX] = pFile->f_flag & (File::FREAD | File::FWRITE | File::FNDELAY);
+		break;
+
+	case FileManager::F_SETFL:
+		/* дʽڴʱȷֻܸıFNDELAYdup()õͬһFileṹ֮ı */
+		pFile->f_flag = (pFile->f_flag & ~File::FNDELAY) | (arg & File::FNDELAY);
+		u.u_ar0[User::EAX] = 0;
+		break;
+
+	default:
+		u.u_error = User::EINVAL;
+		break;
+	}
+}
+
+TTy* FileManager::GetTTy(File* pFile)
+{
+	Inode* pInode = pFile->f_inode;
+
+	if ( (pFile->f_flag & File::FPIPE) || (pInode->i_mode & Inode::IFMT) != Inode::IFCHR )
+	{
+		return NULL;
+	}
+	return Kernel::Instance().GetDeviceManager().GetCharDevice(Utility::GetMajor(pInode->i_addr[0])).m_TTy;
+}
+
+int FileManager::PollFile(File* pFile, int events)
+{
+	int revents = 0;
+
+	if ( pFile->f_flag & File::FPIPE )
+	{
+		::Pipe* pPipe = pFile->f_pipe;
+
+		if ( pFile->f_flag & File::FREAD )
+		{
+			/* д˹رպܵ(ļ) */
+			if ( pPipe->p_count < 2 )
+			{
+				revents |= FileManager::POLLHUP | FileManager::POLLIN;
+			}
+			else if ( pPipe->Count() > 0 )
+			{
+				revents |= FileManager::POLLIN;
+			}
+		}
+		if ( pFile->f_flag & File::FWRITE )
+		{
+			if ( pPipe->p_count < 2 )
+			{
+				revents |= FileManager::POLLERR;
+			}
+			else if ( pPipe->Count() < ::Pipe::PIPSIZ )
+			{
+				revents |= FileManager::POLLOUT;
+			}
+		}
+		return revents & (events | FileManager::POLLHUP | FileManager::POLLERR);
+	}
+
+	TTy* pTTy = this->GetTTy(pFile);
+	if ( NULL != pTTy )
+	{
+		if ( pTTy->ReadReady() )
+		{
+			revents |= FileManager::POLLIN;
+		}
+		if ( pTTy->WriteReady() )
+		{
+			revents |= FileManager::POLLOUT;
+		}
+		return revents & events;
+	}
+
+	/* ͨļĿ¼Ϳ豸ĶдΪȴݶ˯ߣǾ */
+	return events & (FileManager::POLLIN | FileManager::POLLOUT);
+}
+
+void FileManager::PollWakeUp()
+{
+	FileManager::m_PollEvents++;
+
+	if ( FileManager::m_PollWanted )
+	{
+		FileManager::m_PollWanted = false;
+		Kernel::Instance().GetProcessManager().WakeUpAll((unsigned long)&FileManager::m_PollWanted);
+	}
+}
+
+void FileManager::PollTimeout(unsigned long arg)
+{
+	Process* pProcess = (Process*)arg;
+
+	/* ̿ļźŶ˯ */
+	if ( pProcess->IsSleepOn((unsigned long)&FileManager::m_PollWanted) )
+	{
+		pProcess->SetRun();
+	}
+}
+
 /* NULLʾĿ¼ʧܣǸָ룬ָļڴiڵ ڴiڵ  */
 Inode* FileManager::NameI( char (*func)(), enum DirectorySearchMode mode )
 {
@@ -862,6 +1614,19 @@ int FileManager::Access( Inode* pInode, unsigned int mode )
 			u.u_error = User::EROFS;
 			return 1;
 		}
+		/* 
+		 * еĿִļдʽ򿪻creat()ضϣĶҳ
+		 * ļ롣ֻûнʹõĶͷš
+		 */
+		if ( pInode->i_flag & Inode::ITEXT )
+		{
+			Kernel::Instance().GetProcessManager().XInvalidate(pInode);
+			if ( pInode->i_flag & Inode::ITEXT )
+			{
+				u.u_error = User::ETXTBSY;
+				return 1;
+			}
+		}
 	}
 	/* 
 	 * ڳûдκļ
@@ -1078,6 +1843,12 @@ void FileManager::UnLink()
 	pInode->i_nlink--;
 	pInode->i_flag |= Inode::IUPD;
 
+	/* ִļѱɾͷûнʹõĻĶμInodeãʹļ̿Ի */
+	if ( pInode->i_nlink <= 0 && (pInode->i_flag & Inode::ITEXT) )
+	{
+		Kernel::Instance().GetProcessManager().XInvalidate(pInode);
+	}
+
 	this->m_InodeTable->IPut(pDeleteInode);
 	this->m_InodeTable->IPut(pInode);
 }
@@ -2,6 +2,7 @@
 #include "Utility.h"
 #include "New.h"
 #include "Kernel.h"
+#include "KernelLog.h"
 #include "OpenFileManager.h"
 #include "TimeInterrupt.h"
 #include "Video.h"
@@ -261,7 +262,7 @@ Inode* FileSystem::IAlloc(short dev)
 		/* ڴûκοInodeNULL */
 		if(sb->s_ninode <= 0)
 		{
-			Diagnose::Write("No Space On %d !\n", dev);
+			KernelLog::Printf(KernelLog::LOG_WARNING, "No Space On %d !\n", dev);
 			u.u_error = User::ENOSPC;
 			return NULL;
 		}
@@ -363,7 +364,7 @@ Buf* FileSystem::Alloc(short dev)
 	if(0 == blkno )
 	{
 		sb->s_nfree = 0;
-		Diagnose::Write("No Space On %d !\n", dev);
+		KernelLog::Printf(KernelLog::LOG_WARNING, "No Space On %d !\n", dev);
 		u.u_error = User::ENOSPC;
 		return NULL;
 	}
@@ -149,6 +149,17 @@ void Inode::WriteI()
 	/* Inodeʱ־λ */
 	this->i_flag |= (Inode::IACC | Inode::IUPD);
 
+	/* ִļдϻеĶΣниļʱд */
+	if ( this->i_flag & Inode::ITEXT )
+	{
+		Kernel::Instance().GetProcessManager().XInvalidate(this);
+		if ( this->i_flag & Inode::ITEXT )
+		{
+			u.u_error = User::ETXTBSY;
+			return;
+		}
+	}
+
 	/* ַ豸ķ */
 	if( (this->i_mode & Inode::IFMT) == Inode::IFCHR )
 	{
@@ -549,6 +560,17 @@ void Inode::ITrunc()
 		return;
 	}
 
+	/* ִļضϣϻеĶΣниļʱض */
+	if ( this->i_flag & Inode::ITEXT )
+	{
+		Kernel::Instance().GetProcessManager().XInvalidate(this);
+		if ( this->i_flag & Inode::ITEXT )
+		{
+			Kernel::Instance().GetUser().u_error = User::ETXTBSY;
+			return;
+		}
+	}
+
 	/* FILOʽͷţԾʹSuperBlockм¼Ŀ̿
 	 * 
 	 * Unix V6++ļṹ(С͡ͺ;ļ)
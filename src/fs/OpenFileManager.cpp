@@ -2,6 +2,8 @@
 #include "Kernel.h"
 #include "TimeInterrupt.h"
 #include "Video.h"
+#include "Pipe.h"
+#include "KernelLog.h"
 
 /*==============================class OpenFileTable===================================*/
 /* ϵͳȫִļʵĶ */
@@ -46,23 +48,23 @@ File* OpenFileTable::FAlloc()
 		}
 	}
 
-	Diagnose::Write("No Free File Struct\n");
+	KernelLog::Printf(KernelLog::LOG_WARNING, "No Free File Struct\n");
 	u.u_error = User::ENFILE;
 	return NULL;
 }
 
 void OpenFileTable::CloseF(File *pFile)
 {
-	Inode* pNode;
-	ProcessManager& procMgr = Kernel::Instance().GetProcessManager();
-
-	/* ܵ */
+	/* ܵͣһøö˵Ľ̹رʱرչܵһ */
 	if(pFile->f_flag & File::FPIPE)
 	{
-		pNode = pFile->f_inode;
-		pNode->i_mode &= ~(Inode::IREAD | Inode::IWRITE);
-		procMgr.WakeUpAll((unsigned long)(pNode + 1));
-		procMgr.WakeUpAll((unsigned long)(pNode + 2));
+		if(pFile->f_count <= 1)
+		{
+			g_PipeTable.PClose(pFile->f_pipe);
+			pFile->f_pipe = NULL;
+		}
+		pFile->f_count--;
+		return;
 	}
 
 	if(pFile->f_count <= 1)
@@ -156,7 +158,7 @@ Inode* InodeTable::IGet(short dev, int inumber)
 			/* ڴInodeInodeʧ */
 			if(NULL == pInode)
 			{
-				Diagnose::Write("Inode Table Overflow !\n");
+				KernelLog::Printf(KernelLog::LOG_WARNING, "Inode Table Overflow !\n");
 				u.u_error = User::ENFILE;
 				return NULL;
 			}
@@ -0,0 +1,117 @@
+#include "Pipe.h"
+#include "Kernel.h"
+#include "Machine.h"
+#include "Utility.h"
+#include "KernelLog.h"
+
+/*==============================class Pipe===================================*/
+Pipe::Pipe()
+{
+	this->p_buf = NULL;
+	this->p_head = 0;
+	this->p_tail = 0;
+	this->p_count = 0;
+	this->p_flag = 0;
+}
+
+Pipe::~Pipe()
+{
+	//nothing to do here
+}
+
+void Pipe::Lock()
+{
+	User& u = Kernel::Instance().GetUser();
+
+	while ( this->p_flag & Pipe::PLOCK )
+	{
+		this->p_flag |= Pipe::PWANT;
+		u.u_procp->Sleep((unsigned long)this, ProcessManager::PPIPE);
+	}
+	this->p_flag |= Pipe::PLOCK;
+}
+
+void Pipe::Unlock()
+{
+	this->p_flag &= ~Pipe::PLOCK;
+
+	if ( this->p_flag & Pipe::PWANT )
+	{
+		this->p_flag &= ~Pipe::PWANT;
+		Kernel::Instance().GetProcessManager().WakeUpAll((unsigned long)this);
+	}
+}
+
+unsigned int Pipe::Count()
+{
+	return this->p_head - this->p_tail;
+}
+
+/*==============================class PipeTable===================================*/
+/* ϵͳȫֹܵʵĶ */
+PipeTable g_PipeTable;
+
+PipeTable::PipeTable()
+{
+	//nothing to do here
+}
+
+PipeTable::~PipeTable()
+{
+	//nothing to do here
+}
+
+Pipe* PipeTable::PAlloc()
+{
+	User& u = Kernel::Instance().GetUser();
+
+	for ( int i = 0; i < PipeTable::NPIPE; i++ )
+	{
+		Pipe* pPipe = &this->m_Pipe[i];
+
+		/* p_count==0ʾ */
+		if ( 0 == pPipe->p_count )
+		{
+			unsigned long address = Kernel::Instance().GetKernelPageManager().AllocMemory(Pipe::PIPSIZ);
+			if ( 0 == address )
+			{
+				u.u_error = User::ENOMEM;
+				return NULL;
+			}
+			pPipe->p_buf = (unsigned char *)(address + Machine::KERNEL_SPACE_START_ADDRESS);
+			pPipe->p_head = 0;
+			pPipe->p_tail = 0;
+			pPipe->p_count = 2;
+			pPipe->p_flag = 0;
+			return pPipe;
+		}
+	}
+
+	KernelLog::Printf(KernelLog::LOG_WARNING, "No Free Pipe\n");
+	u.u_error = User::ENFILE;
+	return NULL;
+}
+
+void PipeTable::PClose(Pipe* pPipe)
+{
+	ProcessManager& procMgr = Kernel::Instance().GetProcessManager();
+
+	/* һ˵Ķߡд߷p_count < 2󷵻أ˯ */
+	pPipe->p_flag &= ~(Pipe::PREAD | Pipe::PWRITE);
+	procMgr.WakeUpAll((unsigned long)&pPipe->p_head);
+	procMgr.WakeUpAll((unsigned long)&pPipe->p_tail);
+	FileManager::PollWakeUp();
+
+	if ( --pPipe->p_count <= 0 )
+	{
+		this->PFree(pPipe);
+	}
+}
+
+void PipeTable::PFree(Pipe* pPipe)
+{
+	Kernel::Instance().GetKernelPageManager().FreeMemory(Pipe::PIPSIZ, (unsigned long)pPipe->p_buf - Machine::KERNEL_SPACE_START_ADDRESS);
+	pPipe->p_buf = NULL;
+	pPipe->p_count = 0;
+	pPipe->p_flag = 0;
+}
@@ -2,6 +2,7 @@
 #define ATA_DRIVE_H
 
 #include "Regs.h"
+#include "TimerWheel.h"
 
 class ATADriver
 {
@@ -12,6 +13,9 @@ public:
 	/* ô̼Ĵ̽I/O */
 	static void DevStart(struct Buf* bp);
 
+	/* I/OTime::DISK_TIMEOUTδյжϣ */
+	static void Timeout(unsigned long arg);
+
 private:
 	/* ǷֵʾſԷ */
 	static int IsControllerReady();
@@ -25,6 +29,10 @@ private:
 	//  */
 	// static int ReadyToTransfer();
 
+	/* static member */
+public:
+	static Timer m_Watchdog;	/* ȴжϵĳʱʱ */
+
 	/* static const member */
 public:
 	/* ̼ĴI/O˿ڵַ */
@@ -9,7 +9,11 @@
  * ָɿ/жϡgdtidt
 */
 
-/* ˢҳÿζҳ޸ĺҪã»ҳ */
+/* 
+ * ϵͳʼҳĿ¼ˢҳ档̬ҳ汻ΪȫҳCR3¼ʱϣ
+ * ޸ĺ̬ҳʹX86Assembly::INVLPG()ֻ޸û̬ҳʱҲӦˡ
+ * ӵ˽ҳĿ¼лַռʹX86Assembly::LoadCR3()
+ */
 #define FlushPageDirectory()	\
 	__asm__ __volatile__(" movl %0, %%cr3" : : "r"(0x200000) );
 
@@ -42,6 +46,62 @@ class X86Assembly
 			__asm__ __volatile__("lgdt %0"::"m" (*gdtr));
 		}
 
+		//invlpgָֻaddressҳTLB(ȫҳ)ԶС¼CR3
+		static inline void INVLPG(unsigned long address)
+		{
+			__asm__ __volatile__("invlpg (%0)" : : "r"(address) : "memory");
+		}
+
+		//EFLAGSжϣRestoreFlags()ʹãѾжϵĴжǰж
+		static inline unsigned long SaveFlagsCLI()
+		{
+			unsigned long flags;
+			__asm__ __volatile__("pushfl; popl %0; cli" : "=r"(flags) : : "memory");
+			return flags;
+		}
+
+		//ָSaveFlagsCLI()EFLAGSжλָ֮
+		static inline void RestoreFlags(unsigned long flags)
+		{
+			__asm__ __volatile__("pushl %0; popfl" : : "r"(flags) : "memory", "cc");
+		}
+
+		//bsfָvalue͵Ϊ1λţvalueΪ0
+		static inline int BSF(unsigned int value)
+		{
+			int index;
+			__asm__ __volatile__("bsfl %1, %0" : "=r"(index) : "rm"(value));
+			return index;
+		}
+
+		//ȡCR3ǰҳĿ¼ַ
+		static inline unsigned long GetCR3()
+		{
+			unsigned long cr3;
+			__asm__ __volatile__("movl %%cr3, %0" : "=r"(cr3));
+			return cr3;
+		}
+
+		//CR3лַΪpageDirPhyAddressҳĿ¼ȫҳTLBȫ
+		static inline void LoadCR3(unsigned long pageDirPhyAddress)
+		{
+			__asm__ __volatile__("movl %0, %%cr3" : : "r"(pageDirPhyAddress) : "memory");
+		}
+
+		//rdtscָȡʱ
+		static inline unsigned long long RDTSC()
+		{
+			unsigned long long tsc;
+			__asm__ __volatile__("rdtsc" : "=A"(tsc));
+			return tsc;
+		}
+
+		//wrmsrָvalueдΪmsrģؼĴ
+		static inline void WRMSR(unsigned int msr, unsigned long long value)
+		{
+			__asm__ __volatile__("wrmsr" : : "c"(msr), "A"(value));
+		}
+
 		//ltrָ
 		static inline void LTR(unsigned short tssSelector)
 		{
@@ -26,6 +26,7 @@ public:
 	Buf* Breada(short adev, int blkno, int rablkno);	/* һ̿飬Ԥʽ
 														 * adevΪ豸šblknoΪĿ̿߼ţͬʽblkno
 														 * rablknoΪԤ̿߼ţ첽ʽrablkno */
+	void Prefetch(short adev, int blkno);	/* 첽ַblknoȴI/Oڻκβ */
 	void Bwrite(Buf* bp);				/* дһ̿ */
 	void Bdwrite(Buf* bp);				/* ӳд̿ */
 	void Bawrite(Buf* bp);				/* 첽д̿ */
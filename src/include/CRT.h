@@ -55,6 +55,22 @@ public:
 	/* ˢ����ʾ - ����ʷ���������ݵ���Ļ */
 	static void RefreshScreen();
 
+	/* 把一批输出中改动过的行复制到显存，并移动一次硬件光标 */
+	static void Flush();
+
+private:
+	/* 历史缓冲区清为空白，共ROWS行 */
+	static void InitHistory();
+
+	/* 历史中第line行(从最早保留的一行算起)在环形缓冲区中的起始地址 */
+	static unsigned short* HistoryLine(unsigned int line);
+
+	/* 记录第line行已改动，等待Flush()复制到显存 */
+	static void MarkDirty(unsigned int line);
+
+	/* 把历史中第line行复制到屏幕第row行 */
+	static void CopyLine(unsigned int line, unsigned int row);
+
 	/* Members */
 public:
 	static unsigned short* m_VideoMemory;
@@ -73,6 +89,10 @@ public:
 	static unsigned int m_TotalLines;				/* ��ǰ�ܹ������ж��ٻ� */
 	static unsigned int m_ViewStartLine;			/* ��ǰ��ͼ���ڵ���ʼ�к� */
 	static bool m_AutoScroll;						/* �Ƿ��Զ������������ */
+	static unsigned int m_HeadLine;					/* 历史中最早一行在环形缓冲区中的行号，滚动时只移动它 */
+	static unsigned int m_DirtyFirst;				/* 本批输出改动过的行[m_DirtyFirst, m_DirtyEnd) */
+	static unsigned int m_DirtyEnd;
+	static bool m_FullRefresh;						/* 视图窗口已移动，需要整屏刷新 */
 };
 
 #endif
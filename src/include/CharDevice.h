@@ -16,7 +16,8 @@ public:
 	virtual void Close(short dev, int mode);
 	virtual void Read(short dev);
 	virtual void Write(short dev);
-	virtual void SgTTy(short dev, TTy* pTTy);
+	/* sttygttyflags >= 0ʱն˹ʽԭȵĹʽ */
+	virtual int SgTTy(short dev, int flags);
 
 public:
 	TTy* m_TTy;		/* ַָ豸TTyṹָ */
@@ -36,7 +37,25 @@ public:
 	void Close(short dev, int mode);
 	void Read(short dev);
 	void Write(short dev);
-	void SgTTy(short dev, TTy* pTTy);
+	int SgTTy(short dev, int flags);
+};
+
+
+/*
+ * COM1ַ豸豸1дSerial::m_TTyй
+ * COM1̨ʱConsoleDeviceg_TTy
+ */
+class SerialDevice : public CharDevice
+{
+public:
+	SerialDevice();
+	virtual ~SerialDevice();
+
+	void Open(short dev, int mode);
+	void Close(short dev, int mode);
+	void Read(short dev);
+	void Write(short dev);
+	int SgTTy(short dev, int flags);
 };
 
 #endif
@@ -4,7 +4,8 @@
 /*
  * 8253ɱ̶ʱоƬ(PIT)Ĳ
  *
- * 8253оƬڲ̶ʱжϡ
+ * 8253оƬڲ̶ʱжϣϵͳʱҲɸΪμ
+ * һʱʱŲʱжϡ
  */
 class Chip8253
 {
@@ -12,13 +13,33 @@ public:
 	/* 8253ʱоƬгʼĬÿ60ʱж */
 	static void Init(int ticks = 60); 
 
+	/* 0Ϊʽ0μcountʱںһʱж */
+	static void OneShot(unsigned int count);
+
+	/* 沢0ĵǰֵ */
+	static unsigned int ReadCount();
+
+	/* Լ(ʽ3)ʱھһʱжʣʱlatchΪһڵļֵ */
+	static unsigned int Remaining(unsigned int latch);
+
+	/* μǷѾ0ѱΪߵƽʹ8254Ļض */
+	static bool IsCountDone();
+
+public:
+	static const unsigned int INPUT_FREQ = 1193180;		/* оƬƵΪ1.193180MHz */
+	static const unsigned int MAX_COUNT = 0xFFFF;		/* 16ؼֵ */
+
 private:
 	/* һЩڶ˿ڵֵַͼֵĳ */
-	static const unsigned int INPUT_FREQ = 1193180;		/* оƬƵΪ1.193180MHz */
 	static const unsigned short CNT0_PORT = 0x40;		/* 0Ķ˿ڵַ40H */
 	static const unsigned short CTRLWRD_PORT = 0x43;	/* ֶ˿ڵַ43H */
 	static const unsigned char CTRLCMD_SEL0 = 0x00;		/* ѡ0 */
 	static const unsigned char CTRLCMD_MODE3 = 0x06;	/* ģʽ: ̶ѭķ,Ϊʱж */	
+	static const unsigned char CTRLCMD_MODE0 = 0x00;	/* ģʽ: 0ʱߣֻһʱж */
+	static const unsigned char CTRLCMD_LATCH = 0x00;	/* ֵ */
+	static const unsigned char CTRLCMD_READBACK = 0xE2;	/* 8254ض: ֻ0״̬ */
+	static const unsigned char CTRLCMD_READBACK_ALL = 0xC2;	/* 8254ض: 0״ֺ̬ͼֵ */
+	static const unsigned char STATUS_OUT = 0x80;		/* ״̬еŵƽ */
 	static const unsigned char CTRLCMD_RW = 0x30;		/* ֵдģʽ: д,16,ȵֽ,ֽ */
 };
 
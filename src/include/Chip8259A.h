@@ -54,6 +54,7 @@ public:
 	static const unsigned int IRQ_TIMER = 0;	/* ʱ���ж�(IRQ0)���͵�IR0���� */
 	static const unsigned int IRQ_KBD	= 1;	/* �����ж�(IRQ1)���͵�IR1���� */
 	static const unsigned int IRQ_SLAVE = 2;	/* ����ģʽ��,��Ƭ�������ж�(Slave��INT����),���͵���Ƭ��IR2 */
+	static const unsigned int IRQ_COM1	= 4;	/* 串口COM1中断(IRQ4)连接到主片IR4引脚 */
 
 	/* ��Ƭ(IR0~IR7)���ӵ��������Ӧ���ж���������,����ֻ�õ���������Ӳ�� */
 	static const unsigned int IRQ_MOUSE	= 12;	/* 鼠标中断(IRQ12)连接到从片IR4引脚 */
@@ -13,6 +13,7 @@ public:
 
 	static const short ROOTDEV = (0 << 8) | 0;	/* ̵豸ŶΪ0 */
 	static const short TTYDEV = (0 << 8) | 0;	/* TTYնַ豸豸ŶΪ0 */
+	static const short SERIALDEV = (1 << 8) | 0;	/* COM1ַ豸豸1豸0 */
 
 public:
 	DeviceManager();
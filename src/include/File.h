@@ -2,6 +2,7 @@
 #define FILE_H
 
 #include "INode.h"
+#include "Pipe.h"
 
 /*
  * ļƿFileࡣ
@@ -16,7 +17,9 @@ public:
 	{
 		FREAD = 0x1,			/*  */
 		FWRITE = 0x2,			/* д */
-		FPIPE = 0x4				/* ܵ */
+		FPIPE = 0x4,			/* ܵ */
+		FNDELAY = 0x800			/* ʽܵնݿɶ޿ռдʱ˯ߡ
+								 * ȡλΪٳ0777ȨֵΪopen()mode */
 	};
 	
 	/* Functions */
@@ -30,7 +33,8 @@ public:
 	/* Member */
 	unsigned int f_flag;		/* ԴļĶдҪ */
 	int		f_count;			/* ǰøļƿĽ */
-	Inode*	f_inode;			/* ָļڴInodeָ */
+	Inode*	f_inode;			/* ָļڴInodeָ룬ܵΪNULL */
+	Pipe*	f_pipe;				/* ܵʱָڴܵ */
 	int		f_offset;			/* ļдλָ */
 };
 
@@ -5,6 +5,23 @@
 #include "OpenFileManager.h"
 #include "File.h"
 
+class DirectoryEntry;
+
+/* poll()ϵͳõĲûеĶһ */
+struct pollfd
+{
+	int fd;				/* ļС0 */
+	short events;		/* ȴ */
+	short revents;		/* ʱ */
+};
+
+/* readv()writev()ϵͳõĲûеĶһ */
+struct iovec
+{
+	unsigned char* iov_base;	/* һû׵ַ */
+	int iov_len;				/* öεֽ */
+};
+
 /* 
  * ļ(FileManager)
  * װļϵͳĸϵͳں̬´̣
@@ -22,6 +39,21 @@ public:
 		DELETE = 2		/* ɾļʽĿ¼ */
 	};
 
+	static const int IOV_MAX = 16;		/* readv()writev()һĻ */
+	static const int SENDFILE_RA = 4;	/* sendfile()ڵǰ֮󱣳첽Դļ */
+	static const int GETDENTS_RA = 8;	/* getdents()statʱһԤInode */
+
+	/* fcntl() */
+	static const int F_GETFL = 3;		/* شļĶдʽFNDELAY */
+	static const int F_SETFL = 4;		/* FNDELAY־ */
+
+	/* poll() */
+	static const int POLLIN = 0x1;		/* ݿɶļ */
+	static const int POLLOUT = 0x4;		/* д */
+	static const int POLLERR = 0x8;		/* ܵѹر */
+	static const int POLLHUP = 0x10;	/* ܵдѹر */
+	static const int POLLNVAL = 0x20;	/* ļЧ */
+
 	/* Functions */
 public:
 	/* Constructors */
@@ -93,6 +125,39 @@ public:
 	 */
 	void Rdwr(enum File::FileFlags mode);
 
+	/* 
+	 * @comment Pread()Pwrite()ϵͳộָƫдƶf_offset
+	 */
+	void Pread();
+	void Pwrite();
+	void PRdwr(enum File::FileFlags mode);
+
+	/* 
+	 * @comment Readv()Writev()ϵͳộһζдû
+	 */
+	void Readv();
+	void Writev();
+	void Rdwrv(enum File::FileFlags mode);
+
+	/* 
+	 * @comment SendFile()ϵͳộںڰԴļݾֱдĿļ
+	 */
+	void SendFile();
+
+	/* 
+	 * @comment GetDents()ϵͳộһηĿ¼ļеĶЧĿ¼
+	 * plusΪ0ʱÿļInodestat()Ľ
+	 */
+	void GetDents();
+	/* 
+	 * @comment ŴС첽ents[0 ~ n-1]Inode
+	 */
+	void PrefetchInodes(short dev, DirectoryEntry* ents, int n);
+	/* 
+	 * @comment ȡ豸devϱΪinumberInodestat()ڴInodeʱڴеΪ׼
+	 */
+	void StatI(short dev, int inumber, DiskInode* pStat);
+
 	/* 
 	 * @comment Pipe()ܵϵͳô
 	 */
@@ -107,6 +172,30 @@ public:
 	 * @comment ܵд
 	 */
 	void WriteP(File* pFile);
+	/* 
+	 * @comment Fcntl()ϵͳộȡôļı־
+	 */
+	void Fcntl();
+	/* 
+	 * @comment ַ豸ļӦTTyṹļNULL
+	 */
+	TTy* GetTTy(File* pFile);
+	/* 
+	 * @comment Poll()ϵͳộȴļκһʱ
+	 */
+	void Poll();
+	/* 
+	 * @comment ļpFileǰeventsеЩ
+	 */
+	int PollFile(File* pFile, int events);
+	/* 
+	 * @comment ܵն˵״̬仯ʱãPoll()˯ߵĽ̡жϴе
+	 */
+	static void PollWakeUp();
+	/* 
+	 * @comment Poll()ʱʱĵڴ
+	 */
+	static void PollTimeout(unsigned long arg);
 	
 	/* 
 	 * @comment Ŀ¼·תΪӦInode
@@ -174,6 +263,13 @@ public:
 
 	/* ȫֶg_OpenFileTableãöļĹ */
 	OpenFileTable* m_OpenFileTable;
+
+	/* 
+	 * Poll()˯ߵĽ̶m_PollWantedĵַΪ˯ԭ򡣽ɨļǰ
+	 * m_PollEvents˯ǰжϱȽϣɨڼ䷢״̬仯ᶪʧ
+	 */
+	static unsigned int m_PollEvents;	/* PollWakeUp()ĵô */
+	static bool m_PollWanted;			/* нPoll()˯ */
 };
 
 
@@ -196,4 +292,11 @@ public:
 	char m_name[DIRSIZ];	/* Ŀ¼· */
 };
 
+/* getdents()statʱصĿ¼ûеĶһ */
+struct direntplus
+{
+	DirectoryEntry d_ent;	/* Ŀ¼ */
+	DiskInode d_stat;		/* Ŀ¼ӦļInode */
+};
+
 #endif
@@ -49,8 +49,6 @@ public:
 	static const int LARGE_FILE_BLOCK = 128 * 2 + 6;	/* ļһμѰַ߼ */
 	static const int HUGE_FILE_BLOCK = 128 * 128 * 2 + 128 * 2 + 6;	/* ļμѰַļ߼ */
 
-	static const int PIPSIZ = SMALL_FILE_BLOCK * BLOCK_SIZE;
-
 	/* static member */
 	static int rablock;		/* ˳ʱʹԤļһַ飬rablock¼һ߼
 							bmapתõ̿šrablockΪ̬ԭ򣺵һbmapĿ
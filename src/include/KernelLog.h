@@ -0,0 +1,61 @@
+#ifndef KERNEL_LOG_H
+#define KERNEL_LOG_H
+
+/*
+ * ں־Printf()ѴʱϢʽд뿪ʱӺҳĻ
+ * 󸲸Ϣklog()ϵͳ(ûdmesg)ȡ
+ * дֻڸϢʱݹжϣ˯ߣҲȴĻֻм𲻵
+ * ConsoleLevelϢͬʱDiagnose::Write()ԵĻ˽execexit
+ * ·ϵĵϢϵͳá
+ * λÿϢΪ"<>[.] \n"
+ */
+class KernelLog
+{
+	/* static consts */
+public:
+	/* ϢֵԽСԽ */
+	static const int LOG_EMERG = 0;		/* ϵͳ */
+	static const int LOG_ALERT = 1;		/*  */
+	static const int LOG_CRIT = 2;		/* ش */
+	static const int LOG_ERR = 3;		/*  */
+	static const int LOG_WARNING = 4;	/* 棬ϵͳ */
+	static const int LOG_NOTICE = 5;	/* ֵע */
+	static const int LOG_INFO = 6;		/* һϢ */
+	static const int LOG_DEBUG = 7;		/* ϢexecexitĹ */
+
+	static const int DEFAULT_CONSOLE_LEVEL = LOG_WARNING;	/* ʱԵĻͽ̶ */
+
+	/* klog() */
+	static const int KLOG_READ = 1;		/* ȡߣlenֽϢbufظƵֽ */
+	static const int KLOG_CLEAR = 2;	/* ջ޳û */
+	static const int KLOG_CONSOLE = 3;	/* ConsoleLevelΪlenԭȵֵ޳û */
+	static const int KLOG_SIZE = 4;		/* ػδֽ */
+
+	static const unsigned int LOG_SIZE = 0x4000;	/* λֽΪ2 */
+	static const int LINE_SIZE = 160;				/* Ϣ󳤶ȣֱض */
+
+	/* Functions */
+public:
+	/* Ӻҳ价λǰϢֻԣд뻺 */
+	static void Initialize();
+
+	/* дһϢжϴеáʽֻ֧%d%u%x%c%s%% */
+	static void Printf(int level, const char* fmt, ...);
+
+	/* klog()ϵͳ */
+	static int Control(int cmd, char* buf, int len);
+
+private:
+	static int Format(char* buf, int size, const char* fmt, unsigned int* va_arg);
+
+	/* Members */
+public:
+	static int ConsoleLevel;		/* 𲻴ڸֵϢԵĻ */
+
+private:
+	static char* ring;
+	static unsigned int head;		/* ۼдֽģLOG_SIZEΪдλ */
+	static unsigned int start;		/* һʱhead */
+};
+
+#endif
@@ -35,6 +35,11 @@ public:
 	/* ں˿ռС 4M 0xC0000000 - 0xC0400000 1 PageTable */
 	static const unsigned int KERNEL_SPACE_SIZE = 0x400000;
 	static const unsigned long KERNEL_SPACE_START_ADDRESS	= 0xC0000000;
+
+	/* SYSENTER/SYSEXITʹõģؼĴ */
+	static const unsigned int IA32_SYSENTER_CS = 0x174;
+	static const unsigned int IA32_SYSENTER_ESP = 0x175;
+	static const unsigned int IA32_SYSENTER_EIP = 0x176;
 	
 public:
 	static Machine& Instance();			/* ص̬instance */
@@ -48,14 +53,15 @@ public:
 	void InitUserPageTable();
 	void InitTaskStateSegment();
 	void EnablePageProtection();
+	void InitFastSystemCall();			/* CPU֧SYSENTERʱMSRûɾ˽ϵͳ */
 	
 	/* property functions */
 	IDT& GetIDT();						/* ȡǰʹõIDT */
 	GDT& GetGDT();						/* ȡǰʹõGDT */
-	PageDirectory& GetPageDirectory();	/* ȡǰʹõҳĿ¼ */
+	PageDirectory& GetPageDirectory();	/* ȡϵͳҳĿ¼˽ҳĿ¼ĺ̬ɴ˸ */
 	PageTable& GetKernelPageTable();	/* ȡϵͳںʹõҳmap 0xc0000000ϵַ */
-	PageTable* GetUserPageTableArray();	/* ȡûҳţӳ0x2020000x203000ϣ
-										    ӳ0x00000000 - 0x00800000ûַ̬ռ */
+	PageTable* GetUserPageTableArray();	/* ȡϵͳû̬ҳţӳ0x2020000x203000ϣ
+										    ӳ0x00000000 - 0x00800000ûַ̬ռ䣻˽ҳ */
 	TaskStateSegment& GetTaskStateSegment();
 	
 private:
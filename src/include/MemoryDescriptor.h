@@ -2,6 +2,9 @@
 #define MEMORY_DESCRIPTOR_H
 
 #include "PageTable.h"
+#include "PageDirectory.h"
+
+class Text;
 
 class MemoryDescriptor
 {
@@ -11,6 +14,16 @@ public:
 	static const unsigned int USER_SPACE_PAGE_TABLE_CNT = 0x2;
 	static const unsigned long USER_SPACE_START_ADDRESS		= 0x0;
 
+	/* 
+	 * ԵַӳձУĶҳ¼ڹĶʼҳţݶΡջҳ
+	 * Ϊ˽Уҳ䣬ҳֱӼ¼ҳšm_ForSystemUserֶɲϵͳı־λ
+	 * PG_DEMAND ҳδװ룬Ҳδҳ״ηʱȱҳ쳣ӿִļ0
+	 * PG_SWAP   ҳѱm_PageBaseAddressΪ任λñ(ڴ潻ػ̽̿)
+	 * PG_BUSY   ҳûػڻҳ档
+	 */
+	static const unsigned char PG_DEMAND = 0x1;
+	static const unsigned char PG_SWAP = 0x2;
+	static const unsigned char PG_BUSY = 0x4;
 
 
 public:
@@ -18,20 +31,39 @@ public:
 	~MemoryDescriptor();
 
 public:
-	/* 벢ʼPageDirectoryMapǰʹ */
-	void Initialize();
+	/* 
+	 * 벢ʼԵַӳձԼ˽еҳĿ¼û̬ҳMapǰʹá
+	 * ҳĿ¼к̬ϵͳҳĿ¼ͬͬһź̬ҳ
+	 * ڴ治ʱκڴ棬false
+	 */
+	bool Initialize();
 	/* ͷŽʱҪøòͷűռõҳ */
 	void Release();
 
+	/* ˽ҳĿ¼֮û̬ҳҳĿ¼ַû̬ҳַ */
+	static inline PageTable* GetPageTables(PageDirectory* pPageDirectory)
+	{
+		return (PageTable*)(pPageDirectory + 1);
+	}
+
 	/* ºûɶuserṹҳEntry䣬ҳڽлʱеҳ */
 	void MapTextEntrys(unsigned long textStartAddress, unsigned long textSize, unsigned long textPageIdxInPhyMemory);
 	void MapDataEntrys(unsigned long dataStartAddress, unsigned long dataSize, unsigned long dataPageIdxInPhyMemory);
 	void MapStackEntrys(unsigned long stackSize, unsigned long stackPageIdxInPhyMemory);
 
+	/* 
+	 * ȱҳ쳣дװҳ棺Ķҳӿִļ빲ĶΣ
+	 * ݶΡջҳӿִļ롢0ߴӽ롣
+	 * addressǰװҳʱfalse
+	 */
+	bool DemandPage(unsigned long address);
+
 	/* @comment ԭunixv6sureg().ԭڽuеuisauisdеڴҳӳӳ䵽UISAUISD
-	 * Ĵ.ϵṹĹϵʹMapToPageTable()MemoryDescriptorеҳcopyϵͳʹõ
-	 * PageTableУȻʹFlushPageDirectory()ҳӳ䣬̵̨ûӳ */
-	void MapToPageTable();
+	 * Ĵ.ϵṹĹϵʹMapToPageTable()ԵַӳձĶpTextλã
+	 * ؽ˽еû̬ҳֻexecfork͸ıͼСʱãлʱؽҳ */
+	void MapToPageTable(Text* pText);
+	/* ̨ʱ˽ҳĿ¼CR3ûûַ̬ռĽʹϵͳҳĿ¼ */
+	void LoadPageDirectory();
 	void DisplayPageTable();
 
 	/* 
@@ -39,6 +71,7 @@ public:
 	 * MapToPageTable()Եַӳصû̬ҳС
 	 */
 	bool EstablishUserPageTable(unsigned long textVirtualAddress, unsigned long textSize, unsigned long dataVirtualAddress, unsigned long dataSize, unsigned long stackSize);
+	/* ͷȫ˽ҳռõҳͽռ䣬Եַӳձ */
 	void ClearUserPageTable();
 	PageTable* GetUserPageTableArray();
 	unsigned long GetTextStartAddress();
@@ -56,9 +89,14 @@ private:
 	 * bool isReadWrite:				ҳԣtrueΪɶдҳ
 	 */
 	unsigned int MemoryDescriptor::MapEntry(unsigned long virtualAddress, unsigned int size, unsigned long phyPageIdx, bool isReadWrite);
+	/* ΪݶΡջν˽ҳҳҳ汣ֲ䣬ҳΪPG_DEMAND */
+	void MapPrivateEntrys(unsigned long virtualAddress, unsigned int size);
+	/* ͷһ˽ҳռõҳ򽻻ռ */
+	void ReleaseEntry(PageTableEntry* entry);
 	
 public:
 	PageTable*		m_UserPageTableArray;
+	PageDirectory*	m_PageDirectory;	/* ˽ҳĿ¼(ַ̬)û̬ҳ */
 	/* ݶԵַ */
 	unsigned long	m_TextStartAddress;	/* ʼַ */
 	unsigned long	m_TextSize;			/* γ */
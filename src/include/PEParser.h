@@ -4,6 +4,7 @@
 #define IMAGE_NUMBEROF_DIRECTORY_ENTRIES    16
 
 #include "INode.h"
+#include "Text.h"
 
 struct ImageDosHeader 
 {												  // DOS .EXE header
@@ -135,7 +136,14 @@ public:
 	 * exesectionϢͬʱҪmapҳʧ
 	 */
 	unsigned int Relocate();
-	unsigned int Relocate(Inode* p_inode, int sharedText);
+
+	/*
+	 *@comment װ뷽ʽexecٽsectionڴ棬ֻ.text.data.rdata
+	 * ڿִļеλü¼·TextṹУҳ״ηʱȱҳ쳣
+	 * ļ룬.bss0̹Ķʱ(sharedText == 1)м¼
+	 * 谴װֽ
+	 */
+	unsigned int DemandLoad(Text* pText, int sharedText);
 
     bool HeaderLoad(Inode* p_inode);
 
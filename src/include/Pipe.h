@@ -0,0 +1,94 @@
+#ifndef PIPE_H
+#define PIPE_H
+
+/*
+ * ڴܵPipeࡣ
+ * ܵеݴڴӺҳĻλУдʱû뻷λ
+ * ֱ֮Ӹƣռø豸ϵInode̿飬Ҳʹ̡
+ * д˵Fileṹf_pipeָͬһPipef_inodeΪNULL
+ */
+class Pipe
+{
+public:
+	/* Enumerate */
+	enum PipeFlag
+	{
+		PLOCK = 0x1,		/* ܵ */
+		PWANT = 0x2,		/* н̵ȴܵ */
+		PREAD = 0x4,		/* н̵ȴܵ˯ԭΪ&p_head */
+		PWRITE = 0x8		/* н̵ȴдܵ˯ԭΪ&p_tail */
+	};
+
+	/* static consts */
+	static const unsigned int PIPSIZ = 4096;	/* λֽΪ2 */
+
+	/* Functions */
+public:
+	/* Constructors */
+	Pipe();
+	/* Destructors */
+	~Pipe();
+
+	/*
+	 * @comment ԹܵܵѾPWANT־˯ߵȴֱ
+	 * ûʱȱҳ˯ߣ֤һζдͬһܵϵдϡ
+	 */
+	void Lock();
+	/*
+	 * @comment Թܵһȴ˯ߵĽ
+	 */
+	void Unlock();
+
+	/*
+	 * @comment ܵпɶȡֽ
+	 */
+	unsigned int Count();
+
+	/* Members */
+public:
+	unsigned char* p_buf;		/* λ(ַ̬)ʱΪNULL */
+	unsigned int p_head;		/* ۼдֽģPIPSIZΪдλ */
+	unsigned int p_tail;		/* ۼƶֽģPIPSIZΪλ */
+	int p_count;				/* δرյĶˡдΪ0ʾ */
+	int p_flag;					/* ܵ־λenum PipeFlag */
+};
+
+/*
+ * ܵ(class PipeTable)
+ * ܵ价λķͷš
+ */
+class PipeTable
+{
+	/* static consts */
+public:
+	static const int NPIPE = 20;	/* ܵ */
+
+	/* Functions */
+public:
+	/* Constructors */
+	PipeTable();
+	/* Destructors */
+	~PipeTable();
+
+	/*
+	 * @comment һйܵ价λˡд˾Ϊ
+	 */
+	Pipe* PAlloc();
+	/*
+	 * @comment رչܵһˣڹܵϵȴḶ̌˶رպͷŹܵ
+	 */
+	void PClose(Pipe* pPipe);
+	/*
+	 * @comment ͷŹܵ价λ
+	 */
+	void PFree(Pipe* pPipe);
+
+	/* Members */
+public:
+	Pipe m_Pipe[NPIPE];
+};
+
+/* Pipe.cppļ */
+extern PipeTable g_PipeTable;
+
+#endif
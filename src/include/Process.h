@@ -4,6 +4,9 @@
 #include "Text.h"
 #include "TTy.h"
 #include "Regs.h"
+#include "PageTable.h"
+#include "PageDirectory.h"
+#include "TimerWheel.h"
 
 /*
  * ProcessUNIX V6н̿ƿprocṹӦֻı
@@ -26,10 +29,10 @@ public:
 
 	enum ProcessFlag	/* ̱־λ */
 	{
-		SLOAD	= 0x1,	/* ͼڴ */
-		SSYS	= 0x2,	/* ϵͳͼ񣬲 */
-		SLOCK	= 0x4,	/* иñ־Ľͼݲ */
-		SSWAP	= 0x8,	/* ý̱ʱͼڽ */
+		SLOAD	= 0x1,	/* ppdaڴ */
+		SSYS	= 0x2,	/* ϵͳ̣ûпɻҳ */
+		SLOCK	= 0x4,	/* иñ־Ľҳݲ */
+		SSWAP	= 0x8,	/* ý̱ʱͼڽϣҳ漶ҳʹ */
 		STRC	= 0x10,	/* ӽ̸ٱ־UNIX V6++δЧʹõ */
 		STWED	= 0x20	/* ӽ̸ٱ־UNIX V6++δЧʹõ */
 	};
@@ -39,13 +42,13 @@ public:
 	void SetRun();								/* ѵǰ̣ת״̬ */
 	
 	void SetPri();								/* ռCPUʱ㵱ǰ */
+
+	void DecayCpu();							/* ϴ˥ÿһεp_cpu˥Ҫʱ */
 	
 	bool IsSleepOn(unsigned long chan);			/* 鵱ǰ˯ԭǷΪchan */
 	
 	void Sleep(unsigned long chan, int pri);	/* ʹǰת˯״̬ */
 	
-	void Expand(unsigned int newSize);			/* ıռõڴС */
-	
 	void Exit();								/* Exit()ϵͳô */
 	
 	void Clone(Process& proc);					/* p_pid֮⣬ӽ̿Processṹ */
@@ -77,10 +80,23 @@ public:
 	int p_pid;			/* ̱ʶ̱ */
 	int p_ppid;			/* ̱ʶ */
 
+	/* ̼ϵWait()Exit()ֻԼӽ */
+	Process*	p_pptr;		/*  */
+	Process*	p_cptr;		/* ӽ */
+	Process*	p_ysptr;	/* ֵܽ */
+	Process*	p_osptr;	/* 紴ֵܽ */
+
+	/* ʹеĽϵͳpidɢбУڿ */
+	Process*	p_next;		/* ϵͳеĺһ̣ʱΪеĺһ */
+	Process*	p_prev;		/* ϵͳеǰһ */
+	Process*	p_hash;		/* pidɢбͬһеĺһ */
+
 	/* ڴͼϢλ */
 	unsigned long	p_addr; /* TBD userṹppdaڴеĵַҳеĳһ */
-	unsigned int	p_size; /* Ķεĳȣֽڵλ */
+	unsigned int	p_size; /* פڴppdaȣֽڵλݶΡջΰҳ䣬 */
 	Text*	p_textp;		/* ָýеĴε */
+	PageTable*	p_pgtable;	/* Եַӳձ(ַ̬)ҳûػ̷ */
+	PageDirectory*	p_pgdir;	/* ˽ҳĿ¼(ַ̬)ҳûػ̾˷û̬ҳ */
 
 	/* ̵״̬ */
 	ProcessState	p_stat;	/* ̵ǰ״̬ */
@@ -92,11 +108,25 @@ public:
 	int p_time;			/* (ڴ)פʱ */
 
 	unsigned long	p_wchan;	/* ˯ԭһΪڴַȴĳں */
+	Timer	p_timer;		/* ʱ˯ߵĶʱַΪ˯ԭ */
+
+	/* УSRUN״̬δռCPUĽӦĶ */
+	Process*	p_forw;		/* еĺһ̣ھʱΪNULL */
+	Process*	p_back;		/* еǰһ */
+	int	p_rqidx;		/* ھеţʱp_prió */
+	unsigned int	p_decay;	/* һ˥p_cpuʱProcessManager::DecaySec */
 	
 	/* ź̨ն */
 	int p_sig;			/* ź */
 	TTy* p_ttyp;		/* ttyṹַ */
 	unsigned long p_sigmap;
+
+	/* ֹʱExit()¼Wait()ȡãپu */
+	int p_xstat;		/* exit()ķֵ */
+	int p_utime;		/* û̬ʱ */
+	int p_stime;		/* ̺̬ʱ */
+	int p_cutime;		/* ӽû̬ʱܺ */
+	int p_cstime;		/* ӽ̺̬ʱܺ */
 };
 
 #endif
@@ -3,6 +3,7 @@
 
 #include "Process.h"
 #include "Assembly.h"
+#include "Utility.h"
 
 /* 
  * espebpuṹĺ꣬ҪNewProc()Swtch()
@@ -27,12 +28,12 @@
 		
 /* 
  * ˢںҳ1023ĺ꣬ڽ̵ʱ̵ָָuַʹ
- * GetUser()صǰ̵uṹ
+ * GetUser()صǰ̵uṹֻuҳTLB
  */
 #define SwtchUStruct(p) \
 	Machine::Instance().GetKernelPageTable().m_Entrys[Kernel::USER_PAGE_INDEX].m_PageBaseAddress \
 		= (p)->p_addr / PageManager::PAGE_SIZE; \
-	FlushPageDirectory();
+	X86Assembly::INVLPG(Kernel::USER_ADDRESS);
 
 /* 
  * ָespebpuṹĺ꣬ʹúͬSaveU()
@@ -64,15 +65,31 @@ class ProcessManager
 {
 	/* static consts */
 public:
-	static const int NPROC = 100;
+	static const int NPROC = 100;		/* ̬̱ʱӺڴ水ҳ̱ */
+	static const int NPIDHASH = 64;		/* pidɢбĶ2 */
 	static const unsigned long PROCESS_ZERO_PPDA_ADDRESS = 0x400000 - 0x1000;
 
 	static const int NTEXT = 50;
+	static const int NTEXTHASH = 16;		/* Ķ(dev, ino)ɢбĶ2 */
+	/* ޽õĶλռڴޣISVTXĶβ */
+	static const unsigned int TEXT_CACHE_SIZE = 0x100000;
 
 	static const int NEXEC = 10;
 
 	static const unsigned int USIZE = 0x1000;	/* ppdaСֽΪλ */
 
+	static const int PAGEOUT_BATCH = 8;		/* ҳûػÿαʱҳ */
+
+	/* 
+	 * УPRI_MIN ~ 255ÿȡֵһУͬһĽ̰Ƚȳת
+	 * RunBitmap¼ЩзǿգRunSummary¼RunBitmapЩַ0Select()ֻbsf
+	 */
+	static const int PRI_MIN = -128;
+	static const int NRUNQ = 256 - PRI_MIN;
+	static const int NRUNQWORD = NRUNQ / 32;
+
+	static const int NSWTRACE = 64;		/* лټ¼ѭС */
+
 	/* 
 	 * ̽˯״̬ʱں˸˯ԭ
 	 * СΪȨ˯ߣΪȨ˯ߡ
@@ -101,15 +118,19 @@ public:
 	void SetupProcessZero();
 
 	/*
-	 * Swtch()м0#̨󣬵ô˺ѡ
-	 * ʺ̨еĽ
+	 * Swtch()̵̨ĺջϵô˺Ӿȡ
+	 * ʺ̨еḶ̌ûоʱNULL
 	 */
 	Process* Select();
 
+	/* ½ֳָ̻󣬼¼һνлĸϢ */
+	void TraceSwtch(Process* selected);
+
 	/*
 	 * @comment ɵǰн̵Ŀӡ̷ֵΪ0.
 	 * ӽڱȺ󷵻1,ָӽ̵Ψһ
-	 * ,ӽҪȺ
+	 * ,ӽҪȺСûпProcessڴ
+	 * ʱ-1
 	 *
 	 */
 	int NewProc();
@@ -117,18 +138,53 @@ public:
 	int Swtch();
 
 	/* 
-	 * ͼڴͽ֮Ĵ͡нҪڴ棬ڴ
-	 * ޷ҵܹɸý̵ڴνȨ˯״̬(SWAIT)-->
-	 * ͣ״̬(SSTOP)-->Ȩ˯״̬(SSLEEP)-->״̬(SRUN)̻
-	 * ֱڳ㹻ڴռ佫ҪĽ̵ڴ
+	 * 0#ִеҳûػ̡н̷䲻ڴʱѣ
+	 * ʱ(λ)㷨ѡδʵݶΡջҳ滻
+	 * ȻѵȴڴĽ̡
 	 */
 	void Sched();
 
+	/* 
+	 * Ϊ̷û̬ڴ棬ڴ治ʱҳûػ̲˯ߵȴ
+	 * ֱɹֻڽеá
+	 */
+	unsigned long AllocUserMemory(unsigned long size);
+
+	/* ӿȡһProcessΪʱһҳڴ̱ʧܷNULL */
+	Process* AllocProc();
+
+	/* ½̴ɣϵͳpidɢбΪparentӽ */
+	void LinkProc(Process* pProcess, Process* parent);
+
+	/* ѱƺĽƳϵͳpidɢб͸̵ӽProcessŻؿ */
+	void FreeProc(Process* pProcess);
+
+	/* pidɢбвҽ̣û򷵻NULL */
+	Process* PFind(int pid);
+
+	/* pProcessparentӽ */
+	void AddChild(Process* parent, Process* pProcess);
+
+	/* pProcess丸̵ӽƳ */
+	void RemoveChild(Process* pProcess);
+
 	/* 
 	 * ̵ȴӽ̽Wait()ϵͳ
 	 */
 	void Wait();
 
+	/* ̼Ӧľĩβڶκβ */
+	void AddRunQueue(Process* pProcess);
+
+	/* ̴ӾƳ */
+	void RemoveRunQueue(Process* pProcess);
+
+	/* ޸ĽھеĽ̰µŶ */
+	void ChangePri(Process* pProcess, int priority);
+
+	/* ÿĩƽDecaySecԾеĽ̽p_cpu˥˯߽ڱʱ */
+	void DecayRunQueue();
+
 	/* 
 	* ̴Fork()ϵͳ
 	*/
@@ -150,12 +206,42 @@ public:
 	void WakeUpAll(unsigned long chan);
 
 	/*
-	 * ̴ڴ滻̽
-	 * pProcess: ָҪĽ
-	 * bFreeMemory: ǷͷŽͼռݵڴ
-	 * size: Ķ⣬̿ɽͼ񳤶ȣsizeΪ0ʱֱʹp_size
+	 * ʱ㷨ɨ̵˽ҳ棺λΪ10ڶλᣬ
+	 * 򻻳໻countҳ棬ʵʻҳ
+	 */
+	int ClockScan(int count);
+
+	/* pProcessһפڴ˽ҳ滻ͷҳ򡣽ʱfalseҳڴ */
+	bool PageOut(Process* pProcess, PageTableEntry* entry);
+
+	/* ĶδɢбƳͷڴ棬ͷŶInode */
+	void XRelease(Text* pText);
+	void XHashRemove(Text* pText);
+
+	/* ɢбвҿִļpInodeɹĶΣû򷵻NULL */
+	Text* XLookup(Inode* pInode);
+
+	/* װĶμ(dev, ino)ɢб */
+	void XHashInsert(Text* pText);
+
+	/* 
+	 * һͷĶʱãISVTXĶһֱ
+	 * İLRUڻУTEXT_CACHE_SIZEʱ̭δߡ
 	 */
-	void XSwap(Process* pProcess, bool bFreeMemory, int size);
+	void XCache(Text* pText);
+
+	/* 
+	 * ̭һδõĻĶΣͷڴInodeá
+	 * stickyΪtrueʱûͨĶο̭̭ISVTXĶΡ
+	 * Ƿ̭ɹ
+	 */
+	bool XShrink(bool sticky);
+
+	/* 
+	 * ִļpInodeдͷ仺δʹõĶΡ߳pInodeá
+	 * ĶнʹʱInodeITEXT־ɵ߷ETXTBSY
+	 */
+	void XInvalidate(Inode* pInode);
 
 	/*
 	 * źsignal뷢ͽͬһն˵н
@@ -165,15 +251,37 @@ public:
 	/* Members */
 public:
 	Process process[NPROC];
+	Process* ProcList;		/* ϵͳзǿеĽ */
+	Process* ProcFreeList;	/* Process */
+	Process* PidHash[NPIDHASH];	/* pidɢб */
+	int ProcCnt;		/* ϵͳеĽ */
+	int ProcTableSize;	/* ̱Ĳ */
 	Text text[NTEXT];
+	Text* TextHash[NTEXTHASH];	/* Ķ(dev, ino)ɢб */
+	unsigned int TextCacheSize;	/* ޽õĶռõڴ棬ֽΪλ */
+	unsigned int TextLru;		/* ĶLRUʱ */
+
+	Process* RunQueue[NRUNQ];	/* ľУѭ˫Ķ */
+	unsigned int RunBitmap[NRUNQWORD];	/* ǿվλͼ */
+	unsigned int RunSummary;	/* RunBitmapз0ֵλͼ */
+	unsigned int DecaySec;		/* ÿĩ1ڲ˯̵߽p_cpu˥ */
 
 	int CurPri;		/* ռCPUʱ */
 	int RunRun;		/* ǿȵȱ־ */
-	int RunIn;		/* ڴ޺ʽ̿Ե̽ */
-	int RunOut;		/* ̽޽̿Եڴ */
+	int PgWant;		/* ȴڴҳûػ˯ڴ */
+	int PgIn;		/* ӽҳ */
+	int PgOut;		/* ҳȴڴ桢ȴҳ滻Ľ˯ڴ */
+	int PgFault;	/* ȱҳ쳣 */
+	Process* ClockProc;	/* ʱָ룺ϵͳһɨĽ */
+	unsigned int ClockPage;	/* ʱָ룺ýһɨҳ */
 	int ExeCnt;		/* ͬʱͼĻĽ */
 	int SwtchNum;	/* ϵͳнл */
 
+	struct swtrace SwtchTrace[NSWTRACE];	/* NSWTRACEνлĸټ¼ */
+	unsigned int SwtchTraceCnt;	/* Ѽ¼л */
+	unsigned int SwtchStart;	/* лʼʱTSCĵ32λ */
+	int SwtchFrom;		/* л̨pid */
+
 private:
 	static unsigned int m_NextUniquePid;
 public:
@@ -0,0 +1,48 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "Regs.h"
+#include "Utility.h"
+
+/*
+ * ںͳƲÿʱжϼ¼һαжϵַָǰ̺ǰ̬
+ * 뱾οڼĻλkprof()ϵͳÿرպȡߡʱ
+ * Ҫûʱȡߡϵtools/kprofsym
+ * kernel.symԭΪ
+ *
+ * ͬʱʵUNIXͳprofil()û̬ʱжʱpcûṩֱͼм
+ */
+class Profiler
+{
+	/* static consts */
+public:
+	static const unsigned int NSAMPLE = 2048;	/* λHZΪ100ʱԼ20 */
+
+	/* kprof() */
+	static const int PROF_START = 1;	/* ջʼ */
+	static const int PROF_STOP = 2;		/* ֹͣػʱ */
+	static const int PROF_READ = 3;		/* ȡ߻еȡߵĸ */
+
+	/* Functions */
+public:
+	/* ʱжϴãticksΪʱжϲǵʱж */
+	static void Clock(struct pt_regs* regs, struct pt_context* context, unsigned int ticks);
+
+	/* kprof()ϵͳ */
+	static int Control(int cmd, struct profsample* buf, unsigned int count);
+
+	/* ʱжϷû̬֮ǰãClock()мµprofil()ӵûֱ̬ͼ */
+	static void AddUPC();
+
+	/* Members */
+public:
+	static int running;				/* Ƿڲ */
+
+private:
+	static struct profsample buffer[NSAMPLE];
+	static unsigned int head;		/* д */
+	static unsigned int tail;		/* ȡߵ */
+	static unsigned int dropped;	/* ʱ */
+};
+
+#endif
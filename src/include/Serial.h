@@ -0,0 +1,101 @@
+#ifndef SERIAL_H
+#define SERIAL_H
+
+#include "Regs.h"
+#include "TTy.h"
+
+/*
+ * COM1上16550 UART的驱动。
+ * 收发都由中断驱动并使用16字节硬件FIFO：发送中断每次把输出队列t_outq中的
+ * 字符写满发送FIFO，即每FIFO_SIZE个字符才中断一次；接收中断一次取空接收FIFO，
+ * 逐个字符交给TTy::TTyInput()，因此行规则、回显与键盘输入完全相同。
+ * CONSOLE为true时开机即由COM1承担控制台g_TTy的输入输出，否则COM1作为
+ * 独立的字符设备(主设备号1)，可用于把跟踪记录、测试结果等输出到宿主机。
+ */
+class Serial
+{
+	/* Const Member */
+public:
+	static const unsigned short COM1_PORT = 0x3F8;	/* COM1 I/O端口基地址 */
+
+	/* 寄存器相对基地址的偏移 */
+	static const unsigned short RBR = 0;	/* 接收缓冲寄存器(读) */
+	static const unsigned short THR = 0;	/* 发送保持寄存器(写) */
+	static const unsigned short DLL = 0;	/* 波特率除数低字节(LCR_DLAB = 1时) */
+	static const unsigned short DLM = 1;	/* 波特率除数高字节(LCR_DLAB = 1时) */
+	static const unsigned short IER = 1;	/* 中断允许寄存器 */
+	static const unsigned short IIR = 2;	/* 中断标识寄存器(读) */
+	static const unsigned short FCR = 2;	/* FIFO控制寄存器(写) */
+	static const unsigned short LCR = 3;	/* 线路控制寄存器 */
+	static const unsigned short MCR = 4;	/* MODEM控制寄存器 */
+	static const unsigned short LSR = 5;	/* 线路状态寄存器 */
+	static const unsigned short MSR = 6;	/* MODEM状态寄存器 */
+	static const unsigned short SCR = 7;	/* 暂存寄存器 */
+
+	/* IER */
+	static const unsigned char IER_RDI = 0x01;		/* 接收数据就绪中断 */
+	static const unsigned char IER_THRI = 0x02;		/* 发送保持寄存器空中断 */
+	static const unsigned char IER_RLSI = 0x04;		/* 接收线路状态中断 */
+
+	/* IIR */
+	static const unsigned char IIR_NO_INT = 0x01;	/* 没有待处理的中断 */
+	static const unsigned char IIR_ID = 0x0E;		/* 中断类型字段 */
+	static const unsigned char IIR_MSI = 0x00;		/* MODEM状态变化 */
+	static const unsigned char IIR_THRI = 0x02;		/* 发送保持寄存器空 */
+	static const unsigned char IIR_RDI = 0x04;		/* 接收FIFO达到触发深度 */
+	static const unsigned char IIR_RLSI = 0x06;		/* 接收线路状态(溢出、校验错等) */
+	static const unsigned char IIR_TIMEOUT = 0x0C;	/* 接收FIFO中有字符但长时间未达到触发深度 */
+
+	/* FCR */
+	static const unsigned char FCR_ENABLE = 0x01;		/* 启用FIFO */
+	static const unsigned char FCR_CLEAR_RCVR = 0x02;	/* 清空接收FIFO */
+	static const unsigned char FCR_CLEAR_XMIT = 0x04;	/* 清空发送FIFO */
+	static const unsigned char FCR_TRIGGER_8 = 0x80;	/* 接收FIFO满8字节时产生中断 */
+
+	/* LCR */
+	static const unsigned char LCR_8N1 = 0x03;		/* 8位数据位，无校验，1位停止位 */
+	static const unsigned char LCR_DLAB = 0x80;		/* 访问波特率除数寄存器 */
+
+	/* MCR */
+	static const unsigned char MCR_DTR = 0x01;
+	static const unsigned char MCR_RTS = 0x02;
+	static const unsigned char MCR_OUT2 = 0x08;		/* 置位后UART的中断才送到8259A */
+	static const unsigned char MCR_LOOP = 0x10;		/* 回环自检 */
+
+	/* LSR */
+	static const unsigned char LSR_DR = 0x01;		/* 接收FIFO中有数据 */
+	static const unsigned char LSR_THRE = 0x20;		/* 发送保持寄存器(发送FIFO)空 */
+
+	static const int FIFO_SIZE = 16;				/* 16550发送、接收FIFO的字节数 */
+	static const unsigned int BAUD_BASE = 115200;	/* 1.8432MHz晶振对应的最高波特率 */
+	static const unsigned int BAUD_RATE = 115200;	/* 使用的波特率 */
+
+	static const bool CONSOLE = false;				/* 为true时开机把控制台切换到COM1 */
+
+	/* Functions */
+public:
+	/* 检测并初始化COM1，并把它与控制台或独立的TTy结构关联。检测不到UART时返回false */
+	static bool Initialize();
+
+	/* COM1中断处理程序 */
+	static void SerialHandler(struct pt_regs* reg, struct pt_context* context);
+
+	/* TTy的输出例程：发送FIFO空闲时立即写满FIFO，否则留给发送中断 */
+	static void Start(TTy* pTTy);
+
+private:
+	/* 从输出队列取字符写满发送FIFO，须在关中断时调用 */
+	static void Transmit();
+
+	/* 把收到的字符送入TTy的原始输入队列 */
+	static void Receive(char ch);
+
+	/* Members */
+public:
+	static TTy* m_TTy;			/* COM1对应的TTy结构，为g_TTy或g_SerialTTy */
+
+private:
+	static bool m_TxBusy;		/* 发送FIFO中有字符正在发送，发送完毕后会产生发送中断 */
+};
+
+#endif
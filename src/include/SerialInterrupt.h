@@ -0,0 +1,11 @@
+#ifndef SERIAL_INTERRUPT_H
+#define SERIAL_INTERRUPT_H
+
+class SerialInterrupt
+{
+public:
+	/* 串口COM1中断内核处理入口函数，在IDT的COM1中断对应中断门 */
+	static void SerialInterruptEntrance();
+};
+
+#endif
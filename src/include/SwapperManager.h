@@ -11,11 +11,21 @@ public:
 	/* !hard code!趨̴18000#ʼ2000Ϊ */
 	static unsigned int SWAPPER_ZONE_START_BLOCK;
 	static unsigned int SWAPPER_ZONE_SIZE;
+	/* λڴ֮̽ǰѹڴ潻شСΪ0ʹڴ潻 */
+	static unsigned int ZPOOL_SIZE;
 
 	/* static const member */
 	static const unsigned int SWAPPER_MAP_ARRAY_SIZE = 0x200;
 	static const unsigned int BLOCK_SIZE = 512;
 
+	static const unsigned int ZCHUNK_SIZE = 64;		/* ڴ潻ذ64ֽΪλ */
+	static const unsigned int ZNSLOT = 1024;		/* ڴ潻ŵҳ */
+	static const unsigned int ZMAX_SIZE = 3072;		/* ҳѹ󳬹˳ֵ÷ڴ潻أֱд */
+	/* ҳ滻λñŲСZHANDLE_BASEʱڴ潻أΪ̽̿ */
+	static const unsigned int ZHANDLE_BASE = 0x80000;
+	/* ӳٷֲ0С2KʱڣiΪ[2^i K, 2^(i+1) K)ĩӳ */
+	static const int NLATENCY = 12;
+
 	/* Functions */
 public:
 	SwapperManager(Allocator* pAllocator);
@@ -43,15 +53,56 @@ public:
 	 */
 	int FreeSwap(unsigned long size, int startBlock);
 
+	/* 
+	 * ַframeʼһҳȳѹڴ潻أ
+	 * ڴ潻ѹЧʱд̽
+	 * 
+	 * ֵ: ҳĻλñţ0ʾռ䲻д̳
+	 */
+	int SwapOutPage(unsigned long frame);
+	/* 
+	 * λñhandleҳַframeʼһҳ
+	 * ͳƻӳ١ͷŻλáfalseʾI/O
+	 */
+	bool SwapInPage(int handle, unsigned long frame);
+	/* ͷŻλñhandleҳռõڴ潻ػ̽ռ */
+	void FreeSwapPage(int handle);
+
 private:
 	SwapperManager();
 
+	/* ¼һλӳٵlatencyֲ */
+	void RecordLatency(int latency[], unsigned long long cycles);
+
 	/* Members */
 public:
 	MapNode map[SwapperManager::SWAPPER_MAP_ARRAY_SIZE];
 
+	/* ҳͳ */
+	int ZPageOut;		/* ѹڴ潻صҳ */
+	int ZPageIn;		/* ڴ潻ؽѹҳ */
+	int DiskPageOut;	/* д̽ҳ */
+	int DiskPageIn;		/* Ӵ̽ҳ */
+	unsigned int ZOrigBytes;	/* ڴ潻ҳԭʼֽ */
+	unsigned int ZCompBytes;	/* ҳѹֽ */
+	int ZLatency[NLATENCY];		/* ڴ潻ػӳٷֲ */
+	int DiskLatency[NLATENCY];	/* ̽ӳٷֲ */
+
 private:
 	Allocator* m_pAllocator;
+
+	/* ڴ潻һѹҳλãz_sizeΪ0ʾ */
+	struct ZSlot
+	{
+		unsigned short z_chunk;		/* ʼ䵥λţ1ʼ */
+		unsigned short z_size;		/* ѹֽ */
+	};
+
+	unsigned long m_ZPool;		/* ڴ潻صĺ̬ʼַ0ʾʹ */
+	unsigned long m_ZBuffer;	/* ѹѹõҳ̬ʱ */
+	MapNode m_ZMap[SwapperManager::SWAPPER_MAP_ARRAY_SIZE];	/* ڴ潻ؿз䵥λ */
+	ZSlot m_ZSlot[ZNSLOT];
+	unsigned int m_ZNextSlot;	/* һβҿZSlot */
 };
 
 #endif
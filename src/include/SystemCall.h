@@ -17,6 +17,7 @@ struct SystemCallTableEntry
 {
 	unsigned int	count;			//ϵͳõĲ
 			 int	(*call)();		//Ӧϵͳôָ
+	unsigned int	flags;			//ϵͳõķɷʽSystemCall::SC_LEAN
 };
 
 /* 
@@ -36,6 +37,12 @@ public:
 	/*ϵͳôڱĴС*/
 	static const unsigned int SYSTEM_CALL_NUM = 64;
 
+	/* 
+	 * ڱ־ֻȡں˱EAXء˯Ҳϵͳã
+	 * getpid()time()ûдźʱ߾·
+	 */
+	static const unsigned int SC_LEAN = 0x1;
+
 public:
 	SystemCall();
 	~SystemCall();
@@ -52,6 +59,19 @@ public:
 	 */
 	static void SystemCallEntrance();
 
+	/* 
+	 * ϵͳڣSYSENTER(Machine::InitFastSystemCall())
+	 * ڴĻsysenter_entryint $0x80ĸʽںջϹpt_context
+	 * תˣ˺SystemCallEntrance()ͬSYSEXITû̬
+	 *
+	 * û̬ԼEAXΪϵͳúţEBXECXEDXESIΪEBPΪʱ
+	 * ûջָ룬EDIΪصַغECXEDXдû⸺𱣴档
+	 */
+	static void FastCallEntrance() __asm__("sysenter_trap_entrance");
+
+	/* SYSENTERĿַдIA32_SYSENTER_EIPSystemCall.cppеĻ붨 */
+	static void SysEnterEntry() __asm__("sysenter_entry");
+
 	/* ӦUNIX V6еtrap(dev, sp, r1, nps, r0, pc, ps),
 	 * ҪV6ϵͳõswitch֧case 6+USER: // sys call
 	 * 쳣X86ƽ̨INT 0-31handlerV6
@@ -158,8 +178,8 @@ private:
 	/*	26 = ptrace	count = 3	*/
 	static int Sys_Ptrace();
 	
-	/*	27 = nosys	count = 0	*/
-	static int Sys_Nosys();		/* ʾǰϵͳúűδʹãչ */
+	/*	27 = pgstat	count = 1	*/
+	static int Sys_Pgstat();
 	
 	/*	28 = fstat	count = 1	*/
 	static int Sys_FStat();
@@ -169,13 +189,14 @@ private:
 	
 	/*	30 =  smdate; inoperative	count = 1	handler = nullsys	*/
 	
-	/*	31 = stty	count = 1	*/
+	/*	31 = stty	count = 2	*/
 	static int Sys_Stty();
 	
 	/*	32 = gtty	count = 1	*/
 	static int Sys_Gtty();
 	
-	/*	33 = nosys	count = 0	*/
+	/*	33 = nanosleep	count = 1	*/
+	static int Sys_Nanosleep();
 	
 	/*	34 = nice	count = 0	*/
 	static int Sys_Nice();
@@ -195,7 +216,8 @@ private:
 	/*	39 = pwd	count = 1	*/
 	static int Sys_Pwd();
 	
-	/*	40 = nosys	count = 0	*/
+	/*	40 = idlestat	count = 2	*/
+	static int Sys_Idlestat();
 	
 	/*	41 = dup	count = 0	*/
 	static int Sys_Dup();
@@ -209,7 +231,8 @@ private:
 	/*	44 = prof	count = 4	*/
 	static int Sys_Profil();
 	
-	/*	45 = nosys	count = 0	*/
+	/*	45 = kprof	count = 3	*/
+	static int Sys_Kprof();
 	
 	/*	46 = setgid	count = 0	*/
 	static int Sys_Setgid();
@@ -220,7 +243,41 @@ private:
 	/*	48 = sig	count = 2	*/
 	static int Sys_Ssig();
 	
-	/*	49 ~ 63 = nosys	count = 0	*/	
+	/*	49 = swtrace	count = 2	*/
+	static int Sys_Swtrace();
+
+	/*	50 = ktrace	count = 3	*/
+	static int Sys_Ktrace();
+
+	/*	51 = klog	count = 3	*/
+	static int Sys_Klog();
+
+	/*	52 = poll	count = 3	*/
+	static int Sys_Poll();
+
+	/*	53 = fcntl	count = 3	*/
+	static int Sys_Fcntl();
+
+	/*	54 = pread	count = 4	*/
+	static int Sys_Pread();
+
+	/*	55 = pwrite	count = 4	*/
+	static int Sys_Pwrite();
+
+	/*	56 = readv	count = 3	*/
+	static int Sys_Readv();
+
+	/*	57 = writev	count = 3	*/
+	static int Sys_Writev();
+
+	/*	58 = sendfile	count = 3	*/
+	static int Sys_Sendfile();
+
+	/*	59 = getdents	count = 4	*/
+	static int Sys_Getdents();
+
+	/*	60 ~ 63 = nosys	count = 0	*/
+	static int Sys_Nosys();		/* ʾǰϵͳúűδʹãչ */
 
 private:
 	/*ϵͳڱ*/
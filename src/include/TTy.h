@@ -31,6 +31,15 @@ public:
 	/* ػмȡַĵַ */
 	char* CurrentChar();
 
+	/* лַܷTTY_BUF_SIZE - 1ַ */
+	int FreeNum();
+
+	/* srcɿcountַĩβĻƵֶθƣطַ */
+	int PutChars(const char* src, int count);
+
+	/* ɿȡcountַdstȡַ */
+	int GetChars(char* dst, int count);
+
 public:
 	unsigned int m_Head;	/* ַָһڴŽַλ */
 	unsigned int m_Tail;	/* ַָһҪȡַλ */
@@ -87,7 +96,7 @@ public:
 	/* ַ */
 	void TTyOutput(char ch);
 
-	/* tty豸ϵͳУֻΪ˱ֲ֤ṹ */
+	/* tty豸豸t_oprocûʱCRTʾ */
 	void TTStart();
 
 	/* TTYл */
@@ -97,9 +106,14 @@ public:
 	/* й򣬶ַдɾлbackspace */
 	int Canon();
 
-	int PassC(char ch);
+	/* sttygttyflags >= 0ʱùʽt_flagsԭȵt_flags */
+	int SgTTy(int flags);
 
-	char CPass();
+	/* poll˯ߣ淶ʽһУԭʼʽַ */
+	bool ReadReady();
+
+	/* pollδд˯ */
+	bool WriteReady();
 
 public:
 	TTy_Queue t_rawq;	/* ԭʼַ */
@@ -115,6 +129,8 @@ public:
 	int t_state;	/* 豸״̬ */
 	short dev;		/* 豸 */
 
+	void (*t_oproc)(TTy*);	/* 豸̣Serial::Start()ΪNULLʱCRT */
+
 
 	char Canonb[CANBSIZ];	/* ַĹ */
 };
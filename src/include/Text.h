@@ -11,28 +11,60 @@
  */
 class Text
 {
+public:
+	/* x_flagб־λ */
+	enum TextFlag
+	{
+		XHASH = 0x1,		/* λ(dev, ino)ɢбУɱExec() */
+		XCACHE = 0x2		/* ޽ãĶλв뻺 */
+	};
+
+	/* ִļгֵļsection.text.data.rdata.bssֻ */
+	static const unsigned int NSECTION = 3;
+	/* Ķҳװλͼĳȣ8Mûռ2048ҳÿһλӦĶεһҳ */
+	static const unsigned int NPAGEMAP = 2048 / 32;
+
 public:
 	Text();
 	~Text();
 
-	/* ݼx_ccountֵx_ccountݼ0
-	 * ʾڴѾûøùĶεḶ̌
-	 * ͷŸùĶռݵڴ档
-	 */
+	/* ݼx_ccountֵĶڴĶλͳһգ˴ͷš */
 	void XccDec();
 
 	/*
 	 * ͷõĹĶΣͨExit()Exec()ʱ
+	 * һͷźĶͬװҳĶλ档
 	 */
 	void XFree();
 
+	/* ĶεpageIdxҳ(Ķʼ)ǷѴӿִļװڴ */
+	bool IsLoaded(unsigned int pageIdx);
+	void SetLoaded(unsigned int pageIdx);
+	/* ȫװ־Ķڴ汻ͷŻ· */
+	void ClearLoaded();
+
+	/* 
+	 * section֣ӿִļx_iptrжûԵַvirtualAddressʼһҳݣ
+	 * ŵַ̬bufferκsectionļݵĲ(.bss)0
+	 * ̳ʱfalseʱbufferеݲ
+	 */
+	bool ReadPage(unsigned long virtualAddress, unsigned char* buffer);
+
 public:
-	int				x_daddr;	/* Ķ̽ϵĵַ */
 	unsigned long	x_caddr;	/* ĶڴеʼַֽΪλ */
 	unsigned int	x_size;		/* γȣֽΪλ */
 	Inode*			x_iptr;		/* ڴinodeַ */
 	unsigned short	x_count;	/* ĶεĽ */
 	unsigned short	x_ccount;	/* ĶͼڴĽ */	
+	unsigned short	x_flag;		/* Ķλ־ */
+	unsigned int	x_lru;		/* һαͷŵʱĶλݴ̭δ */
+	Text*			x_forw;		/* (dev, ino)ɢжеһTextṹ */
+
+	/* sectionûռеʼԵַڿִļеƫƺļЧݵĳ */
+	unsigned long	x_secaddr[NSECTION];
+	unsigned long	x_secoff[NSECTION];
+	unsigned long	x_secsize[NSECTION];
+	unsigned int	x_loaded[NPAGEMAP];	/* Ķҳװλͼ */
 };
 
 #endif
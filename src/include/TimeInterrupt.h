@@ -1,29 +1,89 @@
 #ifndef TIME_INTERRUPT_H
 #define TIME_INTERRUPT_H
 
+#include "TimerWheel.h"
+#include "Chip8253.h"
+
+/* nanosleep()ϵͳõĲûtime.hеĶһ */
+struct timespec
+{
+	int tv_sec;		/*  */
+	int tv_nsec;	/* 룺0 ~ 999999999 */
+};
+
+/* idlestat()ϵͳ÷صĿͳƣûsys.hеĶһ */
+struct idlestat
+{
+	unsigned int hz;		/* ʱжƵ */
+	unsigned int ticks;		/* ϵͳʱжʱǵĲ */
+	unsigned int wakeups;	/* еȴжϻѵĴ */
+	unsigned int idleticks;	/* еȴʱж */
+	int tickless;			/* ʱǷֹͣʱж */
+};
+
 class Time
 {
 	/* 
-	 * עBochsʱжϲ׼ȷһʱжϴԶ60Σ
-	 * Ϊ˾ܼСϵͳʱSCHMAGHZֵͬ
-	 * ȡֵԷBochs±Ƚ룬˽Ӱ췶ΧٽиĶ
+	 * 8253HẒHZ100 ~ 1000֮ѡȡԽӳԽСʱжϿԽ
+	 * p_cpuÿʱжϼ1SCHMAGHZͬȱ仯ԭHZΪ120SCHMAGΪ20ı
+	 * עBochsʱжϲ׼ȷҪclock: sync=realtimeϵͳʱƫ졣
 	 */
 public:
-	static const int SCHMAG = 10 * 2;	/* ÿӼٵp_cpuħ */
+	static const int HZ = 100;			/* ÿʱжϴ */
+
+	static const int SCHMAG = HZ / 6;	/* ÿӼٵp_cpuħ */
+
+	static const unsigned int LATCH = Chip8253::INPUT_FREQ / HZ;	/* һʱжڵ8253ֵ */
 
-	static const int HZ = 60 * 2;		/* ÿʱжϴ */
+	static const unsigned int MAX_IDLE_TICKS = Chip8253::MAX_COUNT / LATCH;	/* μԽʱж */
 
 	static int lbolt;				/* ۼƽյʱжϴ */
 	
 	static unsigned int time;		/* ϵͳȫʱ䣬197011 */
 
-	static unsigned int tout;		/* ʱ˯߽ӦѵʱСֵ */
+	static unsigned int ticks;		/* ϵͳʱжϴ봦 */
+
+	static TimerWheel wheel;		/* ʱ˯ں˳ʱõʱ */
+
+	static int tickless;			/* 0ʱڼֹͣʱжϣһʱʱж */
+	static unsigned int idleTicks;	/* ڽеĵμԽʱж0ʾʱж */
+	static unsigned int idleWakeups;	/* еȴжϻѵĴ */
+	static unsigned int idleTotal;	/* еȴʱж */
+
+	static const unsigned int DISK_TIMEOUT = HZ * 5;	/* I/Oȴжϵʱ */
+
+	static const unsigned int MAX_DELAY_SECONDS = 0x7FFFFFFF / HZ - 1;	/* Delay()˯ʱ̰зȽϣܳ2^31ʱж */
+
+	/* öʱpTimerticksʱж֮ڣt_funct_argɵԤ */
+	static void AddTimer(Timer* pTimer, unsigned int ticks);
+
+	/* ȡʱ */
+	static void DelTimer(Timer* pTimer);
+
+	/* ǰ˯ticksʱжϣɱźŴ */
+	static void Delay(unsigned int ticks);
+
+	/* 
+	 * еȴ(hlt)֮ǰãticklessҽûжʱʱ
+	 * 8253ΪμһʱʱŲʱжϡжϵá
+	 */
+	static void IdleEnter();
+
+	/* еȴжϻѺãμδ򲹼Ѿʱжϣָʱж */
+	static void IdleExit();
 
 	/* ʱжںַIDTĴж϶Ӧж */
 	static void TimeInterruptEntrance();
 
 	/* ʱжϴάϵͳʱռCPUʱ䣬˯߽̺ʱеȹ */
 	static void Clock(struct pt_regs* regs, struct pt_context* context);
+
+private:
+	/* ʱ˯ߵĶʱڣѸý */
+	static void WakeUp(unsigned long arg);
+
+	/* ʱǰnʱжϣƽʱִ֣еڵĶʱ */
+	static void Advance(unsigned int n);
 };
 
 #endif
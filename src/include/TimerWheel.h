@@ -0,0 +1,66 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+/*
+ * ʱʱУʱʱжϴt_func(t_arg)
+ * ÿ̵ProcessṹǶһʱ˯ʹã豸ں˳ʱʹþ̬Ķʱ
+ * صڹжϵʱжϴִУ˯ߡ
+ */
+struct Timer
+{
+	Timer*	t_next;
+	Timer*	t_prev;				/* ʱʱΪNULL */
+	unsigned int t_expire;		/* ʱ̣Time::ticks */
+	void	(*t_func)(unsigned long arg);
+	unsigned long t_arg;
+};
+
+/*
+ * ֲʱ֣0256ۣÿ۶Ӧһʱжϣ1 ~ 464ۣÿζӦ
+ * 256256*64256*64^2256*64^3ʱжϣ32λʱжϼ
+ * ʱʱ̾൱ǰԶӦĲУ0ÿתһȦһһ
+ * ·ɢ²㡣롢ɾΪO(1)ÿʱжϵĿ붨ʱ޹ء
+ */
+class TimerWheel
+{
+	/* static consts */
+public:
+	static const int TVR_BITS = 8;
+	static const int TVN_BITS = 6;
+	static const int TVR_SIZE = 1 << TVR_BITS;
+	static const int TVN_SIZE = 1 << TVN_BITS;
+	static const int TVN_LEVELS = 4;
+
+	/* Functions */
+public:
+	TimerWheel();
+	~TimerWheel();
+
+	/* ʱʱ֣ʱpTimer->t_expireڣʱʱ */
+	void Add(Timer* pTimer);
+
+	/* ʱƳʱ֣ʱʱκβ */
+	void Remove(Timer* pTimer);
+
+	/* ʱжϴãƽʱʱnowִ䵽ڵжʱ */
+	void Run(unsigned int now);
+
+	/* 
+	 * һʱlimitʱڣصһҪʱ̣жʱڣ
+	 * Ҫϲɢʱû򷵻һʱ̡ʱõʱжϡ
+	 */
+	unsigned int NextEvent(unsigned int limit);
+
+private:
+	void Insert(Timer* pTimer);
+	/* levelĲindexеĶʱ·ɢ²㣬index */
+	int Cascade(int level, int index);
+
+	/* Members */
+private:
+	Timer m_Root[TVR_SIZE];				/* 0ѭ˫Ķ */
+	Timer m_Vec[TVN_LEVELS][TVN_SIZE];	/* 1 ~ 4 */
+	unsigned int m_Ticks;				/* һʱ */
+};
+
+#endif
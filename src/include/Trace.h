@@ -0,0 +1,88 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/* 
+ * ټ¼ktrace()ϵͳ÷أûsys.hеĶһ¡
+ * ¼arg0arg1Trace::TR_SWTCHȳע͡
+ */
+struct tracerec
+{
+	unsigned long long tsc;	/* ¼ʱTSC */
+	unsigned short event;	/* ¼ */
+	short pid;				/* ¼ʱĵǰpid */
+	unsigned long arg0;
+	unsigned long arg1;
+};
+
+/* ktrace()ϵͳKTR_INFOصĸ״̬TSCʱ */
+struct traceinfo
+{
+	unsigned long long tsc0;	/* ʼʱTSC */
+	unsigned long long tsc1;	/* ǰTSC */
+	unsigned int hz;			/* ʱжƵ */
+	unsigned int ticks0;		/* ʼʱTime::ticks */
+	unsigned int ticks1;		/* ǰTime::ticks */
+	unsigned int total;			/* ʼдļ¼ */
+	unsigned int size;			/* λдļ¼ */
+};
+
+/*
+ * ں˸ٵ㣺TSCΪʱĶƼ¼д뿪ʱӺҳĻλ
+ * 󸲸ļ¼ֻһιжϺrdtscDiagnose::Write()ͬ
+ * дԴıʱktrace()ϵͳÿرպȡߣtools/ktrace2json
+ * תΪChrome trace_eventʽchrome://tracingPerfettoаʱ鿴
+ */
+class Trace
+{
+	/* static consts */
+public:
+	/* ¼ */
+	static const unsigned int TR_SWTCH = 1;		/* лarg0Ϊ̨pidarg1Ϊ̨pid */
+	static const unsigned int TR_SLEEP = 2;		/* ˯ߣarg0Ϊ˯ԭarg1Ϊ˯ */
+	static const unsigned int TR_WAKEUP = 3;	/* ѣarg0Ϊѽpidarg1Ϊ˯ԭ */
+	static const unsigned int TR_SYSCALL = 4;	/* ϵͳý룺arg0Ϊϵͳú */
+	static const unsigned int TR_SYSRET = 5;	/* ϵͳ÷أarg0Ϊϵͳúţarg1ΪEAXеķֵ */
+	static const unsigned int TR_STRATEGY = 6;	/* 豸arg0Ϊţλ1arg1Ϊƿַ */
+	static const unsigned int TR_IODONE = 7;	/* 豸I/OɣͬTR_STRATEGY */
+	static const unsigned int TR_SWAPOUT = 8;	/* ҳ滻ɣarg0Ϊarg1Ϊķѵʱ */
+	static const unsigned int TR_SWAPIN = 9;	/* ҳ滻ɣͬTR_SWAPOUT */
+
+	/* ktrace() */
+	static const int KTR_START = 1;		/* ջarg¼λͼʼ٣0ʾȫ¼ */
+	static const int KTR_STOP = 2;		/* ֹͣ */
+	static const int KTR_READ = 3;		/* ʱȺȡcount¼argȡߵ */
+	static const int KTR_INFO = 4;		/* struct traceinfoƵarg */
+
+	static const unsigned int RING_SIZE = 0x10000;	/* λֽ */
+
+	/* Functions */
+public:
+	/* Ӻҳ价λ䲻ܿ */
+	static void Initialize();
+
+	/* дһ¼жϴеáӦTRACE()ãδ¼õĴ */
+	static void Record(unsigned int event, unsigned long arg0, unsigned long arg1);
+
+	/* ktrace()ϵͳ */
+	static int Control(int cmd, unsigned long arg, unsigned int count);
+
+	/* Members */
+public:
+	static unsigned int mask;		/* ¼λͼeventλӦ¼event */
+
+private:
+	static struct tracerec* ring;
+	static unsigned int size;		/* λɵļ¼ */
+	static unsigned int head;		/* ʼдļ¼ */
+	static unsigned int tail;		/* ʼȡ߻򱻸ǵļ¼ */
+	static unsigned int ticks0;
+	static unsigned long long tsc0;
+};
+
+#define TRACE(event, arg0, arg1)	\
+	do {	\
+		if ( Trace::mask & (1 << (event)) )	\
+			Trace::Record((event), (unsigned long)(arg0), (unsigned long)(arg1));	\
+	} while ( 0 )
+
+#endif
@@ -120,6 +120,17 @@ public:
 	int u_stime;		/* ̺̬ʱ */
 	int u_cutime;		/* ӽû̬ʱܺ */
 	int u_cstime;		/* ӽ̺̬ʱܺ */
+
+	/* profil()õûֱ̬ͼӦUNIX V6u_prof[4] */
+	struct
+	{
+		char*	pr_base;		/* ֱͼʼַÿԪΪshort */
+		unsigned int pr_size;	/* ֱͼֽ */
+		unsigned int pr_off;	/* Ӧֱͼ0Ԫpc */
+		unsigned int pr_scale;	/* С0x10000ʾÿ2ָֽӦһԪ0ʾر */
+		unsigned int pr_pc;		/* ʱжʱû̬pcû̬֮ǰֱͼ */
+		unsigned int pr_ticks;	/* δֱͼʱж */
+	} u_prof;
 	
 	/* źŴسԱ */
 	unsigned long u_signal[NSIG];	/* źŴ */
@@ -29,6 +29,42 @@ struct tms
 	int cstime;		/* ӽ̺̬ʱܺ */
 };
 
+/* ҳûͳϢpgstat()ϵͳ÷ */
+struct pgstat
+{
+	int pgin;		/* ӽҳ */
+	int pgout;		/* ҳ */
+	int pgfault;	/* ȱҳ쳣 */
+	int zpgout;		/* ѹڴ潻صҳ */
+	int zpgin;		/* ڴ潻ؽѹҳ */
+	int dpgout;		/* д̽ҳ */
+	int dpgin;		/* Ӵ̽ҳ */
+	unsigned int zorig;	/* ڴ潻ҳԭʼֽ */
+	unsigned int zcomp;	/* ҳѹֽ */
+	/* ӳٷֲ0С2KʱڣiΪ[2^i K, 2^(i+1) K)ĩӳ */
+	int zlat[12];	/* ڴ潻 */
+	int dlat[12];	/* ̽ */
+};
+
+/* лټ¼swtrace()ϵͳ÷ */
+struct swtrace
+{
+	unsigned int tsc;		/* лʼʱTSCĵ32λ */
+	int from;				/* ̨pid */
+	int to;					/* ̨pid */
+	unsigned int cycles;	/* Swtch()ʼֳָ̨̻ʱеȴ */
+};
+
+/* ںͳƲkprof()ϵͳ÷ */
+struct profsample
+{
+	unsigned long eip;		/* жϵַָ */
+	unsigned long caller;	/* ǰ̬Ϊ̬ʱжϺķصַΪ0 */
+	int pid;				/* ǰpid */
+	unsigned short mode;	/* ǰ̬0Ϊ̬1Ϊû̬ */
+	unsigned short ticks;	/* ʱжʱֹͣʱжϻ1 */
+};
+
 /*
  *@comment һЩʹõĹߺ
  *
@@ -50,6 +86,12 @@ public:
 	 */
 	static void CopySeg(unsigned long src, unsigned long des);
 	static void CopySeg2(unsigned long src, unsigned long des);
+	/* @comment
+	 * ڴַsrc copy ַdes һҳ߶밴ҳ
+	 */
+	static void CopyPage(unsigned long src, unsigned long des);
+	/* ַaddressʼһҳ0address밴ҳ */
+	static void ClearPage(unsigned long address);
 	/* ȡdevе豸major8 */
 	static short GetMajor(const short dev);
 	/* ȡdevеĴ豸minor8 */
@@ -81,6 +123,14 @@ public:
 
 	static unsigned int DaysInYear(int year);
 
+	/* 
+	 * LZ77Ŀѹsrcʼlengthֽѹdes
+	 * ѹlimitֽʱѹ0򷵻ѹĳȡ
+	 */
+	static unsigned int LZCompress(unsigned char* src, unsigned int length, unsigned char* des, unsigned int limit);
+	/* LZCompress()lengthֽѹݽѹdes */
+	static void LZDecompress(unsigned char* src, unsigned int length, unsigned char* des);
+
 	static const unsigned int borrowedPTE = 256;
 	static const unsigned int SECONDS_IN_MINUTE = 60;	/* һ60 */
 	static const unsigned int SECONDS_IN_HOUR = 3600;	/* һСʱ3600 */
@@ -88,6 +138,10 @@ public:
 
 	/* ĳ·ǰ */
 	static const unsigned int DaysBeforeMonth[13];
+
+	/* LZCompress()ʹõ3ֽڴɢб¼ôһγֵλ+1 */
+	static const unsigned int LZ_HASH_SIZE = 4096;
+	static unsigned short LZHashTable[LZ_HASH_SIZE];
 };
 
 #endif
@@ -258,6 +258,20 @@ void Exception::PageFault(struct pt_regs* regs, struct pte_context* context)
 	unsigned int cr2;
 	__asm__ __volatile__(" mov %%cr2, %0":"=r"(cr2) );
 
+	/* 
+	 * exec֮ĶΡݶҳ水װ롣ϵͳûռ䴫ʱ
+	 * ̬Ҳܷʵδװûҳ档
+	 */
+	if ( md.DemandPage(cr2) )
+	{
+		/* װҳʱ̳DemandPage()ѷSIGKILL */
+		if ( (context->xcs & USER_MODE) == USER_MODE && current->IsSig() )
+		{
+			current->PSig( (pt_context *)&context->eip );
+		}
+		return;
+	}
+
     /*ȱҳ쳣ÿչһҳȱ˶Ŷջҳ棬ǾͶִмȱҳ쳣ֱЩҳ油*/
 
 	if( (context->xcs & USER_MODE) == USER_MODE)
@@ -5,6 +5,9 @@
 #include "TimeInterrupt.h"
 #include "CRT.h"
 #include "Video.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "KernelLog.h"
 
 /* ϵͳڱĶ
  * UNIX V6sysent.cжϵͳڱsysentĶ @line 2910 
@@ -24,59 +27,76 @@ SystemCallTableEntry SystemCall::m_SystemEntranceTable[SYSTEM_CALL_NUM] =
 	{ 1, &Sys_UnLink},				/* 10 = unlink	*/
 	{ 3, &Sys_Exec	},				/* 11 = Exec 	*/
 	{ 1, &Sys_ChDir	},				/* 12 = chdir	*/
-	{ 0, &Sys_GTime	},				/* 13 = time 	*/
+	{ 0, &Sys_GTime, SC_LEAN },		/* 13 = time 	*/
 	{ 3, &Sys_MkNod },				/* 14 = mknod	*/
 	{ 2, &Sys_ChMod	},				/* 15 = chmod	*/
 	{ 3, &Sys_ChOwn	},				/* 16 = chown	*/
 	{ 1, &Sys_SBreak},				/* 17 = sbreak	*/
 	{ 2, &Sys_Stat	},				/* 18 = stat 		*/
 	{ 3, &Sys_Seek	},				/* 19 = seek	*/
-	{ 0, &Sys_Getpid},				/* 20 = getpid	*/
+	{ 0, &Sys_Getpid, SC_LEAN },		/* 20 = getpid	*/
 	{ 3, &Sys_Smount	},			/* 21 = mount	*/
 	{ 1, &Sys_Sumount	},			/* 22 = umount	*/
 	{ 1, &Sys_Setuid	},			/* 23 = setuid	*/
-	{ 0, &Sys_Getuid	},			/* 24 = getuid	*/
+	{ 0, &Sys_Getuid, SC_LEAN },		/* 24 = getuid	*/
 	{ 1, &Sys_Stime		},			/* 25 = stime	*/
 	{ 3, &Sys_Ptrace	},			/* 26 = ptrace	*/
-	{ 0, &Sys_Nosys	},				/* 27 = nosys	*/
+	{ 1, &Sys_Pgstat},				/* 27 = pgstat	*/
 	{ 2, &Sys_FStat	},				/* 28 = fstat	*/
 	{ 1, &Sys_Trace	},				/* 29 = trace	*/
 	{ 0, &Sys_NullSystemCall },		/* 30 = smdate; inoperative */
 	{ 2, &Sys_Stty	},				/* 31 = stty	*/
 	{ 2, &Sys_Gtty	},				/* 32 = gtty	*/
-	{ 0, &Sys_Nosys	},				/* 33 = nosys	*/
+	{ 1, &Sys_Nanosleep},			/* 33 = nanosleep	*/
 	{ 1, &Sys_Nice	},				/* 34 = nice	*/
 	{ 1, &Sys_Sslep	},				/* 35 = sleep	*/
 	{ 0, &Sys_Sync	},				/* 36 = sync	*/
 	{ 2, &Sys_Kill	},				/* 37 = kill		*/
-	{ 0, &Sys_Getswit},				/* 38 = switch	*/
+	{ 0, &Sys_Getswit, SC_LEAN },	/* 38 = switch	*/
 	{ 1, &Sys_Pwd	},				/* 39 = pwd	*/
-	{ 0, &Sys_Nosys	},				/* 40 = nosys	*/
+	{ 2, &Sys_Idlestat},			/* 40 = idlestat	*/
 	{ 1, &Sys_Dup	},				/* 41 = dup		*/
 	{ 1, &Sys_Pipe	},				/* 42 = pipe 	*/
 	{ 1, &Sys_Times	},				/* 43 = times	*/
 	{ 4, &Sys_Profil},				/* 44 = prof	*/
-	{ 0, &Sys_Nosys	},				/* 45 = nosys	*/
+	{ 3, &Sys_Kprof	},				/* 45 = kprof	*/
 	{ 1, &Sys_Setgid},				/* 46 = setgid	*/
-	{ 0, &Sys_Getgid},				/* 47 = getgid	*/
+	{ 0, &Sys_Getgid, SC_LEAN },		/* 47 = getgid	*/
 	{ 2, &Sys_Ssig	},				/* 48 = sig	*/
-	{ 0, &Sys_Nosys	},				/* 49 = nosys	*/
-	{ 0, &Sys_Nosys	},				/* 50 = nosys	*/
-	{ 0, &Sys_Nosys	},				/* 51 = nosys	*/
-	{ 0, &Sys_Nosys	},				/* 52 = nosys	*/
-	{ 0, &Sys_Nosys	},				/* 53 = nosys	*/
-	{ 0, &Sys_Nosys	},				/* 54 = nosys	*/
-	{ 0, &Sys_Nosys	},				/* 55 = nosys	*/
-	{ 0, &Sys_Nosys	},				/* 56 = nosys	*/
-	{ 0, &Sys_Nosys	},				/* 57= nosys	*/
-	{ 0, &Sys_Nosys	},				/* 58 = nosys	*/
-	{ 0, &Sys_Nosys	},				/* 59 = nosys	*/
+	{ 2, &Sys_Swtrace},				/* 49 = swtrace	*/
+	{ 3, &Sys_Ktrace},				/* 50 = ktrace	*/
+	{ 3, &Sys_Klog	},				/* 51 = klog	*/
+	{ 3, &Sys_Poll	},				/* 52 = poll	*/
+	{ 3, &Sys_Fcntl	},				/* 53 = fcntl	*/
+	{ 4, &Sys_Pread	},				/* 54 = pread	*/
+	{ 4, &Sys_Pwrite	},				/* 55 = pwrite	*/
+	{ 3, &Sys_Readv	},				/* 56 = readv	*/
+	{ 3, &Sys_Writev	},				/* 57 = writev	*/
+	{ 3, &Sys_Sendfile	},				/* 58 = sendfile	*/
+	{ 4, &Sys_Getdents	},				/* 59 = getdents	*/
 	{ 0, &Sys_Nosys	},				/* 60 = nosys	*/
 	{ 0, &Sys_Nosys	},				/* 61 = nosys	*/
 	{ 0, &Sys_Nosys	},				/* 62 = nosys	*/
 	{ 0, &Sys_Nosys	},				/* 63 = nosys	*/
 };
 
+/* 
+ * SYSENTER̬ʱCSSSESPEIPMSRĴ䣬жϱرա
+ * int $0x80ʱӲѹջĸʽpt_contextûջָEBPУصַ
+ * EDIУEFLAGSIFλȻжϣתFastCallEntrance()ֳ
+ */
+__asm__("	.text					\n\
+	.globl	sysenter_entry			\n\
+sysenter_entry:						\n\
+	pushl	$0x23					\n\
+	pushl	%ebp					\n\
+	pushfl							\n\
+	orl		$0x200, (%esp)			\n\
+	pushl	$0x1b					\n\
+	pushl	%edi					\n\
+	sti								\n\
+	jmp		sysenter_trap_entrance	\n");
+
 SystemCall::SystemCall()
 {
 	//nothing to do here
@@ -139,10 +159,68 @@ void SystemCall::SystemCallEntrance()
 	InterruptReturn();		/* ˳ж */
 }
 
+void SystemCall::FastCallEntrance()
+{
+	SaveContext();
+
+	SwitchToKernel();
+
+	CallHandler(SystemCall, Trap);
+
+	/* SYSENTERϵͳǰ̬û̬ */
+	while(true)
+	{
+		X86Assembly::CLI();
+		
+		if(Kernel::Instance().GetProcessManager().RunRun > 0)
+		{
+			X86Assembly::STI();
+			Kernel::Instance().GetProcessManager().Swtch();
+		}
+		else
+		{
+			break;
+		}
+	}
+	RestoreContext();
+
+	Leave();
+
+	/* 
+	 * ջʣpt_contextExec()źŴѾдеEIPESP
+	 * SYSEXITEDXΪصַECXΪûջָ룬CSSSȡIA32_SYSENTER_CS + 16+ 24
+	 * Machine::USER_CODE_SEGMENT_SELECTORUSER_DATA_SEGMENT_SELECTORͬ
+	 * ָEFLAGSʱֹжϣSTIЧƳһָSYSEXIT֮ǰжϽ롣
+	 */
+	__asm__ __volatile__("	movl	(%%esp), %%edx;			\
+							movl	12(%%esp), %%ecx;		\
+							andl	$0xFFFFFDFF, 8(%%esp);	\
+							addl	$8, %%esp;				\
+							popfl;							\
+							sti;							\
+							sysexit"::);
+}
+
 void SystemCall::Trap(struct pt_regs* regs, struct pt_context* context)
 {	
 	User& u = Kernel::Instance().GetUser();
+	unsigned int number = regs->eax;
+	SystemCallTableEntry *callp = &m_SystemEntranceTable[number];
 	/* reference: u.u_ar0 = &r0 @line 2701 */
+	u.u_ar0 = &regs->eax;
+
+	TRACE(Trace::TR_SYSCALL, number, 0);
+
+	/* 
+	 * ɣûдźʱSC_LEANϵͳò˯Ҳźš
+	 * u.u_qsavp_cpuֻʱжб仯ʱжϸ㡣
+	 */
+	if ( (callp->flags & SC_LEAN) && 0 == u.u_procp->p_sig )
+	{
+		callp->call();
+		TRACE(Trace::TR_SYSRET, number, regs->eax);
+		return;
+	}
 
 	/* ¼ӽĴ롣ж޽յźţյźӦ */
 	if ( u.u_procp->IsSig() )
@@ -150,22 +228,16 @@ void SystemCall::Trap(struct pt_regs* regs, struct pt_context* context)
 		u.u_procp->PSig(context);
 		u.u_error = User::EINTR;
 		regs->eax = -u.u_error;
+		TRACE(Trace::TR_SYSRET, number, regs->eax);
 		return;
 	}
 
-	u.u_ar0 = &regs->eax;
-
-	if(regs->eax == 20)
-		regs->eax = 20;
-
 	/* 
 	 * տǰһϵͳʧܶõĴ, u.u_error
 	 * ĻĳȫȷںҲ· **!!!!**
 	 */
 	u.u_error = User::NOERROR;
 
-	SystemCallTableEntry *callp = &m_SystemEntranceTable[regs->eax];
-
 	//Diagnose::Write("eax = %d, callp: count = %d, address = %x\n", regs->eax, callp->count, callp->call);
 
 	/* callp->countϵͳõĴӼĴu.u_arg[5] */
@@ -194,6 +266,8 @@ void SystemCall::Trap(struct pt_regs* regs, struct pt_context* context)
 	if ( u.u_intflg != 0 )
 	{
 		u.u_error = User::EINTR;
+		/* ϵʱ˯߻poll()ûлȡԼĶʱ⵽ʱػѽ֮˯ */
+		Time::DelTimer(&u.u_procp->p_timer);
 	}
 
 	/* ע: Unix V6++ϵͳóظûķʽV6(ͨPSWеEBIT)!
@@ -205,7 +279,7 @@ void SystemCall::Trap(struct pt_regs* regs, struct pt_context* context)
 	if( User::NOERROR != u.u_error )
 	{
 		regs->eax = -u.u_error;
-		Diagnose::Write("regs->eax = %d , u.u_error = %d\n",regs->eax,u.u_error);
+		KernelLog::Printf(KernelLog::LOG_DEBUG, "pid %d syscall %d: error %d\n", u.u_procp->p_pid, number, u.u_error);
 	}
 
 	/* ж޽յźţյźӦ */
@@ -216,6 +290,8 @@ void SystemCall::Trap(struct pt_regs* regs, struct pt_context* context)
 
 	/* Trap()ĩβ㵱ǰ */
 	u.u_procp->SetPri();
+
+	TRACE(Trace::TR_SYSRET, number, regs->eax);
 }
 
 void SystemCall::Trap1(int (*func)())
@@ -231,7 +307,7 @@ void SystemCall::Trap1(int (*func)())
 	u.u_intflg = 0;
 }
 
-/*	27, 49 - 63 = nosys		count = 0	*/
+/*	60 - 63 = nosys		count = 0	*/
 int SystemCall::Sys_Nosys()
 {
 	/* δϵͳñִд˿պ */
@@ -519,27 +595,28 @@ int SystemCall::Sys_Trace()
 	return 0;	/* GCC likes it ! */
 }
 
-/*	31 = stty	count = 1	*/
+/*	31 = stty	count = 2	*/
 int SystemCall::Sys_Stty()
 {
 	File* pFile;
 	Inode* pInode;
 	User& u = Kernel::Instance().GetUser();
 	int fd = u.u_arg[0];
-	TTy* pTTy = (TTy *)u.u_arg[1];
+	int flags = u.u_arg[1];
 
 	if ( (pFile = u.u_ofiles.GetF(fd)) == NULL )
 	{
 		return 0;
 	}
 	pInode = pFile->f_inode;
-	if ( (pInode->i_mode & Inode::IFMT) != Inode::IFCHR )
+	if ( NULL == pInode || (pInode->i_mode & Inode::IFMT) != Inode::IFCHR )
 	{
 		u.u_error = User::ENOTTY;
 		return 0;
 	}
 	short dev = pInode->i_addr[0];
-	Kernel::Instance().GetDeviceManager().GetCharDevice(dev).SgTTy(dev, pTTy);
+	/* ùʽԭȵĹʽ */
+	u.u_ar0[User::EAX] = Kernel::Instance().GetDeviceManager().GetCharDevice(Utility::GetMajor(dev)).SgTTy(dev, flags);
 
 	return 0;	/* GCC likes it ! */
 }
@@ -551,20 +628,45 @@ int SystemCall::Sys_Gtty()
 	Inode* pInode;
 	User& u = Kernel::Instance().GetUser();
 	int fd = u.u_arg[0];
-	TTy* pTTy = (TTy *)u.u_arg[1];
 
 	if ( (pFile = u.u_ofiles.GetF(fd)) == NULL )
 	{
 		return 0;
 	}
 	pInode = pFile->f_inode;
-	if ( (pInode->i_mode & Inode::IFMT) != Inode::IFCHR )
+	if ( NULL == pInode || (pInode->i_mode & Inode::IFMT) != Inode::IFCHR )
 	{
 		u.u_error = User::ENOTTY;
 		return 0;
 	}
 	short dev = pInode->i_addr[0];
-	Kernel::Instance().GetDeviceManager().GetCharDevice(dev).SgTTy(dev, pTTy);
+	u.u_ar0[User::EAX] = Kernel::Instance().GetDeviceManager().GetCharDevice(Utility::GetMajor(dev)).SgTTy(dev, -1);
+
+	return 0;	/* GCC likes it ! */
+}
+
+/*	33 = nanosleep	count = 1	*/
+int SystemCall::Sys_Nanosleep()
+{
+	User& u = Kernel::Instance().GetUser();
+	struct timespec* req = (struct timespec*)u.u_arg[0];
+
+	if ( req->tv_sec < 0 || req->tv_nsec < 0 || req->tv_nsec >= 1000000000 )
+	{
+		u.u_error = User::EINVAL;
+		return 0;
+	}
+
+	/* ʱʱжȡΪ˯ʱ */
+	unsigned int sec = req->tv_sec;
+	if ( sec > Time::MAX_DELAY_SECONDS )
+	{
+		sec = Time::MAX_DELAY_SECONDS;
+	}
+
+	/* ȷ룬һʱжڵĲȡ֤˯Ҫʱ */
+	unsigned int msec = (req->tv_nsec + 999999) / 1000000;
+	Time::Delay(sec * Time::HZ + (msec * Time::HZ + 999) / 1000);
 
 	return 0;	/* GCC likes it ! */
 }
@@ -583,38 +685,13 @@ int SystemCall::Sys_Sslep()
 {
 	User& u = Kernel::Instance().GetUser();
 
-	X86Assembly::CLI();
-
-	unsigned int wakeTime = Time::time + u.u_arg[0];	/* sleep(second) */
-
-	/*
-	 *    if ( Time::tout <= Time::time || Time::tout > wakeTime )  жĽͣ
-	 * 1ϵͳǰõӾѵڡ  󣬵һӵĽ̿ tout <= timeԼwaketimeдtout
-	 * 2ϵͳУδڵĽ̡нӣtout > time̱ȶtoutԼwaketimetoutֵнwaketimeСֵ
-	 *
-	 * ԭȵעͣ
-	 * ˴'wakeTime >= Time::time', 򼫶ǰһsleep(sec)ս
-	 * ŵڶsleep(0)ʹwakeTime == Time::time == Time::tout
-	 * ʱʱжǡΪһĩβTime::Clock()Time::time++
-	 * ᵼTime::toutTime::timeС1Զ޷Time::time == Time::tout
-	 * Ļsleep(0)ĽԶ˯ߡ         The end.
-	 *
-	 * ԭȵעͲԡwhileѭж'wakeTime >= Time::time'ִsleep(0)Ľ̽waketimetoutΪϸ롣ʱжϴtime++֮
-	 * 1нӣϵͳӷ̱ˡΪ time==toutԶ޷㣬ʱжϴٻỽκӶ˯Ľ̡
-	 * 2нnewWaketimeִsleep(0)ĽԼwaketime<=newWaketimeĽ̵Ļʱ̽ƳٵnewWaketime
-	 *
-	 * ڵӷȷִsleep(0)Ľ̲˯ʹtoutִֵ
-	 */
-	while( wakeTime > Time::time )
+	/* ʱжΪλýԼĶʱʱ˯߽̹ûʱ̣ʱȡΪ˯ʱ */
+	unsigned int sec = u.u_arg[0];
+	if ( sec > Time::MAX_DELAY_SECONDS )
 	{
-		if ( Time::tout <= Time::time || Time::tout > wakeTime )
-		{
-			Time::tout = wakeTime;
-		}
-		u.u_procp->Sleep((unsigned long)&Time::tout, ProcessManager::PSLEP);
+		sec = Time::MAX_DELAY_SECONDS;
 	}
-
-	X86Assembly::STI();
+	Time::Delay(sec * Time::HZ);
 
 	return 0;	/* GCC likes it ! */
 }
@@ -636,6 +713,182 @@ int SystemCall::Sys_Kill()
 	return 0;	/* GCC likes it ! */
 }
 
+/*	27 = pgstat	count = 1	*/
+int SystemCall::Sys_Pgstat()
+{
+	ProcessManager& procMgr = Kernel::Instance().GetProcessManager();
+	User& u = Kernel::Instance().GetUser();
+
+	struct pgstat* pStat = (struct pgstat *)u.u_arg[0];
+
+	pStat->pgin = procMgr.PgIn;
+	pStat->pgout = procMgr.PgOut;
+	pStat->pgfault = procMgr.PgFault;
+
+	SwapperManager& swapperMgr = Kernel::Instance().GetSwapperManager();
+	pStat->zpgout = swapperMgr.ZPageOut;
+	pStat->zpgin = swapperMgr.ZPageIn;
+	pStat->dpgout = swapperMgr.DiskPageOut;
+	pStat->dpgin = swapperMgr.DiskPageIn;
+	pStat->zorig = swapperMgr.ZOrigBytes;
+	pStat->zcomp = swapperMgr.ZCompBytes;
+	for ( int i = 0; i < SwapperManager::NLATENCY; i++ )
+	{
+		pStat->zlat[i] = swapperMgr.ZLatency[i];
+		pStat->dlat[i] = swapperMgr.DiskLatency[i];
+	}
+
+	return 0;	/* GCC likes it ! */
+}
+
+/*	40 = idlestat	count = 2	*/
+int SystemCall::Sys_Idlestat()
+{
+	User& u = Kernel::Instance().GetUser();
+	struct idlestat* pStat = (struct idlestat *)u.u_arg[0];
+	int mode = u.u_arg[1];
+
+	/* modeΪ01ʱرջʱֹͣʱжϣֵı䣻лӰȫϵͳֻû */
+	if ( 0 == mode || 1 == mode )
+	{
+		if ( !u.SUser() )
+		{
+			return 0;
+		}
+		Time::tickless = mode;
+	}
+
+	X86Assembly::CLI();
+	pStat->hz = Time::HZ;
+	pStat->ticks = Time::ticks;
+	pStat->wakeups = Time::idleWakeups;
+	pStat->idleticks = Time::idleTotal;
+	pStat->tickless = Time::tickless;
+	X86Assembly::STI();
+
+	return 0;	/* GCC likes it ! */
+}
+
+/*	49 = swtrace	count = 2	*/
+int SystemCall::Sys_Swtrace()
+{
+	ProcessManager& procMgr = Kernel::Instance().GetProcessManager();
+	User& u = Kernel::Instance().GetUser();
+
+	struct swtrace* pTrace = (struct swtrace *)u.u_arg[0];
+	unsigned int count = u.u_arg[1];
+
+	/* ʱȺcountлټ¼ʵʸƵ */
+	unsigned int total = procMgr.SwtchTraceCnt;
+	if ( count > total )
+	{
+		count = total;
+	}
+	if ( count > (unsigned int)ProcessManager::NSWTRACE )
+	{
+		count = ProcessManager::NSWTRACE;
+	}
+	for ( unsigned int i = 0; i < count; i++ )
+	{
+		pTrace[i] = procMgr.SwtchTrace[(total - count + i) % ProcessManager::NSWTRACE];
+	}
+
+	u.u_ar0[User::EAX] = count;
+	return 0;	/* GCC likes it ! */
+}
+
+/*	50 = ktrace	count = 3	*/
+int SystemCall::Sys_Ktrace()
+{
+	User& u = Kernel::Instance().GetUser();
+
+	u.u_ar0[User::EAX] = Trace::Control(u.u_arg[0], u.u_arg[1], u.u_arg[2]);
+
+	return 0;	/* GCC likes it ! */
+}
+
+/*	51 = klog	count = 3	*/
+int SystemCall::Sys_Klog()
+{
+	User& u = Kernel::Instance().GetUser();
+
+	u.u_ar0[User::EAX] = KernelLog::Control(u.u_arg[0], (char *)u.u_arg[1], u.u_arg[2]);
+
+	return 0;	/* GCC likes it ! */
+}
+
+/*	52 = poll	count = 3	*/
+int SystemCall::Sys_Poll()
+{
+	FileManager& fileMgr = Kernel::Instance().GetFileManager();
+	fileMgr.Poll();
+
+	return 0;	/* GCC likes it ! */
+}
+
+/*	53 = fcntl	count = 3	*/
+int SystemCall::Sys_Fcntl()
+{
+	FileManager& fileMgr = Kernel::Instance().GetFileManager();
+	fileMgr.Fcntl();
+
+	return 0;	/* GCC likes it ! */
+}
+
+/*	54 = pread	count = 4	*/
+int SystemCall::Sys_Pread()
+{
+	FileManager& fileMgr = Kernel::Instance().GetFileManager();
+	fileMgr.Pread();
+
+	return 0;	/* GCC likes it ! */
+}
+
+/*	55 = pwrite	count = 4	*/
+int SystemCall::Sys_Pwrite()
+{
+	FileManager& fileMgr = Kernel::Instance().GetFileManager();
+	fileMgr.Pwrite();
+
+	return 0;	/* GCC likes it ! */
+}
+
+/*	56 = readv	count = 3	*/
+int SystemCall::Sys_Readv()
+{
+	FileManager& fileMgr = Kernel::Instance().GetFileManager();
+	fileMgr.Readv();
+
+	return 0;	/* GCC likes it ! */
+}
+
+/*	57 = writev	count = 3	*/
+int SystemCall::Sys_Writev()
+{
+	FileManager& fileMgr = Kernel::Instance().GetFileManager();
+	fileMgr.Writev();
+
+	return 0;	/* GCC likes it ! */
+}
+
+/*	58 = sendfile	count = 3	*/
+int SystemCall::Sys_Sendfile()
+{
+	FileManager& fileMgr = Kernel::Instance().GetFileManager();
+	fileMgr.SendFile();
+
+	return 0;	/* GCC likes it ! */
+}
+
+/*	59 = getdents	count = 4	*/
+int SystemCall::Sys_Getdents()
+{
+	FileManager& fileMgr = Kernel::Instance().GetFileManager();
+	fileMgr.GetDents();
+
+	return 0;	/* GCC likes it ! */
+}
+
 /*	38 = switch	count = 0	*/
 int SystemCall::Sys_Getswit()
 {
@@ -691,6 +944,25 @@ int SystemCall::Sys_Times()
 /*	44 = prof	count = 4	*/
 int SystemCall::Sys_Profil()
 {
+	User& u = Kernel::Instance().GetUser();
+
+	/* profil(buf, bufsiz, offset, scale)scaleΪ0ʱر */
+	u.u_prof.pr_base = (char *)u.u_arg[0];
+	u.u_prof.pr_size = u.u_arg[1];
+	u.u_prof.pr_off = u.u_arg[2];
+	u.u_prof.pr_scale = u.u_arg[3];
+	u.u_prof.pr_ticks = 0;
+
+	return 0;	/* GCC likes it ! */
+}
+
+/*	45 = kprof	count = 3	*/
+int SystemCall::Sys_Kprof()
+{
+	User& u = Kernel::Instance().GetUser();
+
+	u.u_ar0[User::EAX] = Profiler::Control(u.u_arg[0], (struct profsample *)u.u_arg[1], u.u_arg[2]);
+
 	return 0;	/* GCC likes it ! */
 }
 
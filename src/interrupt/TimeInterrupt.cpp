@@ -4,10 +4,16 @@
 #include "IOPort.h"
 #include "Chip8259A.h"
 #include "Video.h"
+#include "Profiler.h"
 
 int Time::lbolt = 0;
 unsigned int Time::time = 0;
-unsigned int Time::tout = 0;
+unsigned int Time::ticks = 0;
+TimerWheel Time::wheel;
+int Time::tickless = 1;
+unsigned int Time::idleTicks = 0;
+unsigned int Time::idleWakeups = 0;
+unsigned int Time::idleTotal = 0;
 
 void Time::TimeInterruptEntrance()
 {
@@ -26,6 +32,12 @@ void Time::TimeInterruptEntrance()
 
 	if( context->xcs & USER_MODE ) /*ǰΪû̬*/
 	{
+		/* profil()ļڴ˼ûֱ̬ͼȱҳ */
+		if ( 0 != Kernel::Instance().GetUser().u_prof.pr_ticks )
+		{
+			Profiler::AddUPC();
+		}
+
 		while(true)
 		{
 			X86Assembly::CLI();	/* ȼΪ7 */
@@ -49,27 +61,154 @@ void Time::TimeInterruptEntrance()
 	InterruptReturn();		/* ˳ж */
 }
 
+void Time::AddTimer(Timer* pTimer, unsigned int ticks)
+{
+	pTimer->t_expire = Time::ticks + ticks;
+	Time::wheel.Add(pTimer);
+}
+
+void Time::DelTimer(Timer* pTimer)
+{
+	Time::wheel.Remove(pTimer);
+}
+
+void Time::WakeUp(unsigned long arg)
+{
+	Process* pProcess = (Process*)arg;
+
+	/* ̱źŴϺѲٵȴöʱ */
+	if ( pProcess->IsSleepOn((unsigned long)&pProcess->p_timer) )
+	{
+		pProcess->SetRun();
+	}
+}
+
+void Time::Delay(unsigned int ticks)
+{
+	User& u = Kernel::Instance().GetUser();
+	Process* current = u.u_procp;
+	Timer* pTimer = &current->p_timer;
+
+	pTimer->t_func = Time::WakeUp;
+	pTimer->t_arg = (unsigned long)current;
+	pTimer->t_expire = Time::ticks + ticks;
+
+	while ( (int)(pTimer->t_expire - Time::ticks) > 0 )
+	{
+		/* жֱ˯ߣʱ˯ԭ֮ǰڶʧ */
+		X86Assembly::CLI();
+		Time::wheel.Add(pTimer);
+		current->Sleep((unsigned long)pTimer, ProcessManager::PSLEP);
+	}
+}
+
+void Time::Advance(unsigned int n)
+{
+	Time::ticks += n;
+	Time::lbolt += n;
+	Time::wheel.Run(Time::ticks);
+}
+
+void Time::IdleEnter()
+{
+	unsigned int first;
+
+	if ( 0 == Time::tickless )
+	{
+		return;
+	}
+
+	if ( 0 != Time::idleTicks )
+	{
+		/* ϴǰѺõĵμڽУѾʱжϼ */
+		if ( Chip8253::IsCountDone() )
+		{
+			return;
+		}
+		first = Chip8253::ReadCount();
+	}
+	else
+	{
+		first = Chip8253::Remaining(Time::LATCH);
+	}
+
+	/* һʱжϾжʱڣԭ */
+	unsigned int n = Time::wheel.NextEvent(Time::MAX_IDLE_TICKS) - Time::ticks;
+	if ( n <= 1 )
+	{
+		return;
+	}
+
+	/* ӵǰʣĲֽżıʱжϵλ */
+	Time::idleTicks = n;
+	Chip8253::OneShot(first + (n - 1) * Time::LATCH);
+}
+
+void Time::IdleExit()
+{
+	Time::idleWakeups++;
+
+	/* ʱжϣ򵥴μѽʱжϼClock() */
+	if ( 0 == Time::idleTicks || Chip8253::IsCountDone() )
+	{
+		return;
+	}
+
+	/* 
+	 * жǰѣʣаδʱжceil(left / LATCH)
+	 * ѾʱжϣԵμȵһʱжϣClock()ָԼ
+	 */
+	unsigned int left = Chip8253::ReadCount();
+	unsigned int done = Time::idleTicks - (left + Time::LATCH - 1) / Time::LATCH;
+	unsigned int rest = left % Time::LATCH;
+	if ( 0 == rest )
+	{
+		rest = Time::LATCH;
+	}
+	Chip8253::OneShot(rest);
+	Time::idleTicks = 1;
+
+	Time::idleTotal += done;
+	Time::Advance(done);
+}
+
 void Time::Clock( struct pt_regs* regs, struct pt_context* context )
 {
 	User& u = Kernel::Instance().GetUser();
 	ProcessManager& procMgr = Kernel::Instance().GetProcessManager();
 
+	/* ڼĵμȫʱжϣָʱж */
+	unsigned int elapsed = 1;
+	if ( 0 != Time::idleTicks )
+	{
+		elapsed = Time::idleTicks;
+		Time::idleTicks = 0;
+		Time::idleTotal += elapsed;
+		Chip8253::Init(Time::HZ);
+	}
+
+	/* ͳƲprofil() */
+	Profiler::Clock(regs, context, elapsed);
+
 	/* ϵͳûʱʱǰ̬Ϊû̬modeΪ */
 	if ( (context->xcs & USER_MODE) == USER_MODE )
 	{
-		u.u_utime++;
+		u.u_utime += elapsed;
 	}
 	else
 	{
-		u.u_stime++;
+		u.u_stime += elapsed;
 	}
 
+	/* ƽʱ֣ѵڵʱ˯ִ߽̣еڵں˳ʱ */
+	Time::Advance(elapsed);
+
 	Process* current = u.u_procp;
 	/* 㵱ǰռõCPUʱ */
-	current->p_cpu = Utility::Min(++current->p_cpu, 1024);
+	current->p_cpu = Utility::Min(current->p_cpu + (int)elapsed, 1024);
 
 	/* һĩβǰ̬Ƿн */
-	if ( ++Time::lbolt < HZ )
+	if ( Time::lbolt < HZ )
     	{
 		/* 8259AжϿоƬEOI */
 		    IOPort::OutByte(Chip8259A::MASTER_IO_PORT_1, Chip8259A::EOI);
@@ -98,44 +237,15 @@ void Time::Clock( struct pt_regs* regs, struct pt_context* context )
 	    IOPort::OutByte(Chip8259A::MASTER_IO_PORT_1, Chip8259A::EOI);
 
 
-		if ( Time::time == Time::tout )
-		{
-			/* ʱ˯ߵĽ */
-			procMgr.WakeUpAll((unsigned long)&Time::tout);
-		}
-
-		/* н̵p_time, p_cpu,Լp_pri */
-		for( int i = 0; i < ProcessManager::NPROC; i++ )
-		{
-			Process* pProcess = &procMgr.process[i];
-			if ( pProcess->p_stat != Process::SNULL )
-			{
-				pProcess->p_time = Utility::Min(++pProcess->p_time, 127);
-				
-				if ( pProcess->p_cpu > SCHMAG )
-				{
-					pProcess->p_cpu -= SCHMAG;
-				}
-				else
-				{
-					pProcess->p_cpu = 0;
-				}
-				if ( pProcess->p_pri > ProcessManager::PUSER )
-				{
-					pProcess->SetPri();
-					//Diagnose::Write("PID = %d, p_cpu = %d, p_pri = %d\n", pProcess->p_pid, pProcess->p_cpu, pProcess->p_pri);
-				}
-			}
-		}
+		/* 
+		 * ̵p_time, p_cpu,Լp_priֻ账еĽ̺͵ǰ̣
+		 * ˯̵߽˯ڼ䱣ֲ䣬p_cpu˥ڱʱSetRun()㡣
+		 */
+		procMgr.DecayRunQueue();
+		current->DecayCpu();
 		//Diagnose::Write("curpri = %d\n", procMgr.CurPri);
 		//Diagnose::Write("System Time: %d\n", Time::time);
 		
-		if ( procMgr.RunIn != 0 )
-		{
-			procMgr.RunIn = 0;
-			procMgr.WakeUpAll((unsigned long)&procMgr.RunIn);
-		}
-
 		/* жǰΪû̬ǽźŴ */
 		if ( (context->xcs & USER_MODE) == USER_MODE )
 		{
@@ -0,0 +1,158 @@
+#include "TimerWheel.h"
+#include "Assembly.h"
+#include "Utility.h"
+
+TimerWheel::TimerWheel()
+{
+	for ( int i = 0; i < TVR_SIZE; i++ )
+	{
+		this->m_Root[i].t_next = this->m_Root[i].t_prev = &this->m_Root[i];
+	}
+	for ( int level = 0; level < TVN_LEVELS; level++ )
+	{
+		for ( int i = 0; i < TVN_SIZE; i++ )
+		{
+			this->m_Vec[level][i].t_next = this->m_Vec[level][i].t_prev = &this->m_Vec[level][i];
+		}
+	}
+	this->m_Ticks = 0;
+}
+
+TimerWheel::~TimerWheel()
+{
+}
+
+void TimerWheel::Add(Timer* pTimer)
+{
+	/* ʱжϴ򶼻޸ʱ */
+	unsigned long flags = X86Assembly::SaveFlagsCLI();
+	if ( NULL != pTimer->t_prev )
+	{
+		pTimer->t_prev->t_next = pTimer->t_next;
+		pTimer->t_next->t_prev = pTimer->t_prev;
+	}
+	this->Insert(pTimer);
+	X86Assembly::RestoreFlags(flags);
+}
+
+void TimerWheel::Remove(Timer* pTimer)
+{
+	unsigned long flags = X86Assembly::SaveFlagsCLI();
+	if ( NULL != pTimer->t_prev )
+	{
+		pTimer->t_prev->t_next = pTimer->t_next;
+		pTimer->t_next->t_prev = pTimer->t_prev;
+		pTimer->t_next = NULL;
+		pTimer->t_prev = NULL;
+	}
+	X86Assembly::RestoreFlags(flags);
+}
+
+void TimerWheel::Insert(Timer* pTimer)
+{
+	unsigned int expire = pTimer->t_expire;
+	unsigned int delta = expire - this->m_Ticks;
+	Timer* head;
+
+	if ( (int)delta < 0 )
+	{
+		/* ѾڵĶʱһʱжִ */
+		head = &this->m_Root[this->m_Ticks & (TVR_SIZE - 1)];
+	}
+	else if ( delta < (unsigned int)TVR_SIZE )
+	{
+		head = &this->m_Root[expire & (TVR_SIZE - 1)];
+	}
+	else
+	{
+		/* ҳdeltaһ㣬߲㸲µȫλ */
+		int level = 0;
+		while ( level < TVN_LEVELS - 1 && delta >= (1u << (TVR_BITS + (level + 1) * TVN_BITS)) )
+		{
+			level++;
+		}
+		head = &this->m_Vec[level][(expire >> (TVR_BITS + level * TVN_BITS)) & (TVN_SIZE - 1)];
+	}
+
+	/* β */
+	pTimer->t_next = head;
+	pTimer->t_prev = head->t_prev;
+	head->t_prev->t_next = pTimer;
+	head->t_prev = pTimer;
+}
+
+int TimerWheel::Cascade(int level, int index)
+{
+	Timer* head = &this->m_Vec[level][index];
+	Timer* pTimer = head->t_next;
+
+	/* ժۣеĶʱʱ²룬䵽͵Ĳ */
+	head->t_next = head->t_prev = head;
+	while ( pTimer != head )
+	{
+		Timer* next = pTimer->t_next;
+		this->Insert(pTimer);
+		pTimer = next;
+	}
+	return index;
+}
+
+unsigned int TimerWheel::NextEvent(unsigned int limit)
+{
+	unsigned int t = this->m_Ticks;
+
+	for ( unsigned int k = 1; k < limit; k++, t++ )
+	{
+		Timer* head = &this->m_Root[t & (TVR_SIZE - 1)];
+		if ( head->t_next != head || 0 == (t & (TVR_SIZE - 1)) )
+		{
+			return t;
+		}
+	}
+	return t;
+}
+
+void TimerWheel::Run(unsigned int now)
+{
+	Timer expired;
+
+	while ( (int)(now - this->m_Ticks) >= 0 )
+	{
+		int index = this->m_Ticks & (TVR_SIZE - 1);
+
+		/* 0תһȦϲȡһ۷ɢ² */
+		if ( 0 == index )
+		{
+			for ( int level = 0; level < TVN_LEVELS; level++ )
+			{
+				if ( 0 != this->Cascade(level, (this->m_Ticks >> (TVR_BITS + level * TVN_BITS)) & (TVN_SIZE - 1)) )
+				{
+					break;
+				}
+			}
+		}
+		this->m_Ticks++;
+
+		/* ժ±ʱ̵Ĳۣصöʱ */
+		Timer* head = &this->m_Root[index];
+		if ( head->t_next == head )
+		{
+			continue;
+		}
+		expired.t_next = head->t_next;
+		expired.t_prev = head->t_prev;
+		expired.t_next->t_prev = &expired;
+		expired.t_prev->t_next = &expired;
+		head->t_next = head->t_prev = head;
+
+		while ( expired.t_next != &expired )
+		{
+			Timer* pTimer = expired.t_next;
+			pTimer->t_prev->t_next = pTimer->t_next;
+			pTimer->t_next->t_prev = pTimer->t_prev;
+			pTimer->t_next = NULL;
+			pTimer->t_prev = NULL;
+			pTimer->t_func(pTimer->t_arg);
+		}
+	}
+}
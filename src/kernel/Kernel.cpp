@@ -2,6 +2,8 @@
 #include "Machine.h"
 #include "New.h"
 #include "Video.h"
+#include "Trace.h"
+#include "KernelLog.h"
 
 Kernel Kernel::instance;
 
@@ -71,6 +73,10 @@ void Kernel::InitMemory()
 	this->GetSwapperManager().Initialize();
 	Diagnose::Write("Ok.\n");
 
+	/* ټ¼Ļλ */
+	Trace::Initialize();
+	KernelLog::Initialize();
+
 }
 
 void Kernel::InitProcess()
@@ -0,0 +1,229 @@
+#include "KernelLog.h"
+#include "Kernel.h"
+#include "Assembly.h"
+#include "Machine.h"
+#include "TimeInterrupt.h"
+#include "Video.h"
+
+int KernelLog::ConsoleLevel = KernelLog::DEFAULT_CONSOLE_LEVEL;
+char* KernelLog::ring = NULL;
+unsigned int KernelLog::head = 0;
+unsigned int KernelLog::start = 0;
+
+void KernelLog::Initialize()
+{
+	unsigned long address = Kernel::Instance().GetKernelPageManager().AllocMemory(KernelLog::LOG_SIZE);
+	if ( 0 != address )
+	{
+		KernelLog::ring = (char *)(address + Machine::KERNEL_SPACE_START_ADDRESS);
+	}
+}
+
+/*
+ * ʽbufдַ('\0')ȡͬDiagnose::Write()
+ * va_argָջfmt֮ĵһ
+ */
+int KernelLog::Format(char* buf, int size, const char* fmt, unsigned int* va_arg)
+{
+	static const char Digits[] = "0123456789abcdef";
+	char digits[12];
+	int n = 0;
+
+	for ( ; *fmt && n < size - 1; fmt++ )
+	{
+		if ( '%' != *fmt )
+		{
+			buf[n++] = *fmt;
+			continue;
+		}
+
+		fmt++;
+		if ( 's' == *fmt )
+		{
+			const char* str = (const char *)(*va_arg++);
+			while ( *str && n < size - 1 )
+			{
+				buf[n++] = *str++;
+			}
+		}
+		else if ( 'c' == *fmt )
+		{
+			buf[n++] = (char)(*va_arg++);
+		}
+		else if ( 'd' == *fmt || 'u' == *fmt || 'x' == *fmt )
+		{
+			unsigned int value = *va_arg++;
+			unsigned int base = ( 'x' == *fmt ) ? 16 : 10;
+			int i = 0;
+
+			if ( 'd' == *fmt && (int)value < 0 )
+			{
+				buf[n++] = '-';
+				value = -value;
+			}
+			do
+			{
+				digits[i++] = Digits[value % base];
+				value /= base;
+			} while ( 0 != value );
+			while ( i > 0 && n < size - 1 )
+			{
+				buf[n++] = digits[--i];
+			}
+		}
+		else if ( '\0' == *fmt )
+		{
+			break;
+		}
+		else
+		{
+			buf[n++] = *fmt;
+		}
+	}
+	buf[n] = '\0';
+	return n;
+}
+
+void KernelLog::Printf(int level, const char* fmt, ...)
+{
+	char line[KernelLog::LINE_SIZE];
+	unsigned int ticks = Time::ticks;
+	unsigned int prefix[3];
+	int n;
+
+	/* ǰ׺"<>[.] " */
+	prefix[0] = level;
+	prefix[1] = ticks / Time::HZ;
+	prefix[2] = (ticks % Time::HZ) * 1000 / Time::HZ;
+	n = KernelLog::Format(line, sizeof(line), "<%d>[%u.", prefix);
+	if ( prefix[2] < 100 )
+	{
+		line[n++] = '0';
+	}
+	if ( prefix[2] < 10 )
+	{
+		line[n++] = '0';
+	}
+	n += KernelLog::Format(line + n, sizeof(line) - n, "%u] ", &prefix[2]);
+	int body = n;
+	n += KernelLog::Format(line + n, sizeof(line) - n, fmt, (unsigned int *)&fmt + 1);
+	if ( n > body && '\n' != line[n - 1] )
+	{
+		/* ضϻδԻнβϢϻУ֤азָ */
+		if ( n == (int)sizeof(line) - 1 )
+		{
+			n--;
+		}
+		line[n++] = '\n';
+		line[n] = '\0';
+	}
+
+	if ( NULL != KernelLog::ring )
+	{
+		unsigned long flags = X86Assembly::SaveFlagsCLI();
+		for ( int i = 0; i < n; i++ )
+		{
+			KernelLog::ring[(KernelLog::head + i) & (KernelLog::LOG_SIZE - 1)] = line[i];
+		}
+		KernelLog::head += n;
+		X86Assembly::RestoreFlags(flags);
+	}
+
+	if ( level <= KernelLog::ConsoleLevel )
+	{
+		/* Diagnose::Write()ֻڸʽд */
+		line[n - 1] = '\0';
+		Diagnose::Write("%s\n", line + body);
+	}
+}
+
+int KernelLog::Control(int cmd, char* buf, int len)
+{
+	User& u = Kernel::Instance().GetUser();
+	char chunk[64];
+	unsigned int pos, end, count;
+	int old, n = 0;
+
+	switch ( cmd )
+	{
+	case KLOG_READ:
+		if ( NULL == KernelLog::ring || len < 0 )
+		{
+			u.u_error = User::EINVAL;
+			return -1;
+		}
+		X86Assembly::CLI();
+		end = KernelLog::head;
+		pos = KernelLog::start;
+		if ( end - pos > KernelLog::LOG_SIZE )
+		{
+			pos = end - KernelLog::LOG_SIZE;
+		}
+		if ( end - pos > (unsigned int)len )
+		{
+			pos = end - len;
+		}
+		/* һϢʼ */
+		if ( pos != KernelLog::start )
+		{
+			while ( pos != end && '\n' != KernelLog::ring[(pos - 1) & (KernelLog::LOG_SIZE - 1)] )
+			{
+				pos++;
+			}
+		}
+		X86Assembly::STI();
+
+		/* ֶθƣƵûռʱȱҳܹж */
+		while ( pos != end )
+		{
+			X86Assembly::CLI();
+			if ( KernelLog::head - pos > KernelLog::LOG_SIZE )
+			{
+				/* ȡڼѱϢ */
+				X86Assembly::STI();
+				break;
+			}
+			count = Utility::Min(end - pos, sizeof(chunk));
+			for ( unsigned int i = 0; i < count; i++ )
+			{
+				chunk[i] = KernelLog::ring[(pos + i) & (KernelLog::LOG_SIZE - 1)];
+			}
+			X86Assembly::STI();
+
+			Utility::IOMove((unsigned char *)chunk, (unsigned char *)buf + n, count);
+			pos += count;
+			n += count;
+		}
+		return n;
+
+	case KLOG_CLEAR:
+		if ( !u.SUser() )
+		{
+			return -1;
+		}
+		KernelLog::start = KernelLog::head;
+		return 0;
+
+	case KLOG_CONSOLE:
+		if ( !u.SUser() )
+		{
+			return -1;
+		}
+		if ( len < LOG_EMERG || len > LOG_DEBUG )
+		{
+			u.u_error = User::EINVAL;
+			return -1;
+		}
+		old = KernelLog::ConsoleLevel;
+		KernelLog::ConsoleLevel = len;
+		return old;
+
+	case KLOG_SIZE:
+		count = KernelLog::head - KernelLog::start;
+		return Utility::Min(count, KernelLog::LOG_SIZE);
+
+	default:
+		u.u_error = User::EINVAL;
+		return -1;
+	}
+}
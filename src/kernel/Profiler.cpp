@@ -0,0 +1,119 @@
+#include "Profiler.h"
+#include "Kernel.h"
+#include "Assembly.h"
+#include "Machine.h"
+
+int Profiler::running = 0;
+struct profsample Profiler::buffer[Profiler::NSAMPLE];
+unsigned int Profiler::head = 0;
+unsigned int Profiler::tail = 0;
+unsigned int Profiler::dropped = 0;
+
+void Profiler::Clock(struct pt_regs* regs, struct pt_context* context, unsigned int ticks)
+{
+	User& u = Kernel::Instance().GetUser();
+	bool userMode = ( (context->xcs & USER_MODE) == USER_MODE );
+
+	/* profil()ʱܷûռ䣬ȱҳpcû̬֮ǰ */
+	if ( userMode && 0 != u.u_prof.pr_scale )
+	{
+		u.u_prof.pr_pc = context->eip;
+		u.u_prof.pr_ticks += ticks;
+	}
+
+	if ( 0 == Profiler::running )
+	{
+		return;
+	}
+	if ( Profiler::head - Profiler::tail >= Profiler::NSAMPLE )
+	{
+		Profiler::dropped++;
+		return;
+	}
+
+	struct profsample* pSample = &Profiler::buffer[Profiler::head % Profiler::NSAMPLE];
+	pSample->eip = context->eip;
+	pSample->caller = 0;
+	pSample->pid = u.u_procp->p_pid;
+	pSample->mode = userMode ? 1 : 0;
+	pSample->ticks = ticks;
+
+	/* ںָ֡룬жϺķصַ[EBP + 4]EBPںַ̬ռȡ */
+	unsigned long ebp = regs->ebp;
+	if ( !userMode && ebp >= Machine::KERNEL_SPACE_START_ADDRESS
+		&& ebp < Machine::KERNEL_SPACE_START_ADDRESS + Machine::KERNEL_SPACE_SIZE - 8 && 0 == (ebp & 0x3) )
+	{
+		pSample->caller = *(unsigned long *)(ebp + 4);
+	}
+	Profiler::head++;
+}
+
+int Profiler::Control(int cmd, struct profsample* buf, unsigned int count)
+{
+	User& u = Kernel::Instance().GetUser();
+	unsigned int n = 0;
+	struct profsample sample;
+
+	/* Ϊȫϵͳãʼֹͣȡֻû */
+	if ( (PROF_START == cmd || PROF_STOP == cmd || PROF_READ == cmd) && !u.SUser() )
+	{
+		return -1;
+	}
+
+	switch ( cmd )
+	{
+	case PROF_START:
+		X86Assembly::CLI();
+		Profiler::head = Profiler::tail = 0;
+		Profiler::dropped = 0;
+		Profiler::running = 1;
+		X86Assembly::STI();
+		return 0;
+
+	case PROF_STOP:
+		Profiler::running = 0;
+		return Profiler::dropped;
+
+	case PROF_READ:
+		/* ȡٸƵûռ䣬ʱȱҳܹж */
+		while ( n < count )
+		{
+			X86Assembly::CLI();
+			if ( Profiler::tail == Profiler::head )
+			{
+				X86Assembly::STI();
+				break;
+			}
+			sample = Profiler::buffer[Profiler::tail % Profiler::NSAMPLE];
+			Profiler::tail++;
+			X86Assembly::STI();
+
+			buf[n++] = sample;
+		}
+		return n;
+
+	default:
+		u.u_error = User::EINVAL;
+		return -1;
+	}
+}
+
+void Profiler::AddUPC()
+{
+	User& u = Kernel::Instance().GetUser();
+	unsigned int ticks = u.u_prof.pr_ticks;
+	unsigned int pc = u.u_prof.pr_pc;
+
+	u.u_prof.pr_ticks = 0;
+	if ( 0 == u.u_prof.pr_scale || pc < u.u_prof.pr_off )
+	{
+		return;
+	}
+
+	/* UNIXͬ(pc - pr_off) * pr_scale / 0x10000Ϊֱͼеֽƫƣshort */
+	unsigned int index = (unsigned int)(((unsigned long long)(pc - u.u_prof.pr_off) * u.u_prof.pr_scale) >> 16) & ~1;
+	if ( index + sizeof(short) <= u.u_prof.pr_size )
+	{
+		*(short *)(u.u_prof.pr_base + index) += ticks;
+	}
+}
@@ -0,0 +1,114 @@
+#include "Trace.h"
+#include "Kernel.h"
+#include "Assembly.h"
+#include "Machine.h"
+#include "TimeInterrupt.h"
+
+unsigned int Trace::mask = 0;
+struct tracerec* Trace::ring = NULL;
+unsigned int Trace::size = 0;
+unsigned int Trace::head = 0;
+unsigned int Trace::tail = 0;
+unsigned int Trace::ticks0 = 0;
+unsigned long long Trace::tsc0 = 0;
+
+void Trace::Initialize()
+{
+	unsigned long address = Kernel::Instance().GetKernelPageManager().AllocMemory(Trace::RING_SIZE);
+	if ( 0 != address )
+	{
+		Trace::ring = (struct tracerec *)(address + Machine::KERNEL_SPACE_START_ADDRESS);
+		Trace::size = Trace::RING_SIZE / sizeof(struct tracerec);
+	}
+}
+
+void Trace::Record(unsigned int event, unsigned long arg0, unsigned long arg1)
+{
+	Process* current = Kernel::Instance().GetUser().u_procp;
+
+	unsigned long flags = X86Assembly::SaveFlagsCLI();
+	struct tracerec* pRec = &Trace::ring[Trace::head % Trace::size];
+	Trace::head++;
+	pRec->tsc = X86Assembly::RDTSC();
+	pRec->event = event;
+	pRec->pid = current->p_pid;
+	pRec->arg0 = arg0;
+	pRec->arg1 = arg1;
+	X86Assembly::RestoreFlags(flags);
+}
+
+int Trace::Control(int cmd, unsigned long arg, unsigned int count)
+{
+	User& u = Kernel::Instance().GetUser();
+	struct tracerec rec;
+	struct traceinfo info;
+	unsigned int n = 0;
+
+	/* ʼֹͣټȡ߼¼Ӱȫϵͳֻû */
+	if ( (KTR_START == cmd || KTR_STOP == cmd || KTR_READ == cmd) && !u.SUser() )
+	{
+		return -1;
+	}
+
+	switch ( cmd )
+	{
+	case KTR_START:
+		if ( 0 == Trace::size )
+		{
+			u.u_error = User::ENOMEM;
+			return -1;
+		}
+		X86Assembly::CLI();
+		Trace::head = Trace::tail = 0;
+		Trace::ticks0 = Time::ticks;
+		Trace::tsc0 = X86Assembly::RDTSC();
+		Trace::mask = ( 0 == arg ) ? ~0u : arg;
+		X86Assembly::STI();
+		return 0;
+
+	case KTR_STOP:
+		Trace::mask = 0;
+		return 0;
+
+	case KTR_READ:
+		/* ȡٸƵûռ䣬ʱȱҳܹж */
+		while ( n < count )
+		{
+			X86Assembly::CLI();
+			if ( Trace::head - Trace::tail > Trace::size )
+			{
+				/* δȡߵļ¼ѱ */
+				Trace::tail = Trace::head - Trace::size;
+			}
+			if ( Trace::tail == Trace::head )
+			{
+				X86Assembly::STI();
+				break;
+			}
+			rec = Trace::ring[Trace::tail % Trace::size];
+			Trace::tail++;
+			X86Assembly::STI();
+
+			((struct tracerec *)arg)[n++] = rec;
+		}
+		return n;
+
+	case KTR_INFO:
+		X86Assembly::CLI();
+		info.hz = Time::HZ;
+		info.ticks0 = Trace::ticks0;
+		info.ticks1 = Time::ticks;
+		info.tsc0 = Trace::tsc0;
+		info.tsc1 = X86Assembly::RDTSC();
+		info.total = Trace::head;
+		info.size = Trace::size;
+		X86Assembly::STI();
+
+		*(struct traceinfo *)arg = info;
+		return 0;
+
+	default:
+		u.u_error = User::EINVAL;
+		return -1;
+	}
+}
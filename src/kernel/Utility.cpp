@@ -45,8 +45,13 @@ int Utility::StringLength(char* pString)
 
 void Utility::CopySeg2(unsigned long src, unsigned long des)
 {
+	/* õǰʹõû̬ҳ˽ҳûַ̬ռʱϵͳû̬ҳ */
 	PageTableEntry* userPageTable = (PageTableEntry*)Machine::Instance().GetUserPageTableArray();
-	
+	PageDirectory* pPageDirectory = Kernel::Instance().GetUser().u_MemoryDescriptor.m_PageDirectory;
+	if ( NULL != pPageDirectory && X86Assembly::GetCR3() + Machine::KERNEL_SPACE_START_ADDRESS == (unsigned long)pPageDirectory )
+	{
+		userPageTable = (PageTableEntry*)MemoryDescriptor::GetPageTables(pPageDirectory);
+	}
 
 	/*
 	 * ȱԭû̬һҳڶҳPageTableEntryΪĲ
@@ -61,15 +66,17 @@ void Utility::CopySeg2(unsigned long src, unsigned long des)
 	unsigned char* addressSrc = (unsigned char*)(src % PageManager::PAGE_SIZE);	
 	//ڶҳvirtual addess4096ʼ
 	unsigned char* addressDes = (unsigned char*)(PageManager::PAGE_SIZE + des % PageManager::PAGE_SIZE);	
-	//Ҫˢҳ
-	FlushPageDirectory();
+	//Ҫˢҳ棬ֻϽõҳ
+	X86Assembly::INVLPG(0);
+	X86Assembly::INVLPG(PageManager::PAGE_SIZE);
 
 	*addressDes = *addressSrc;
 	
 	//ָԭҳӳ
 	userPageTable[0].m_PageBaseAddress = oriEntry1;
 	userPageTable[1].m_PageBaseAddress = oriEntry2;
-	FlushPageDirectory();
+	X86Assembly::INVLPG(0);
+	X86Assembly::INVLPG(PageManager::PAGE_SIZE);
 }
 
 void Utility::CopySeg(unsigned long src, unsigned long des)
@@ -89,15 +96,57 @@ void Utility::CopySeg(unsigned long src, unsigned long des)
 	unsigned char* addressSrc = (unsigned char*)(0xC0000000 + borrowedPTE*PageManager::PAGE_SIZE + src % PageManager::PAGE_SIZE);
 
 	unsigned char* addressDes = (unsigned char*)(0xC0000000 + (borrowedPTE + 1)*PageManager::PAGE_SIZE + des % PageManager::PAGE_SIZE);
-	//Ҫˢҳ
-	FlushPageDirectory();
+	//Ҫˢҳ棬̬ҳȫҳҳ
+	X86Assembly::INVLPG(0xC0000000 + borrowedPTE * PageManager::PAGE_SIZE);
+	X86Assembly::INVLPG(0xC0000000 + (borrowedPTE + 1) * PageManager::PAGE_SIZE);
 
 	*addressDes = *addressSrc;
 
 	//ָԭҳӳ
 	PageTable[borrowedPTE].m_PageBaseAddress = oriEntry1;
 	PageTable[(borrowedPTE + 1)].m_PageBaseAddress = oriEntry2;
-	FlushPageDirectory();
+	X86Assembly::INVLPG(0xC0000000 + borrowedPTE * PageManager::PAGE_SIZE);
+	X86Assembly::INVLPG(0xC0000000 + (borrowedPTE + 1) * PageManager::PAGE_SIZE);
+}
+
+void Utility::CopyPage(unsigned long src, unsigned long des)
+{
+	PageTableEntry* PageTable = Machine::Instance().GetKernelPageTable().m_Entrys;
+
+	/* CopySeg()ͬںҳҳֱӳsrcdesҳ */
+	unsigned long oriEntry1 = PageTable[borrowedPTE].m_PageBaseAddress;
+	unsigned long oriEntry2 = PageTable[borrowedPTE + 1].m_PageBaseAddress;
+
+	PageTable[borrowedPTE].m_PageBaseAddress = src / PageManager::PAGE_SIZE;
+	PageTable[borrowedPTE + 1].m_PageBaseAddress = des / PageManager::PAGE_SIZE;
+	X86Assembly::INVLPG(0xC0000000 + borrowedPTE * PageManager::PAGE_SIZE);
+	X86Assembly::INVLPG(0xC0000000 + (borrowedPTE + 1) * PageManager::PAGE_SIZE);
+
+	Utility::DWordCopy((int *)(0xC0000000 + borrowedPTE*PageManager::PAGE_SIZE),
+		(int *)(0xC0000000 + (borrowedPTE + 1)*PageManager::PAGE_SIZE), PageManager::PAGE_SIZE / sizeof(int));
+
+	PageTable[borrowedPTE].m_PageBaseAddress = oriEntry1;
+	PageTable[borrowedPTE + 1].m_PageBaseAddress = oriEntry2;
+	X86Assembly::INVLPG(0xC0000000 + borrowedPTE * PageManager::PAGE_SIZE);
+	X86Assembly::INVLPG(0xC0000000 + (borrowedPTE + 1) * PageManager::PAGE_SIZE);
+}
+
+void Utility::ClearPage(unsigned long address)
+{
+	PageTableEntry* PageTable = Machine::Instance().GetKernelPageTable().m_Entrys;
+
+	unsigned long oriEntry = PageTable[borrowedPTE].m_PageBaseAddress;
+	PageTable[borrowedPTE].m_PageBaseAddress = address / PageManager::PAGE_SIZE;
+	X86Assembly::INVLPG(0xC0000000 + borrowedPTE * PageManager::PAGE_SIZE);
+
+	int* pInt = (int *)(0xC0000000 + borrowedPTE*PageManager::PAGE_SIZE);
+	for ( unsigned int i = 0; i < PageManager::PAGE_SIZE / sizeof(int); i++ )
+	{
+		pInt[i] = 0;
+	}
+
+	PageTable[borrowedPTE].m_PageBaseAddress = oriEntry;
+	X86Assembly::INVLPG(0xC0000000 + borrowedPTE * PageManager::PAGE_SIZE);
 }
 
 short Utility::GetMajor(const short dev)
@@ -212,3 +261,94 @@ unsigned int Utility::DaysInYear( int year )
 {
 	return IsLeapYear(year) ? 366 : 365;
 }
+
+unsigned short Utility::LZHashTable[Utility::LZ_HASH_SIZE];
+
+/* 
+ * ѹʽÿ2ֽڿֿͷ16ֵiλΪ0ʾi1ֽԭģ
+ * Ϊ1ʾi2ֽڵĸ12Ϊݾ(1 ~ 4095)4ΪƳ-3(3 ~ 18)
+ */
+unsigned int Utility::LZCompress(unsigned char* src, unsigned int length, unsigned char* des, unsigned int limit)
+{
+	unsigned int pos = 0;
+	unsigned int outLen = 0;
+
+	while ( pos < length )
+	{
+		/* ֤( + 16)д󲻳limit */
+		if ( outLen + 2 + 16 * 2 > limit )
+		{
+			return 0;
+		}
+
+		unsigned int ctrlPos = outLen;
+		unsigned int flags = 0;
+		outLen += 2;
+
+		for ( unsigned int bit = 0; bit < 16 && pos < length; bit++ )
+		{
+			if ( pos + 3 <= length )
+			{
+				unsigned int hash = ((src[pos] << 8) ^ (src[pos + 1] << 4) ^ src[pos + 2]) * 40543;
+				hash = (hash >> 4) & (LZ_HASH_SIZE - 1);
+				unsigned int cand = Utility::LZHashTable[hash];
+				Utility::LZHashTable[hash] = pos + 1;
+
+				/* ɢбÿѹǰ0λÿһҳֽڱȽȷƥ */
+				if ( cand != 0 && --cand < pos && pos - cand < 4096
+					&& src[cand] == src[pos] && src[cand + 1] == src[pos + 1] && src[cand + 2] == src[pos + 2] )
+				{
+					unsigned int offset = pos - cand;
+					unsigned int matchLen = 3;
+					while ( matchLen < 18 && pos + matchLen < length && src[cand + matchLen] == src[pos + matchLen] )
+					{
+						matchLen++;
+					}
+					des[outLen++] = offset >> 4;
+					des[outLen++] = ((offset & 0xF) << 4) | (matchLen - 3);
+					flags |= (1 << bit);
+					pos += matchLen;
+					continue;
+				}
+			}
+			des[outLen++] = src[pos++];
+		}
+
+		des[ctrlPos] = flags & 0xFF;
+		des[ctrlPos + 1] = flags >> 8;
+	}
+
+	return outLen;
+}
+
+void Utility::LZDecompress(unsigned char* src, unsigned int length, unsigned char* des)
+{
+	unsigned int inPos = 0;
+	unsigned int outPos = 0;
+
+	while ( inPos < length )
+	{
+		unsigned int flags = src[inPos] | (src[inPos + 1] << 8);
+		inPos += 2;
+
+		for ( unsigned int bit = 0; bit < 16 && inPos < length; bit++ )
+		{
+			if ( flags & (1 << bit) )
+			{
+				unsigned int offset = (src[inPos] << 4) | (src[inPos + 1] >> 4);
+				unsigned int matchLen = (src[inPos + 1] & 0xF) + 3;
+				inPos += 2;
+				/* ԴĿص(0)ֽڸ */
+				while ( matchLen-- )
+				{
+					des[outPos] = des[outPos - offset];
+					outPos++;
+				}
+			}
+			else
+			{
+				des[outPos++] = src[inPos++];
+			}
+		}
+	}
+}
@@ -22,6 +22,7 @@
 #include "PEParser.h"
 #include "CMOSTime.h"
 #include "Mouse.h"
+#include "Serial.h"
 #include "..\test\TestInclude.h"
 
 bool isInit = false;
@@ -51,7 +52,7 @@ extern "C" int main0(void)
 	Chip8259A::Init();
 	Chip8259A::IrqEnable(Chip8259A::IRQ_SLAVE);
 
-	Chip8253::Init(60);	//��ʼ��ʱ���ж�оƬ
+	Chip8253::Init(Time::HZ);	//��ʼ��ʱ���ж�оƬ
 	Chip8259A::IrqEnable(Chip8259A::IRQ_TIMER);
 
 	Chip8259A::IrqEnable(Chip8259A::IRQ_KBD);
@@ -78,6 +79,7 @@ extern "C" int main0(void)
 	//init idt
 	machine.InitIDT();	
 	machine.LoadIDT();
+	machine.InitFastSystemCall();
 
 	machine.InitPageDirectory();    // ��ʼ��ҳĿ¼������̬ҳ��
 	machine.InitUserPageTable();     // ��ʼ���û�̬ҳ��
@@ -186,6 +188,12 @@ extern "C" void next()
 	Kernel::Instance().GetProcessManager().SetupProcessZero();
 	isInit = true;
 
+	/* 初始化串口COM1，检测不到UART时不打开IRQ4。放在内核日志环形缓冲区分配之后，启动消息可由dmesg读出 */
+	if ( Serial::Initialize() )
+	{
+		Chip8259A::IrqEnable(Chip8259A::IRQ_COM1);
+	}
+
 	Kernel::Instance().GetFileSystem().LoadSuperBlock();
 	Diagnose::Write("Unix V6++ FileSystem Loaded......OK\n");
 
@@ -203,6 +211,8 @@ extern "C" void next()
 	//us.u_cdir = g_InodeTable.IGet(DeviceManager::ROOTDEV, FileSystem::ROOTINO);
 	us.u_cdir->i_flag &= (~Inode::ILOCK);
 	Utility::StringCopy("/", us.u_curdir);
+	us.u_prof.pr_scale = 0;
+	us.u_prof.pr_ticks = 0;
 
 	/* ��TTy�豸 */
 	int fd_tty = lib_open("/dev/tty1", File::FREAD);
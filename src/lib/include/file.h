@@ -48,4 +48,70 @@ int fstat(int fd,unsigned long statbuf);
 
 int stat(char* pathname,unsigned long statbuf);
 
+/* open()modeдʽ򣺹ܵնݿɶ޿ռдʱ˯ߣread()write()-1 */
+#define O_NONBLOCK	0x800
+
+/* fcntl() */
+#define F_GETFL		3		/* ش򿪷ʽдʽO_NONBLOCK */
+#define F_SETFL		4		/* argO_NONBLOCK */
+
+int fcntl(int fd, int cmd, int arg);
+
+/* readv()writev()һλ */
+struct iovec
+{
+	char* iov_base;		/* ׵ַ */
+	int iov_len;		/* ֽ */
+};
+
+#define IOV_MAX		16		/* һĶ */
+
+/* offsetдƶļĶдָ */
+int pread(int fd, char* buf, int nbytes, int offset);
+
+int pwrite(int fd, char* buf, int nbytes, int offset);
+
+/* ӵǰдλζдiovcntλضдֽ */
+int readv(int fd, struct iovec* iov, int iovcnt);
+
+int writev(int fd, struct iovec* iov, int iovcnt);
+
+/* ںڴin_fdĶдλøcountֽڵout_fdߵĶдλöƣin_fdΪͨļ */
+int sendfile(int out_fd, int in_fd, int count);
+
+/* getdents()صĿ¼Ŀ¼ļе32ֽĿ¼ͬ */
+struct dirent
+{
+	int d_ino;				/* InodeţΪ0 */
+	char d_name[28];		/* ļ28ֽʱ'\0'β */
+};
+
+/* getdents()plusΪ0ʱصĿ¼stat()Ľ */
+struct direntplus
+{
+	struct dirent d_ent;
+	struct st_inode d_stat;
+};
+
+/* Ŀ¼ĶдλȡЧĿ¼дbufоܶstruct dirent(plusΪ0)struct direntplus
+ * дֽĿ¼ʱ0 */
+int getdents(int fd, char* buf, int nbytes, int plus);
+
+/* poll()Ĳ */
+struct pollfd
+{
+	int fd;				/* ļţС0 */
+	short events;		/* ȴ */
+	short revents;		/* ʱ */
+};
+
+#define POLLIN		0x1		/* ݿɶļ */
+#define POLLOUT		0x4		/* д */
+#define POLLERR		0x8		/* ܵѹر */
+#define POLLHUP		0x10	/* ܵдѹر */
+#define POLLNVAL	0x20	/* ļЧ */
+
+/* ȴfdsκһļtimeoutΪС0һֱȴؾļʱ0 */
+int poll(struct pollfd* fds, int nfds, int timeout);
+
 #endif
@@ -80,6 +80,144 @@ int getswtch();
 /* ĻײlinesϢ */
 int trace(int lines);
 
+/* ҳûͳϢ */
+struct pgstat
+{
+	int pgin;		/* ӽҳ */
+	int pgout;		/* ҳ */
+	int pgfault;	/* ȱҳ쳣 */
+	int zpgout;		/* ѹڴ潻صҳ */
+	int zpgin;		/* ڴ潻ؽѹҳ */
+	int dpgout;		/* д̽ҳ */
+	int dpgin;		/* Ӵ̽ҳ */
+	unsigned int zorig;	/* ڴ潻ҳԭʼֽ */
+	unsigned int zcomp;	/* ҳѹֽ */
+	/* ӳٷֲ0С2KʱڣiΪ[2^i K, 2^(i+1) K)ĩӳ */
+	int zlat[12];	/* ڴ潻 */
+	int dlat[12];	/* ̽ */
+};
+
+/* ȡϵͳҳͳϢ */
+int getpgstat(struct pgstat* pstat);
+
+/* лټ¼ */
+struct swtrace
+{
+	unsigned int tsc;		/* лʼʱTSCĵ32λ */
+	int from;				/* ̨pid */
+	int to;					/* ̨pid */
+	unsigned int cycles;	/* Swtch()ʼֳָ̨̻ʱеȴ */
+};
+
+/* ȡcountνлĸټ¼ʱȺУʵʻȡ */
+int swtrace(struct swtrace* buf, int count);
+
+/* ϵͳǷSYSENTERڽںˣʹint $0x80 */
+int fastsyscall();
+
+/* ͳ */
+struct idlestat
+{
+	unsigned int hz;		/* ʱжƵ */
+	unsigned int ticks;		/* ϵͳʱж */
+	unsigned int wakeups;	/* еȴжϻѵĴ */
+	unsigned int idleticks;	/* еȴʱж */
+	int tickless;			/* ʱǷֹͣʱж */
+};
+
+/* ȡͳƣmodeΪ01ʱȹرջʱֹͣʱжϣΪ-1ʱı */
+int idlestat(struct idlestat* pstat, int mode);
+
+/* 
+ * ûֱ̬ͼ˺ÿû̬ʱжϣbufе((pc - offset) * scale / 0x10000) / 2
+ * short1scaleΪ0x10000ʱÿ2ָֽӦһԪΪ0ʱرաexec()Զرա
+ */
+int profil(char* buf, int bufsiz, int offset, int scale);
+
+/* ںͳƲ */
+struct profsample
+{
+	unsigned long eip;		/* жϵַָ */
+	unsigned long caller;	/* ǰ̬Ϊ̬ʱжϺķصַΪ0 */
+	int pid;				/* ǰpid */
+	unsigned short mode;	/* ǰ̬0Ϊ̬1Ϊû̬ */
+	unsigned short ticks;	/* ʱж */
+};
+
+#define PROF_START	1	/* ջʼ */
+#define PROF_STOP	2	/* ֹͣػʱ */
+#define PROF_READ	3	/* ȡcountȡߵĸ */
+
+/* ںͳƲƣbufcountֻPROF_READ */
+int kprof(int cmd, struct profsample* buf, int count);
+
+/* ں˸ټ¼¼arg0arg1ںTrace.h */
+struct tracerec
+{
+	unsigned long long tsc;	/* ¼ʱTSC */
+	unsigned short event;	/* ¼ */
+	short pid;				/* ¼ʱĵǰpid */
+	unsigned long arg0;
+	unsigned long arg1;
+};
+
+/* ״̬TSCʱ */
+struct traceinfo
+{
+	unsigned long long tsc0;	/* ʼʱTSC */
+	unsigned long long tsc1;	/* ǰTSC */
+	unsigned int hz;			/* ʱжƵ */
+	unsigned int ticks0;		/* ʼʱʱжϼ */
+	unsigned int ticks1;		/* ǰʱжϼ */
+	unsigned int total;			/* ʼдļ¼ */
+	unsigned int size;			/* λдļ¼ */
+};
+
+#define TR_SWTCH	1	/* л */
+#define TR_SLEEP	2	/* ˯ */
+#define TR_WAKEUP	3	/*  */
+#define TR_SYSCALL	4	/* ϵͳý */
+#define TR_SYSRET	5	/* ϵͳ÷ */
+#define TR_STRATEGY	6	/* 豸 */
+#define TR_IODONE	7	/* 豸I/O */
+#define TR_SWAPOUT	8	/* ҳ滻 */
+#define TR_SWAPIN	9	/* ҳ滻 */
+
+#define KTR_START	1	/* ջarg¼λͼʼ٣0ʾȫ¼ */
+#define KTR_STOP	2	/* ֹͣ */
+#define KTR_READ	3	/* ȡcount¼argȡߵ */
+#define KTR_INFO	4	/* struct traceinfoƵarg */
+
+/* ں˸ٿ */
+int ktrace(int cmd, void* arg, int count);
+
+/* ں־ϢֵԽСԽ */
+#define LOG_EMERG	0
+#define LOG_ALERT	1
+#define LOG_CRIT	2
+#define LOG_ERR		3
+#define LOG_WARNING	4
+#define LOG_NOTICE	5
+#define LOG_INFO	6
+#define LOG_DEBUG	7
+
+#define KLOG_READ		1	/* lenֽϢbufظƵֽ */
+#define KLOG_CLEAR		2	/* ں־޳û */
+#define KLOG_CONSOLE	3	/* ֻԼ𲻴lenϢĻԭȵļ𣬽޳û */
+#define KLOG_SIZE		4	/* ں־еֽ */
+
+/* ȡں־ÿϢΪ"<>[.] \n" */
+int klog(int cmd, char* buf, int len);
+
+/* ն˹ʽ(sttygtty) */
+#define TTY_ECHO	0x8		/*  */
+#define TTY_RAW		0x20	/* ԭʼʽйַأת */
+
+/* նfdĹʽԭȵĹʽ */
+int stty(int fd, int flags);
+/* նfdĹʽ */
+int gtty(int fd);
+
 
 
 #endif
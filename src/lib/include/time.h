@@ -25,6 +25,16 @@ struct tms
 /* ȡû̬̬CPUʱƬ */
 extern int times(struct tms* ptms);
 
+/* nanosleep()˯ʱ */
+struct timespec
+{
+	int tv_sec;		/*  */
+	int tv_nsec;	/* 룺0 ~ 999999999 */
+};
+
+/* ˯reqָʱȷ룬ʵʱжȡźŴʱ-1 */
+int nanosleep(struct timespec* req);
+
 #define SECONDS_IN_MINUTE (60)
 #define SECONDS_IN_HOUR (3600)
 #define SECONDS_IN_DAY (86400)
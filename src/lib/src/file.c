@@ -1,4 +1,5 @@
 #include "file.h"
+#include "syscall.h"
 
 /*
 ļϵͳcװ
@@ -9,7 +10,7 @@ mode
 int creat(char* pathname, unsigned int mode)
 {
 	int res;
-	__asm__ __volatile__ ( "int $0x80":"=a"(res):"a"(8),"b"(pathname),"c"(mode));
+	__asm__ __volatile__ ( SYSCALL:"=a"(res):"a"(8),"b"(pathname),"c"(mode));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -24,7 +25,7 @@ mode
 int open(char* pathname, unsigned int mode)
 {
 	int res;
-	__asm__ __volatile__ ("int $0x80":"=a"(res):"a"(5),"b"(pathname),"c"(mode));
+	__asm__ __volatile__ (SYSCALL:"=a"(res):"a"(5),"b"(pathname),"c"(mode));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -33,7 +34,7 @@ int open(char* pathname, unsigned int mode)
 int close(int fd)
 {
 	int res;
-	__asm__ __volatile__ ("int $0x80":"=a"(res):"a"(6),"b"(fd));
+	__asm__ __volatile__ (SYSCALL:"=a"(res):"a"(6),"b"(fd));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -49,7 +50,7 @@ nbytes
 int read(int fd, char* buf, int nbytes)
 {
 	int res;
-	__asm__ __volatile__ ("int $0x80":"=a"(res):"a"(3),"b"(fd),"c"(buf),"d"(nbytes));
+	__asm__ __volatile__ (SYSCALL:"=a"(res):"a"(3),"b"(fd),"c"(buf),"d"(nbytes));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -65,7 +66,7 @@ nbytes
 int write(int fd, char* buf, int nbytes)
 {
 	int res;
-	__asm__ __volatile__ ("int $0x80":"=a"(res):"a"(4),"b"(fd),"c"(buf),"d"(nbytes));
+	__asm__ __volatile__ (SYSCALL:"=a"(res):"a"(4),"b"(fd),"c"(buf),"d"(nbytes));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -74,7 +75,7 @@ int write(int fd, char* buf, int nbytes)
 int pipe(int* fildes)
 {
 	int res;
-	__asm__ __volatile__ ( "int $0x80":"=a"(res):"a"(42),"b"(fildes));
+	__asm__ __volatile__ ( SYSCALL:"=a"(res):"a"(42),"b"(fildes));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -92,7 +93,7 @@ fd:
 int seek(int fd,unsigned int offset,unsigned int ptrname)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(19),"b"(fd),"c"(offset),"d"(ptrname));
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(19),"b"(fd),"c"(offset),"d"(ptrname));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -106,7 +107,7 @@ fd
 int dup(int fd)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(41),"b"(fd));
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(41),"b"(fd));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -121,7 +122,7 @@ statbuf: Ŀ
 int fstat(int fd,unsigned long statbuf)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(28),"b"(fd),"c"(statbuf));
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(28),"b"(fd),"c"(statbuf));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -135,7 +136,7 @@ des: Ŀ
 int stat(char* pathname,unsigned long statbuf)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(18),"b"(pathname),"c"(statbuf));
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(18),"b"(pathname),"c"(statbuf));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -149,7 +150,7 @@ mode
 int chmod(char* pathname,unsigned int mode)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(15),"b"(pathname),"c"(mode));
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(15),"b"(pathname),"c"(mode));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -164,7 +165,7 @@ mode
 int chown(char* pathname,short uid, short gid)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(16),"b"(pathname),"c"(uid),"d"(gid));
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(16),"b"(pathname),"c"(uid),"d"(gid));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -179,7 +180,7 @@ newPathname
 int link(char* pathname,char* newPathname)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(9),"b"(pathname),"c"(newPathname));
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(9),"b"(pathname),"c"(newPathname));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -192,7 +193,7 @@ pathname
 int unlink(char* pathname)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(10),"b"(pathname));
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(10),"b"(pathname));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -205,7 +206,7 @@ pathname
 int chdir(char* pathname)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(12),"b"(pathname));
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(12),"b"(pathname));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -220,10 +221,132 @@ dev
 int mknod(char* pathname,unsigned int mode, int dev)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(14),"b"(pathname),"c"(mode),"d"(dev));
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(14),"b"(pathname),"c"(mode),"d"(dev));
 	if ( res >= 0 )
 		return res;
 	return -1;
 }
 
+/*
+ȡôļ־ϵͳcװ
+fdļ
+cmdF_GETFLF_SETFL
+argF_SETFLʱ±־ֻO_NONBLOCKԸı
+ֵF_GETFLش򿪷ʽF_SETFLɹ0ʧܷ-1
+*/
+int fcntl(int fd, int cmd, int arg)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(53),"b"(fd),"c"(cmd),"d"(arg));
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
+
+/*
+λϵͳcװ
+fdļ
+bufݵĻ
+nbytesȡֽ
+offsetļĸƫʼļĶдָ벻
+ֵɹضֽʧܷ-1
+*/
+int pread(int fd, char* buf, int nbytes, int offset)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(54),"b"(fd),"c"(buf),"d"(nbytes),"S"(offset));
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
 
+/*
+λдϵͳcװͬpread
+ֵɹдֽʧܷ-1
+*/
+int pwrite(int fd, char* buf, int nbytes, int offset)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(55),"b"(fd),"c"(buf),"d"(nbytes),"S"(offset));
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
+
+/*
+ɢϵͳcװ
+fdļ
+iov飬ζÿһ
+iovcnt1 ~ IOV_MAX
+ֵɹضֽʧܷ-1
+*/
+int readv(int fd, struct iovec* iov, int iovcnt)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(56),"b"(fd),"c"(iov),"d"(iovcnt));
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
+
+/*
+дϵͳcװͬreadv
+ֵɹдֽʧܷ-1
+*/
+int writev(int fd, struct iovec* iov, int iovcnt)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(57),"b"(fd),"c"(iov),"d"(iovcnt));
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
+
+/*
+ļϵͳcװ
+out_fdĿļţͨļܵ豸
+in_fdԴļţΪͨļ
+countิƵֽ
+ֵɹظƵֽԴļѵβʱ0ʧܷ-1
+*/
+int sendfile(int out_fd, int in_fd, int count)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(58),"b"(out_fd),"c"(in_fd),"d"(count));
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
+
+/*
+Ŀ¼ϵͳcװ
+fdԶʽ򿪵Ŀ¼ļ
+bufĿ¼ĻɾĿ¼
+nbytesֽܷһ
+plusΪ0ʱstruct dirent򷵻ظstat()struct direntplus
+ֵɹдbufֽĿ¼ʱ0ʧܷ-1
+*/
+int getdents(int fd, char* buf, int nbytes, int plus)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(59),"b"(fd),"c"(buf),"d"(nbytes),"S"(plus));
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
+
+/*
+ȴļκһϵͳ
+fdsstruct pollfd飬eventsΪȴʱreventsΪ
+nfds
+timeoutʱС0һֱȴ0ȴ
+ֵļʱ0ʧܷ-1
+*/
+int poll(struct pollfd* fds, int nfds, int timeout)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(52),"b"(fds),"c"(nfds),"d"(timeout));
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
@@ -1,5 +1,68 @@
 #include "sys.h"
 #include "stdlib.h"
+#include "syscall.h"
+
+/*
+ * ϵͳڴ룬sysentryӵãʱEAXΪϵͳúţEBXECXEDXESIΪ
+ * sysentry_fastSYSENTER̬EBPûջָ롢EDIݷصַ
+ * ں˾SYSEXITʱдECXEDXEBPEDIһ𱣴ûջϡ
+ */
+__asm__("	.text				\n\
+sysentry_int80:					\n\
+	int		$0x80				\n\
+	ret							\n\
+sysentry_fast:					\n\
+	pushl	%ecx				\n\
+	pushl	%edx				\n\
+	pushl	%ebp				\n\
+	pushl	%edi				\n\
+	movl	%esp, %ebp			\n\
+	movl	$1f, %edi			\n\
+	sysenter					\n\
+1:								\n\
+	popl	%edi				\n\
+	popl	%ebp				\n\
+	popl	%edx				\n\
+	popl	%ecx				\n\
+	ret							\n\
+sysentry_probe:					\n\
+	pushl	%eax				\n\
+	pushl	%ecx				\n\
+	pushl	%edx				\n\
+	call	sysentry_select		\n\
+	popl	%edx				\n\
+	popl	%ecx				\n\
+	popl	%eax				\n\
+	jmp		*sysentry			\n");
+
+void sysentry_int80() __asm__("sysentry_int80");
+void sysentry_fast() __asm__("sysentry_fast");
+void sysentry_probe() __asm__("sysentry_probe");
+void sysentry_select() __asm__("sysentry_select");
+
+/* ǰʹõϵͳڣһϵͳʱsysentry_probeѡ */
+void (*sysentry)() __asm__("sysentry") = sysentry_probe;
+
+void sysentry_select()
+{
+	/* ںMachine::InitFastSystemCall()жͬCPU֧SYSENTERʱںúMSR */
+	unsigned int eax = 1, ebx, ecx, edx;
+	__asm__ __volatile__("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+	sysentry = sysentry_int80;
+	if ( (edx & (1 << 11)) && !(6 == ((eax >> 8) & 0xF) && ((eax >> 4) & 0xF) < 3 && (eax & 0xF) < 3) )
+	{
+		sysentry = sysentry_fast;
+	}
+}
+
+int fastsyscall()
+{
+	if ( sysentry == sysentry_probe )
+	{
+		sysentry_select();
+	}
+	return sysentry == sysentry_fast;
+}
 
 int execv(char *pathname, char *argv[])
 {
@@ -7,7 +70,7 @@ int execv(char *pathname, char *argv[])
 	int argc = 0;
 	while(argv[argc] != 0)
 		argc++;	
-	__asm__ volatile ( "int $0x80":"=a"(res):"a"(11),"b"(pathname),"c"(argc),"d"(argv));
+	__asm__ volatile ( SYSCALL:"=a"(res):"a"(11),"b"(pathname),"c"(argc),"d"(argv));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -16,7 +79,7 @@ int execv(char *pathname, char *argv[])
 int fork()
 {
 	int res;
-	__asm__ __volatile__ ( "int $0x80":"=a"(res):"a"(2));
+	__asm__ __volatile__ ( SYSCALL:"=a"(res):"a"(2));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -25,7 +88,7 @@ int fork()
 int wait(int* status)	/* ȡӽ̷صReturn Code */
 {
 	int res;
-	__asm__ __volatile__ ( "int $0x80":"=a"(res):"a"(7),"b"(status));
+	__asm__ __volatile__ ( SYSCALL:"=a"(res):"a"(7),"b"(status));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -34,7 +97,7 @@ int wait(int* status)	/* 
 int exit(int status)	/* ӽ̷ظ̵Return Code */
 {
 	int res;
-	__asm__ __volatile__ ( "int $0x80":"=a"(res):"a"(1),"b"(status));
+	__asm__ __volatile__ ( SYSCALL:"=a"(res):"a"(1),"b"(status));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -43,7 +106,7 @@ int exit(int status)	/* 
 int signal(int signal, void (*func)())
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(48),"b"(signal), "c"(func) );
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(48),"b"(signal), "c"(func) );
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -52,7 +115,7 @@ int signal(int signal, void (*func)())
 int kill(int pid, int signal)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(37),"b"(pid), "c"(signal) );
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(37),"b"(pid), "c"(signal) );
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -61,7 +124,7 @@ int kill(int pid, int signal)
 int sleep(unsigned int seconds)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(35),"b"(seconds) );
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(35),"b"(seconds) );
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -72,7 +135,7 @@ extern errno;
 int brk(void * newEndDataAddr)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(17),"b"(newEndDataAddr));
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(17),"b"(newEndDataAddr));
 	/* ϵͳõķֵֵAPPȫֱerrno */
 	if ( res >= 0 )
 		return res;
@@ -84,7 +147,7 @@ int brk(void * newEndDataAddr)
 int syncFileSystem()
 {
 	int res;
-	__asm__ volatile ( "int $0x80":"=a"(res):"a"(36) );
+	__asm__ volatile ( SYSCALL:"=a"(res):"a"(36) );
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -93,7 +156,7 @@ int syncFileSystem()
 int getPath(char *path)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(39),"b"(path));
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(39),"b"(path));
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -102,7 +165,7 @@ int getPath(char *path)
 int getpid()
 {
 	int res;
-	__asm__ volatile ( "int $0x80":"=a"(res):"a"(20) );
+	__asm__ volatile ( SYSCALL:"=a"(res):"a"(20) );
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -111,7 +174,7 @@ int getpid()
 unsigned int getgid()
 {
 	int res;
-	__asm__ volatile ( "int $0x80":"=a"(res):"a"(47) );
+	__asm__ volatile ( SYSCALL:"=a"(res):"a"(47) );
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -120,7 +183,7 @@ unsigned int getgid()
 unsigned int getuid()
 {
 	int res;
-	__asm__ volatile ( "int $0x80":"=a"(res):"a"(24) );
+	__asm__ volatile ( SYSCALL:"=a"(res):"a"(24) );
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -129,7 +192,7 @@ unsigned int getuid()
 int setgid(short gid)
 {
 	int res;
-	__asm__ volatile ( "int $0x80":"=a"(res):"a"(46),"b"(gid) );
+	__asm__ volatile ( SYSCALL:"=a"(res):"a"(46),"b"(gid) );
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -138,7 +201,7 @@ int setgid(short gid)
 int setuid(short uid)
 {
 	int res;
-	__asm__ volatile ( "int $0x80":"=a"(res):"a"(23),"b"(uid) );
+	__asm__ volatile ( SYSCALL:"=a"(res):"a"(23),"b"(uid) );
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -147,7 +210,7 @@ int setuid(short uid)
 int gettime(struct tms* ptms)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(13),"b"(ptms) );
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(13),"b"(ptms) );
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -156,7 +219,7 @@ int gettime(struct tms* ptms)
 int times(struct tms* ptms)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(43),"b"(ptms) );
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(43),"b"(ptms) );
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -165,7 +228,34 @@ int times(struct tms* ptms)
 int getswtch()
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(38) );
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(38) );
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
+
+int getpgstat(struct pgstat* pstat)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(27),"b"(pstat) );
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
+
+int swtrace(struct swtrace* buf, int count)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(49),"b"(buf),"c"(count) );
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
+
+int idlestat(struct idlestat* pstat, int mode)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(40),"b"(pstat),"c"(mode) );
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -174,7 +264,7 @@ int getswtch()
 int trace(int lines)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(29),"b"(lines) );
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(29),"b"(lines) );
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -192,3 +282,57 @@ int sbrk(int increment)
 	fakeedata = newedata + 1;
 	return fakeedata;
 }
+
+int profil(char* buf, int bufsiz, int offset, int scale)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(44),"b"(buf),"c"(bufsiz),"d"(offset),"S"(scale) );
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
+
+int kprof(int cmd, struct profsample* buf, int count)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(45),"b"(cmd),"c"(buf),"d"(count) );
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
+
+int ktrace(int cmd, void* arg, int count)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(50),"b"(cmd),"c"(arg),"d"(count) );
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
+
+int klog(int cmd, char* buf, int len)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(51),"b"(cmd),"c"(buf),"d"(len) );
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
+
+int stty(int fd, int flags)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(31),"b"(fd),"c"(flags) );
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
+
+int gtty(int fd)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(32),"b"(fd) );
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
@@ -0,0 +1,12 @@
+#ifndef SYSCALL_H
+#define SYSCALL_H
+
+/*
+ * ϵͳõָװǶSYSCALL"int $0x80"sysentry
+ * ӵڴ룺һϵͳʱCPUIDѡCPU֧SYSENTERʹÿ
+ * ϵͳڣʹint $0x80ڴ붼ֻдEAXװж
+ * EBXECXEDXESIļĴԼֲ䡣
+ */
+#define SYSCALL "call *sysentry"
+
+#endif
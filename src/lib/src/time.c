@@ -1,9 +1,10 @@
 #include "time.h"
+#include "syscall.h"
 
 unsigned int gtime()
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(13) );
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(13) );
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -12,7 +13,16 @@ unsigned int gtime()
 int stime(unsigned int seconds)
 {
 	int res;
-	__asm__ volatile ("int $0x80":"=a"(res):"a"(25),"b"(seconds) );
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(25),"b"(seconds) );
+	if ( res >= 0 )
+		return res;
+	return -1;
+}
+
+int nanosleep(struct timespec* req)
+{
+	int res;
+	__asm__ volatile (SYSCALL:"=a"(res):"a"(33),"b"(req) );
 	if ( res >= 0 )
 		return res;
 	return -1;
@@ -23,3 +23,48 @@ void Chip8253::Init(int ticks /*= 60*/)
 	 */
 	return;
 }
+
+void Chip8253::OneShot(unsigned int count)
+{
+	if ( count > MAX_COUNT )
+	{
+		count = MAX_COUNT;
+	}
+	IOPort::OutByte(CTRLWRD_PORT, CTRLCMD_SEL0 | CTRLCMD_MODE0 | CTRLCMD_RW );
+	IOPort::OutByte(CNT0_PORT, count % 256 );
+	/* д8λʼ */
+	IOPort::OutByte(CNT0_PORT, count / 256 );
+}
+
+unsigned int Chip8253::ReadCount()
+{
+	unsigned int low, high;
+
+	IOPort::OutByte(CTRLWRD_PORT, CTRLCMD_SEL0 | CTRLCMD_LATCH );
+	low = IOPort::InByte(CNT0_PORT);
+	high = IOPort::InByte(CNT0_PORT);
+	return (high << 8) | low;
+}
+
+unsigned int Chip8253::Remaining(unsigned int latch)
+{
+	unsigned int status, low, high;
+
+	IOPort::OutByte(CTRLWRD_PORT, CTRLCMD_READBACK_ALL );
+	status = IOPort::InByte(CNT0_PORT);
+	low = IOPort::InByte(CNT0_PORT);
+	high = IOPort::InByte(CNT0_PORT);
+
+	/* ʽ3ÿʱڼֵ2ǰΪߵƽΪ͵ƽ */
+	if ( status & STATUS_OUT )
+	{
+		return (((high << 8) | low) + latch) / 2;
+	}
+	return ((high << 8) | low) / 2;
+}
+
+bool Chip8253::IsCountDone()
+{
+	IOPort::OutByte(CTRLWRD_PORT, CTRLCMD_READBACK );
+	return (IOPort::InByte(CNT0_PORT) & STATUS_OUT) != 0;
+}
@@ -5,6 +5,7 @@
 #include "DiskInterrupt.h"
 #include "KeyboardInterrupt.h"
 #include "MouseInterrupt.h"
+#include "SerialInterrupt.h"
 #include "SystemCall.h"
 
 Machine Machine::instance;	/*��̬��ʵ���Ķ���*/
@@ -92,6 +93,8 @@ void Machine::InitIDT()
 	/* ���ü����жϵ��ж��� */
 	this->GetIDT().SetInterruptGate(0x21, (unsigned long)KeyboardInterrupt::KeyboardInterruptEntrance);
 	/* ���������жϵ��ж��� (IRQ12) */
+	this->GetIDT().SetInterruptGate(0x24, (unsigned long)SerialInterrupt::SerialInterruptEntrance);
+
 	this->GetIDT().SetInterruptGate(0x2C, (unsigned long)MouseInterrupt::MouseInterruptEntrance);
 	/* ����IDT�д����ж϶�Ӧ�ж��� */
 	this->GetIDT().SetInterruptGate(0x2E, (unsigned long)DiskInterrupt::DiskInterruptEntrance);
@@ -202,6 +205,8 @@ void Machine::InitPageDirectory()
 		pPageTable->m_Entrys[i].m_Present = 1;
 		pPageTable->m_Entrys[i].m_ReadWriter = 1;
 		pPageTable->m_Entrys[i].m_PageBaseAddress = i;
+		/* 内核页面为全局页，切换地址空间重载CR3时其TLB项不被作废 */
+		pPageTable->m_Entrys[i].m_GlobalPage = 1;
 	}
 
 	this->m_PageDirectory = pPageDirectory;
@@ -286,6 +291,40 @@ void Machine::EnablePageProtection()
 							movl %%cr0, %%eax;	\
 							orl $0x80000000, %%eax;	\
 							movl %%eax, %%cr0" : : "a"(pageDirPhyBaseAddr) );
+
+	/* 若CPU支持全局页(CPUID.01H:EDX第13位PGE)，置位CR4.PGE使内核页面的全局位生效 */
+	unsigned int eax = 1, ebx, ecx, edx;
+	__asm__ __volatile__("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+	if ( edx & (1 << 13) )
+	{
+		__asm__ __volatile__("	movl %%cr4, %%eax;	\
+								orl $0x80, %%eax;	\
+								movl %%eax, %%cr4" : : : "eax" );
+	}
+}
+
+void Machine::InitFastSystemCall()
+{
+	/* CPUID.01H:EDX第11位SEP；Pentium Pro(家族6，型号、步进均小于3)置位了SEP却不支持SYSENTER */
+	unsigned int eax = 1, ebx, ecx, edx;
+	__asm__ __volatile__("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+	if ( 0 == (edx & (1 << 11)) )
+	{
+		return;
+	}
+	if ( 6 == ((eax >> 8) & 0xF) && ((eax >> 4) & 0xF) < 3 && (eax & 0xF) < 3 )
+	{
+		return;
+	}
+
+	/* 
+	 * SYSENTER进入时CS = IA32_SYSENTER_CS，SS为其后一项；SYSEXIT返回时CS、SS分别为其后第2、3项
+	 * 并置RPL为3，与GDT中内核代码段、内核数据段、用户代码段、用户数据段的排列一致。
+	 * 各进程的核心栈都位于核心态地址空间末尾，与TSS中的ESP0相同。
+	 */
+	X86Assembly::WRMSR(Machine::IA32_SYSENTER_CS, Machine::KERNEL_CODE_SEGMENT_SELECTOR);
+	X86Assembly::WRMSR(Machine::IA32_SYSENTER_ESP, 0xC0400000);
+	X86Assembly::WRMSR(Machine::IA32_SYSENTER_EIP, (unsigned long)SystemCall::SysEnterEntry);
 }
 
 IDT& Machine::GetIDT()
@@ -1,7 +1,13 @@
 #include "SwapperManager.h"
+#include "Kernel.h"
+#include "Machine.h"
+#include "Utility.h"
+#include "Assembly.h"
+#include "Trace.h"
 
 unsigned int SwapperManager::SWAPPER_ZONE_START_BLOCK = 18000;
 unsigned int SwapperManager::SWAPPER_ZONE_SIZE = 2000;
+unsigned int SwapperManager::ZPOOL_SIZE = 0x40000;
 
 SwapperManager::SwapperManager(Allocator *pAllocator)
 {
@@ -29,6 +35,50 @@ int SwapperManager::Initialize()
 	this->map[0].m_AddressIdx = SWAPPER_ZONE_START_BLOCK;
 	this->map[0].m_Size = SWAPPER_ZONE_SIZE;
 
+	this->ZPageOut = this->ZPageIn = 0;
+	this->DiskPageOut = this->DiskPageIn = 0;
+	this->ZOrigBytes = this->ZCompBytes = 0;
+	for ( int i = 0; i < NLATENCY; i++ )
+	{
+		this->ZLatency[i] = 0;
+		this->DiskLatency[i] = 0;
+	}
+
+	/* 从核心页区中为内存交换池和压缩缓冲区分配空间，分配不到则只使用磁盘交换区 */
+	KernelPageManager& kernelPgMgr = Kernel::Instance().GetKernelPageManager();
+	this->m_ZPool = 0;
+	this->m_ZBuffer = 0;
+	if ( 0 != ZPOOL_SIZE )
+	{
+		unsigned long pool = kernelPgMgr.AllocMemory(ZPOOL_SIZE);
+		unsigned long buffer = kernelPgMgr.AllocMemory(PageManager::PAGE_SIZE * 2);
+		if ( 0 != pool && 0 != buffer )
+		{
+			this->m_ZPool = pool + Machine::KERNEL_SPACE_START_ADDRESS;
+			this->m_ZBuffer = buffer;
+		}
+		else if ( 0 != pool )
+		{
+			kernelPgMgr.FreeMemory(ZPOOL_SIZE, pool);
+		}
+	}
+
+	for ( unsigned int i = 0; i < SWAPPER_MAP_ARRAY_SIZE; i++ )
+	{
+		this->m_ZMap[i].m_AddressIdx = 0;
+		this->m_ZMap[i].m_Size = 0;
+	}
+	/* 分配单位从1开始编号，Alloc()返回0表示分配失败 */
+	this->m_ZMap[0].m_AddressIdx = 1;
+	this->m_ZMap[0].m_Size = ( 0 != this->m_ZPool ) ? ZPOOL_SIZE / ZCHUNK_SIZE : 0;
+
+	for ( unsigned int i = 0; i < ZNSLOT; i++ )
+	{
+		this->m_ZSlot[i].z_chunk = 0;
+		this->m_ZSlot[i].z_size = 0;
+	}
+	this->m_ZNextSlot = 0;
+
 	return 0;
 }
 
@@ -41,3 +91,119 @@ int SwapperManager::FreeSwap( unsigned long size, int startBlock )
 {
 	return this->m_pAllocator->Free(this->map, ( size + (BLOCK_SIZE - 1) ) / BLOCK_SIZE, startBlock);
 }
+
+int SwapperManager::SwapOutPage( unsigned long frame )
+{
+	unsigned long long start = X86Assembly::RDTSC();
+
+	if ( 0 != this->m_ZPool )
+	{
+		/* m_ZBuffer第一页存放页面原文，第二页存放压缩结果 */
+		unsigned char* page = (unsigned char *)(this->m_ZBuffer + Machine::KERNEL_SPACE_START_ADDRESS);
+		unsigned char* packed = page + PageManager::PAGE_SIZE;
+
+		Utility::CopyPage(frame, this->m_ZBuffer);
+		unsigned int size = Utility::LZCompress(page, PageManager::PAGE_SIZE, packed, ZMAX_SIZE);
+
+		/* 查找空闲ZSlot */
+		int slot = -1;
+		for ( unsigned int n = 0; n < ZNSLOT && 0 != size; n++ )
+		{
+			unsigned int i = (this->m_ZNextSlot + n) % ZNSLOT;
+			if ( 0 == this->m_ZSlot[i].z_size )
+			{
+				slot = i;
+				break;
+			}
+		}
+
+		if ( slot >= 0 )
+		{
+			unsigned long chunk = this->m_pAllocator->Alloc(this->m_ZMap, ( size + (ZCHUNK_SIZE - 1) ) / ZCHUNK_SIZE);
+			if ( 0 != chunk )
+			{
+				Utility::MemCopy((unsigned long)packed, this->m_ZPool + (chunk - 1) * ZCHUNK_SIZE, size);
+				this->m_ZSlot[slot].z_chunk = chunk;
+				this->m_ZSlot[slot].z_size = size;
+				this->m_ZNextSlot = (slot + 1) % ZNSLOT;
+
+				this->ZPageOut++;
+				this->ZOrigBytes += PageManager::PAGE_SIZE;
+				this->ZCompBytes += size;
+				TRACE(Trace::TR_SWAPOUT, ZHANDLE_BASE + slot, X86Assembly::RDTSC() - start);
+				return ZHANDLE_BASE + slot;
+			}
+		}
+	}
+
+	/* 内存交换池已满、未启用或页面不可压缩，写入磁盘交换区 */
+	int blkno = this->AllocSwap(PageManager::PAGE_SIZE);
+	if ( 0 == blkno )
+	{
+		return 0;
+	}
+	/* 写盘出错按交换区空间不足处理，页面留在内存中 */
+	if ( false == Kernel::Instance().GetBufferManager().Swap(blkno, frame, PageManager::PAGE_SIZE, Buf::B_WRITE) )
+	{
+		this->FreeSwap(PageManager::PAGE_SIZE, blkno);
+		return 0;
+	}
+	this->DiskPageOut++;
+	TRACE(Trace::TR_SWAPOUT, blkno, X86Assembly::RDTSC() - start);
+	return blkno;
+}
+
+bool SwapperManager::SwapInPage( int handle, unsigned long frame )
+{
+	unsigned long long start = X86Assembly::RDTSC();
+
+	if ( handle >= (int)ZHANDLE_BASE )
+	{
+		ZSlot* pSlot = &this->m_ZSlot[handle - ZHANDLE_BASE];
+		unsigned char* page = (unsigned char *)(this->m_ZBuffer + Machine::KERNEL_SPACE_START_ADDRESS);
+
+		Utility::LZDecompress((unsigned char *)(this->m_ZPool + (pSlot->z_chunk - 1) * ZCHUNK_SIZE), pSlot->z_size, page);
+		Utility::CopyPage(this->m_ZBuffer, frame);
+
+		this->ZPageIn++;
+		this->RecordLatency(this->ZLatency, X86Assembly::RDTSC() - start);
+		TRACE(Trace::TR_SWAPIN, handle, X86Assembly::RDTSC() - start);
+		return true;
+	}
+
+	if ( false == Kernel::Instance().GetBufferManager().Swap(handle, frame, PageManager::PAGE_SIZE, Buf::B_READ) )
+	{
+		return false;
+	}
+	this->DiskPageIn++;
+	this->RecordLatency(this->DiskLatency, X86Assembly::RDTSC() - start);
+	TRACE(Trace::TR_SWAPIN, handle, X86Assembly::RDTSC() - start);
+	return true;
+}
+
+void SwapperManager::FreeSwapPage( int handle )
+{
+	if ( handle >= (int)ZHANDLE_BASE )
+	{
+		ZSlot* pSlot = &this->m_ZSlot[handle - ZHANDLE_BASE];
+		this->m_pAllocator->Free(this->m_ZMap, ( pSlot->z_size + (ZCHUNK_SIZE - 1) ) / ZCHUNK_SIZE, pSlot->z_chunk);
+		pSlot->z_chunk = 0;
+		pSlot->z_size = 0;
+		return;
+	}
+	this->FreeSwap(PageManager::PAGE_SIZE, handle);
+}
+
+void SwapperManager::RecordLatency( int latency[], unsigned long long cycles )
+{
+	/* 以1K个时钟周期为单位，按2的幂划分区间 */
+	unsigned int kcycles = ( cycles >> 32 ) ? 0xFFFFFFFF : ( (unsigned int)cycles >> 10 );
+	int i = 0;
+
+	while ( kcycles >= 2 && i < NLATENCY - 1 )
+	{
+		kcycles >>= 1;
+		i++;
+	}
+	latency[i]++;
+}
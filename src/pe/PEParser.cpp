@@ -18,82 +18,39 @@ PEParser::PEParser(unsigned long peAddress)
 	this->peAddress = peAddress + 0xC0000000;   // peͷַ
 }
 
-unsigned int PEParser::Relocate(Inode* p_inode, int sharedText)
+unsigned int PEParser::DemandLoad(Text* pText, int sharedText)
 {
-	User& u = Kernel::Instance().GetUser();
-	unsigned long srcAddress, desAddress;
 	unsigned cnt = 0;
-	unsigned int i = 0;
-	unsigned int i0 = 0;
-
-	/* Ժ̹ĶΣļжĶ */
-	PageTable* pUserPageTable = Machine::Instance().GetUserPageTableArray();
-	unsigned int textBegin = this->TextAddress >> 12 , textLength = this->TextSize >> 12;
-	PageTableEntry* pointer = (PageTableEntry *)pUserPageTable;
-
-	/*̹ĶΣĶв0*/
-	if(sharedText == 1)
-		i = 1;      // iǶͷ
-	else
-	{
-		i = 0;
-		// ޸ĶεĶд־Ϊںд׼
-		for (i0 = textBegin; i0 < textBegin + textLength; i0++)
-			pointer[i0].m_ReadWriter = 1;
 
-		FlushPageDirectory();
-	}
-
-    /* ҳִ0bssĳֵ0 */
-	for (; i <= this->BSS_SECTION_IDX; i++ )
+	for ( unsigned int i = 0; i < Text::NSECTION; i++ )
 	{
 		ImageSectionHeader* sectionHeader = &(this->sectionHeaders[i]);
-		int beginVM = sectionHeader->VirtualAddress + ntHeader.OptionalHeader.ImageBase;
-		int size = ((sectionHeader->Misc.VirtualSize + PageManager::PAGE_SIZE - 1)>>12)<<12;
-		int j;
+		unsigned long size = sectionHeader->Misc.VirtualSize;
 
-		for (j=0; j<size; j++)
+		/* ļеЧݲSizeOfRawData.bssһ0 */
+		if ( size > sectionHeader->SizeOfRawData )
 		{
-			unsigned char* b =(unsigned char*)(j + beginVM);
-			*b = 0;
+			size = sectionHeader->SizeOfRawData;
 		}
-	}
 
-	/* ĶΣoptionalļȫֱĳֵ  */
- 	if(sharedText == 1)
-		i = 1;      // iǶͷ
-	else
-	// ޸ĶεĶд־Ϊںд׼
-		i = 0;
-
-	for ( ; i < this->BSS_SECTION_IDX; i++ )
-	{
-		ImageSectionHeader* sectionHeader = &(this->sectionHeaders[i]);
-		srcAddress = sectionHeader->PointerToRawData;
-		desAddress =
-			this->ntHeader.OptionalHeader.ImageBase + sectionHeader->VirtualAddress;
-
-	    u.u_IOParam.m_Base = (unsigned char*)desAddress;
-	    u.u_IOParam.m_Offset = srcAddress;
-	    u.u_IOParam.m_Count = sectionHeader->Misc.VirtualSize;
-
-	    p_inode->ReadI();
-
-		cnt += sectionHeader->Misc.VirtualSize;
+		/* ̹ĶΣTextṹиsectionļ¼ */
+		if ( sharedText == 0 )
+		{
+			pText->x_secaddr[i] = this->ntHeader.OptionalHeader.ImageBase + sectionHeader->VirtualAddress;
+			pText->x_secoff[i] = sectionHeader->PointerToRawData;
+			pText->x_secsize[i] = size;
+		}
+		cnt += size;
 	}
 
-	if(sharedText == 0)
-	{   //ĶҳĻֻ
-		for (i0 = textBegin; i0 < textBegin + textLength; i0++)
-			pointer[i0].m_ReadWriter = 0;
-
-		FlushPageDirectory();
+	if ( sharedText == 0 )
+	{
+		/* ·Ķڴκҳװ */
+		pText->ClearLoaded();
 	}
 
 	KernelPageManager& kpm = Kernel::Instance().GetKernelPageManager();
 	kpm.FreeMemory(PageManager::PAGE_SIZE * 2, (unsigned long)this->sectionHeaders - 0xC0000000 );
-//	kpm.FreeMemory(section_size * ntHeader.FileHeader.NumberOfSections, (unsigned long)this->sectionHeaders - 0xC0000000 );
-//	delete this->sectionHeaders;
 	return 	cnt;
 }
 
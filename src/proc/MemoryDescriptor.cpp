@@ -1,16 +1,57 @@
 #include "MemoryDescriptor.h"
 #include "Kernel.h"
+#include "KernelLog.h"
 #include "PageManager.h"
 #include "Machine.h"
 #include "PageDirectory.h"
 #include "Video.h"
+#include "Utility.h"
 
-void MemoryDescriptor::Initialize()
+bool MemoryDescriptor::Initialize()
 {
 	KernelPageManager& kernelPageManager = Kernel::Instance().GetKernelPageManager();
 	
+	unsigned long pgTableAddress = kernelPageManager.AllocMemory(sizeof(PageTable) * USER_SPACE_PAGE_TABLE_CNT);
+	/* ˽ҳĿ¼û̬ҳ䣬3ҳ */
+	unsigned long pgDirAddress = kernelPageManager.AllocMemory(sizeof(PageDirectory) + sizeof(PageTable) * USER_SPACE_PAGE_TABLE_CNT);
+	if ( 0 == pgTableAddress || 0 == pgDirAddress )
+	{
+		if ( 0 != pgTableAddress )
+		{
+			kernelPageManager.FreeMemory(sizeof(PageTable) * USER_SPACE_PAGE_TABLE_CNT, pgTableAddress);
+		}
+		if ( 0 != pgDirAddress )
+		{
+			kernelPageManager.FreeMemory(sizeof(PageDirectory) + sizeof(PageTable) * USER_SPACE_PAGE_TABLE_CNT, pgDirAddress);
+		}
+		return false;
+	}
+
 	/* m_UserPageTableArrayҪAllocMemory()صڴַ + 0xC0000000 */
-	this->m_UserPageTableArray = (PageTable*)(kernelPageManager.AllocMemory(sizeof(PageTable) * USER_SPACE_PAGE_TABLE_CNT) + Machine::KERNEL_SPACE_START_ADDRESS);
+	this->m_UserPageTableArray = (PageTable*)(pgTableAddress + Machine::KERNEL_SPACE_START_ADDRESS);
+
+	/* 0ԵַӳձClearUserPageTable()ݴжЩҳڽ˽ */
+	int* pInt = (int *)this->m_UserPageTableArray;
+	for ( unsigned int i = 0; i < sizeof(PageTable) * USER_SPACE_PAGE_TABLE_CNT / sizeof(int); i++ )
+	{
+		pInt[i] = 0;
+	}
+
+	this->m_PageDirectory = (PageDirectory*)(pgDirAddress + Machine::KERNEL_SPACE_START_ADDRESS);
+
+	/* ̬հϵͳҳĿ¼̹ͬһź̬ҳںӳ޸Ķн̿ɼ */
+	Utility::DWordCopy((int *)&Machine::Instance().GetPageDirectory(), (int *)this->m_PageDirectory, sizeof(PageDirectory) / sizeof(int));
+
+	unsigned long pageTablePhyAddress = pgDirAddress + sizeof(PageDirectory);
+	for ( unsigned int i = 0; i < USER_SPACE_PAGE_TABLE_CNT; i++ )
+	{
+		this->m_PageDirectory->m_Entrys[i].m_UserSupervisor = 1;
+		this->m_PageDirectory->m_Entrys[i].m_Present = 1;
+		this->m_PageDirectory->m_Entrys[i].m_ReadWriter = 1;
+		this->m_PageDirectory->m_Entrys[i].m_PageTableBaseAddress = (pageTablePhyAddress >> 12) + i;
+	}
+	this->MapToPageTable(NULL);
+	return true;
 }
 
 void MemoryDescriptor::Release()
@@ -21,6 +62,17 @@ void MemoryDescriptor::Release()
 		kernelPageManager.FreeMemory(sizeof(PageTable) * USER_SPACE_PAGE_TABLE_CNT, (unsigned long)this->m_UserPageTableArray - Machine::KERNEL_SPACE_START_ADDRESS);
 		this->m_UserPageTableArray = NULL;
 	}
+	if ( this->m_PageDirectory )
+	{
+		/* ͷʹõҳĿ¼֮ǰлϵͳҳĿ¼ */
+		unsigned long pgDirAddress = (unsigned long)this->m_PageDirectory - Machine::KERNEL_SPACE_START_ADDRESS;
+		this->m_PageDirectory = NULL;
+		if ( X86Assembly::GetCR3() == pgDirAddress )
+		{
+			this->LoadPageDirectory();
+		}
+		kernelPageManager.FreeMemory(sizeof(PageDirectory) + sizeof(PageTable) * USER_SPACE_PAGE_TABLE_CNT, pgDirAddress);
+	}
 }
 
 unsigned int MemoryDescriptor::MapEntry(unsigned long virtualAddress, unsigned int size, unsigned long phyPageIdx, bool isReadWrite)
@@ -56,6 +108,202 @@ void MemoryDescriptor::MapStackEntrys(unsigned long stackSize, unsigned long sta
 	this->MapEntry(stackStartAddress, stackSize, stackPageIdx, true);
 }
 
+void MemoryDescriptor::MapPrivateEntrys(unsigned long virtualAddress, unsigned int size)
+{
+	unsigned long startIdx = (virtualAddress - USER_SPACE_START_ADDRESS) >> 12;
+	unsigned long cnt = ( size + (PageManager::PAGE_SIZE - 1) )/ PageManager::PAGE_SIZE;
+
+	PageTableEntry* entrys = (PageTableEntry*)this->m_UserPageTableArray;
+	for ( unsigned int i = startIdx; i < startIdx + cnt; i++ )
+	{
+		/* ԭݶΡջεҳ汣ֲ䣬פڴ桢ڽϻδװ */
+		if ( 1 == entrys[i].m_Present && 1 == entrys[i].m_ReadWriter )
+		{
+			continue;
+		}
+		/* ҳʱҳ״ηʱȱҳ쳣װ0 */
+		entrys[i].m_Present = 0x1;
+		entrys[i].m_ReadWriter = 0x1;
+		entrys[i].m_ForSystemUser = PG_DEMAND;
+		entrys[i].m_PageBaseAddress = 0;
+	}
+}
+
+void MemoryDescriptor::ReleaseEntry(PageTableEntry* entry)
+{
+	ProcessManager& procMgr = Kernel::Instance().GetProcessManager();
+	User& u = Kernel::Instance().GetUser();
+
+	/* ֻݶΡջҳΪ˽УĶҳTextṹ */
+	if ( 0 == entry->m_Present || 0 == entry->m_ReadWriter )
+	{
+		return;
+	}
+	/* ҳûػڻҳ棬ȴ */
+	while ( entry->m_ForSystemUser & PG_BUSY )
+	{
+		u.u_procp->Sleep((unsigned long)&procMgr.PgOut, ProcessManager::PSWP);
+	}
+
+	if ( entry->m_ForSystemUser & PG_SWAP )
+	{
+		Kernel::Instance().GetSwapperManager().FreeSwapPage(entry->m_PageBaseAddress);
+	}
+	else if ( (entry->m_ForSystemUser & PG_DEMAND) == 0 )
+	{
+		Kernel::Instance().GetUserPageManager().FreeMemory(PageManager::PAGE_SIZE, entry->m_PageBaseAddress * PageManager::PAGE_SIZE);
+	}
+	entry->m_Present = 0;
+	entry->m_ReadWriter = 0;
+	entry->m_ForSystemUser = 0;
+	entry->m_PageBaseAddress = 0;
+}
+
+bool MemoryDescriptor::DemandPage(unsigned long address)
+{
+	User& u = Kernel::Instance().GetUser();
+	ProcessManager& procMgr = Kernel::Instance().GetProcessManager();
+	Text* pText = u.u_procp->p_textp;
+
+	if ( address >= USER_SPACE_SIZE || NULL == this->m_UserPageTableArray || NULL == this->m_PageDirectory )
+	{
+		return false;
+	}
+
+	unsigned long virtualAddress = address & ~(PageManager::PAGE_SIZE - 1);
+	unsigned int idx = (virtualAddress - USER_SPACE_START_ADDRESS) >> 12;
+	PageTableEntry* entry = &((PageTableEntry*)this->m_UserPageTableArray)[idx];
+	PageTableEntry* pte = &((PageTableEntry*)MemoryDescriptor::GetPageTables(this->m_PageDirectory))[idx];
+
+	/* ڽͼҳ棬ҳѾڴ(д쳣) */
+	if ( 0 == entry->m_Present || 1 == pte->m_Present )
+	{
+		return false;
+	}
+	/* ĶҳҪTextṹפڴݶΡջҳ治Ӧȱҳ */
+	if ( (0 == entry->m_ReadWriter && NULL == pText)
+		|| (1 == entry->m_ReadWriter && (entry->m_ForSystemUser & (PG_DEMAND | PG_SWAP)) == 0) )
+	{
+		return false;
+	}
+	procMgr.PgFault++;
+
+	/* ҳڱȴִзָٴȱҳʱӽ */
+	if ( entry->m_ForSystemUser & PG_BUSY )
+	{
+		u.u_procp->Sleep((unsigned long)&procMgr.PgOut, ProcessManager::PSWP);
+		return true;
+	}
+
+	/* ӽҳ档ֻнỻ롢ͷҳ棬ػֻפҳ棬˯ڼҳı */
+	if ( 1 == entry->m_ReadWriter && (entry->m_ForSystemUser & PG_SWAP) )
+	{
+		unsigned long frame = procMgr.AllocUserMemory(PageManager::PAGE_SIZE);
+		int handle = entry->m_PageBaseAddress;
+
+		/* ҳڴ潻УҲڴ̽ */
+		if ( false == Kernel::Instance().GetSwapperManager().SwapInPage(handle, frame) )
+		{
+			/* ҳѶʧͬװĶҳӳ0ҳ̷SIGKILL */
+			Utility::ClearPage(frame);
+			KernelLog::Printf(KernelLog::LOG_ERR, "pid %d: swap I/O error on page %x, killed\n", u.u_procp->p_pid, virtualAddress);
+			u.u_procp->PSignal(User::SIGKILL);
+		}
+		Kernel::Instance().GetSwapperManager().FreeSwapPage(handle);
+		procMgr.PgIn++;
+
+		X86Assembly::CLI();
+		entry->m_ForSystemUser &= ~PG_SWAP;
+		entry->m_Accessed = 1;
+		entry->m_PageBaseAddress = frame / PageManager::PAGE_SIZE;
+		pte->m_ReadWriter = 1;
+		pte->m_Accessed = 0;
+		pte->m_PageBaseAddress = entry->m_PageBaseAddress;
+		pte->m_Present = 1;
+		X86Assembly::INVLPG(virtualAddress);
+		X86Assembly::STI();
+		return true;
+	}
+
+	/* Ķҳװ룬ֻڱҳнӳ */
+	if ( 0 == entry->m_ReadWriter && pText->IsLoaded(entry->m_PageBaseAddress) )
+	{
+		X86Assembly::CLI();
+		pte->m_ReadWriter = 0;
+		pte->m_Accessed = 0;
+		pte->m_PageBaseAddress = entry->m_PageBaseAddress + (pText->x_caddr >> 12);
+		pte->m_Present = 1;
+		X86Assembly::INVLPG(virtualAddress);
+		X86Assembly::STI();
+		return true;
+	}
+
+	/* 
+	 * Ķҳ棬ԼδװݶΡջҳ棺ȶ̬ʱҳ棬ҳƵҳ
+	 * ReadI()ڼ̿˯ߣҲĶεĽװͬһҳ棬֮ǰ¼顣
+	 */
+	KernelPageManager& kernelPgMgr = Kernel::Instance().GetKernelPageManager();
+	unsigned long bounce = kernelPgMgr.AllocMemory(PageManager::PAGE_SIZE);
+	if ( 0 == bounce )
+	{
+		return false;
+	}
+	bool ok = true;
+	if ( NULL != pText )
+	{
+		ok = pText->ReadPage(virtualAddress, (unsigned char *)(bounce + Machine::KERNEL_SPACE_START_ADDRESS));
+	}
+	else
+	{
+		Utility::ClearPage(bounce);
+	}
+
+	/* 
+	 * ̷̳SIGKILL̬ȱҳʱ̿ܳInodeȵܾ͵
+	 * ֹӳݲҳϵͳɣTrap()û̬ǰֹ̣
+	 * û̬ȱҳException::PageFault()źš
+	 */
+	if ( !ok )
+	{
+		KernelLog::Printf(KernelLog::LOG_ERR, "pid %d: I/O error loading page %x, killed\n", u.u_procp->p_pid, virtualAddress);
+		u.u_procp->PSignal(User::SIGKILL);
+	}
+
+	if ( 0 == entry->m_ReadWriter )		/* Ķҳ */
+	{
+		if ( !pText->IsLoaded(entry->m_PageBaseAddress) )
+		{
+			Utility::CopyPage(bounce, pText->x_caddr + entry->m_PageBaseAddress * PageManager::PAGE_SIZE);
+			/* ݲҳ治Ϊװ룬ȱҳʱ¶ */
+			if ( ok )
+			{
+				pText->SetLoaded(entry->m_PageBaseAddress);
+			}
+		}
+		X86Assembly::CLI();
+		pte->m_ReadWriter = 0;
+		pte->m_PageBaseAddress = entry->m_PageBaseAddress + (pText->x_caddr >> 12);
+	}
+	else	/* ˽еݶΡջҳ */
+	{
+		unsigned long frame = procMgr.AllocUserMemory(PageManager::PAGE_SIZE);
+		Utility::CopyPage(bounce, frame);
+		X86Assembly::CLI();
+		entry->m_ForSystemUser &= ~PG_DEMAND;
+		entry->m_Accessed = 1;
+		entry->m_PageBaseAddress = frame / PageManager::PAGE_SIZE;
+		pte->m_ReadWriter = 1;
+		pte->m_PageBaseAddress = entry->m_PageBaseAddress;
+	}
+	pte->m_Accessed = 0;
+	pte->m_Present = 1;
+	X86Assembly::INVLPG(virtualAddress);
+	X86Assembly::STI();
+
+	kernelPgMgr.FreeMemory(PageManager::PAGE_SIZE, bounce);
+	return true;
+}
+
 PageTable* MemoryDescriptor::GetUserPageTableArray()
 {
 	return this->m_UserPageTableArray;
@@ -89,33 +337,43 @@ bool MemoryDescriptor::EstablishUserPageTable( unsigned long textVirtualAddress,
 	if ( textSize + dataSize + stackSize  + PageManager::PAGE_SIZE > USER_SPACE_SIZE - textVirtualAddress)
 	{
 		u.u_error = User::ENOMEM;
-		Diagnose::Write("u.u_error = %d\n",u.u_error);
+		KernelLog::Printf(KernelLog::LOG_WARNING, "pid %d: image exceeds user space\n", u.u_procp->p_pid);
 		return false;
 	}
 
-	this->ClearUserPageTable();
+	unsigned long dataBegin = (dataVirtualAddress - USER_SPACE_START_ADDRESS) >> 12;
+	unsigned long dataEnd = dataBegin + ( dataSize + (PageManager::PAGE_SIZE - 1) ) / PageManager::PAGE_SIZE;
+	unsigned long stackStartAddress = (USER_SPACE_START_ADDRESS + USER_SPACE_SIZE - stackSize) & 0xFFFFF000;
+	unsigned long stackBegin = (stackStartAddress - USER_SPACE_START_ADDRESS) >> 12;
 
-	/* ҳƫphyPageIndex == 0ΪĶνԵַӳձ */
-	unsigned int phyPageIndex = 0;
-	phyPageIndex = this->MapEntry(textVirtualAddress, textSize, phyPageIndex, false);
+	/* ͷŲݶΡջε˽ҳ棬brk()Сݶ */
+	PageTableEntry* entrys = (PageTableEntry*)this->m_UserPageTableArray;
+	for ( unsigned int i = 0; i < Machine::USER_PAGE_TABLE_CNT * PageTable::ENTRY_CNT_PER_PAGETABLE; i++ )
+	{
+		if ( (i < dataBegin || i >= dataEnd) && i < stackBegin )
+		{
+			this->ReleaseEntry(&entrys[i]);
+			entrys[i].m_Present = 0;
+			entrys[i].m_UserSupervisor = 1;
+		}
+	}
 
-	/* ʼַphyPageIndexΪ1ppdaռ1ҳ4KСڴ棬ΪݶνԵַӳձ */
-	phyPageIndex = 1;
-	phyPageIndex = this->MapEntry(dataVirtualAddress, dataSize, phyPageIndex, true);
+	/* ҳƫphyPageIndex == 0ΪĶνԵַӳձ */
+	this->MapEntry(textVirtualAddress, textSize, 0, false);
 
-	/* ݶ֮ΪջνԵַӳձ */
-	unsigned long stackStartAddress = (USER_SPACE_START_ADDRESS + USER_SPACE_SIZE - stackSize) & 0xFFFFF000;
-	this->MapEntry(stackStartAddress, stackSize, phyPageIndex, true);
+	/* ݶΡջҳΪ˽УҳֱӼ¼ҳţҳ水 */
+	this->MapPrivateEntrys(dataVirtualAddress, dataSize);
+	this->MapPrivateEntrys(stackStartAddress, USER_SPACE_SIZE - stackStartAddress);
 
-	/* ԵַӳձĶκݶڴеʼַpText->x_caddrp_addrû̬ڴҳӳ */
-	this->MapToPageTable();
+	/* ԵַӳձĶڴеʼַpText->x_caddrؽ˽еû̬ҳ */
+	this->MapToPageTable(u.u_procp->p_textp);
+	this->LoadPageDirectory();
 	return true;
 }
 
 void MemoryDescriptor::ClearUserPageTable()
 {
-	User& u = Kernel::Instance().GetUser();
-	PageTable* pUserPageTable = u.u_MemoryDescriptor.m_UserPageTableArray;
+	PageTable* pUserPageTable = this->m_UserPageTableArray;
 
 	unsigned int i ;
 	unsigned int j ;
@@ -124,13 +382,20 @@ void MemoryDescriptor::ClearUserPageTable()
 	{
 		for (j = 0; j < PageTable::ENTRY_CNT_PER_PAGETABLE; j++ )
 		{
+			/* ͷŽ˽ҳռõҳ򽻻ռ */
+			this->ReleaseEntry(&pUserPageTable[i].m_Entrys[j]);
 			pUserPageTable[i].m_Entrys[j].m_Present = 0;
 			pUserPageTable[i].m_Entrys[j].m_ReadWriter = 0;
 			pUserPageTable[i].m_Entrys[j].m_UserSupervisor = 1;
+			pUserPageTable[i].m_Entrys[j].m_Accessed = 0;
+			pUserPageTable[i].m_Entrys[j].m_ForSystemUser = 0;
 			pUserPageTable[i].m_Entrys[j].m_PageBaseAddress = 0;
 		}
 	}
 
+	/* û̬ҳָͷҳҳ */
+	this->MapToPageTable(NULL);
+	this->LoadPageDirectory();
 }
 
 void MemoryDescriptor::DisplayPageTable()
@@ -146,8 +411,12 @@ void MemoryDescriptor::DisplayPageTable()
 
 	Diagnose::Write("<PPDA,%x>  ",Machine::Instance().GetKernelPageTable().m_Entrys[1023].m_PageBaseAddress);
 
-	PageTable* pUserPageTable = Machine::Instance().GetUserPageTableArray();
-	Diagnose::Write("System PT:");
+	if ( NULL == this->m_PageDirectory )
+	{
+		return;
+	}
+	PageTable* pUserPageTable = MemoryDescriptor::GetPageTables(this->m_PageDirectory);
+	Diagnose::Write("Process HW PT:");
 	for (i = 0; i < Machine::USER_PAGE_TABLE_CNT; i++)
 		for ( j = 0; j < PageTable::ENTRY_CNT_PER_PAGETABLE; j++)
 			if ( 1 == pUserPageTable[i].m_Entrys[j].m_Present )
@@ -155,41 +424,51 @@ void MemoryDescriptor::DisplayPageTable()
 	Diagnose::Write("\n");
 }
 
-void MemoryDescriptor::MapToPageTable()
+void MemoryDescriptor::MapToPageTable(Text* pText)
 {
-	User& u = Kernel::Instance().GetUser();
-
-	if(u.u_MemoryDescriptor.m_UserPageTableArray == NULL)
+	if ( NULL == this->m_UserPageTableArray || NULL == this->m_PageDirectory )
 		return;
 
-	PageTable* pUserPageTable = Machine::Instance().GetUserPageTableArray();
+	PageTable* pUserPageTable = MemoryDescriptor::GetPageTables(this->m_PageDirectory);
 	unsigned int textPF = 0;
-	if ( u.u_procp->p_textp != NULL )
+	if ( pText != NULL )
 	{
-		textPF = u.u_procp->p_textp->x_caddr >> 12;
+		textPF = pText->x_caddr >> 12;
 	}
 
-	unsigned int pAddrPF = u.u_procp->p_addr >> 12;
-
 	for (unsigned int i = 0; i < Machine::USER_PAGE_TABLE_CNT; i++)
 	{
 		for ( unsigned int j = 0; j < PageTable::ENTRY_CNT_PER_PAGETABLE; j++ )
 		{
 			pUserPageTable[i].m_Entrys[j].m_Present = 0;   // 0ʾ߼ҳ
+			pUserPageTable[i].m_Entrys[j].m_UserSupervisor = 1;
 
 			if ( 1 == this->m_UserPageTableArray[i].m_Entrys[j].m_Present )
 			{
 				if ( 0 == this->m_UserPageTableArray[i].m_Entrys[j].m_ReadWriter )      // RO߼ҳ
 				{
+					/* δӿִļװĶҳ汣ֲڣȱҳ쳣װ */
+					if ( NULL == pText || !pText->IsLoaded(this->m_UserPageTableArray[i].m_Entrys[j].m_PageBaseAddress) )
+					{
+						continue;
+					}
 					pUserPageTable[i].m_Entrys[j].m_Present = 1;
 					pUserPageTable[i].m_Entrys[j].m_ReadWriter = 0;
+					pUserPageTable[i].m_Entrys[j].m_Accessed = 0;
 					pUserPageTable[i].m_Entrys[j].m_PageBaseAddress = this->m_UserPageTableArray[i].m_Entrys[j].m_PageBaseAddress + textPF;
 				}
 				else if ( 1 == this->m_UserPageTableArray[i].m_Entrys[j].m_ReadWriter )    // RW߼ҳ
 				{
+					/* δװ롢ѱݶΡջҳֲͬ */
+					if ( this->m_UserPageTableArray[i].m_Entrys[j].m_ForSystemUser & (PG_DEMAND | PG_SWAP) )
+					{
+						continue;
+					}
+					/* ˽ҳҳм¼ľҳţλҳûػֱû̬ҳм */
 					pUserPageTable[i].m_Entrys[j].m_Present = 1;
 					pUserPageTable[i].m_Entrys[j].m_ReadWriter = 1;
-					pUserPageTable[i].m_Entrys[j].m_PageBaseAddress = this->m_UserPageTableArray[i].m_Entrys[j].m_PageBaseAddress + pAddrPF;
+					pUserPageTable[i].m_Entrys[j].m_Accessed = 0;
+					pUserPageTable[i].m_Entrys[j].m_PageBaseAddress = this->m_UserPageTableArray[i].m_Entrys[j].m_PageBaseAddress;
 				}
 			}
 		}
@@ -198,7 +477,14 @@ void MemoryDescriptor::MapToPageTable()
 	pUserPageTable[0].m_Entrys[0].m_Present = 1;
 	pUserPageTable[0].m_Entrys[0].m_ReadWriter = 1;
 	pUserPageTable[0].m_Entrys[0].m_PageBaseAddress = 0;
-
-	FlushPageDirectory();
 }
 
+void MemoryDescriptor::LoadPageDirectory()
+{
+	unsigned long pgDirAddress = Machine::PAGE_DIRECTORY_BASE_ADDRESS;
+	if ( NULL != this->m_PageDirectory )
+	{
+		pgDirAddress = (unsigned long)this->m_PageDirectory - Machine::KERNEL_SPACE_START_ADDRESS;
+	}
+	X86Assembly::LoadCR3(pgDirAddress);
+}
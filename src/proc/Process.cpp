@@ -4,6 +4,9 @@
 #include "Utility.h"
 #include "Machine.h"
 #include "Video.h"
+#include "TimeInterrupt.h"
+#include "Trace.h"
+#include "KernelLog.h"
 
 
 Process::Process()
@@ -12,6 +15,18 @@ Process::Process()
 	this->p_stat = SNULL;
 	/* 0#Wait()ʱprocess0#Ϊ */
 	this->p_ppid = -1;
+	this->p_pptr = NULL;
+	this->p_cptr = NULL;
+	this->p_ysptr = NULL;
+	this->p_osptr = NULL;
+	this->p_next = NULL;
+	this->p_prev = NULL;
+	this->p_hash = NULL;
+	this->p_timer.t_next = NULL;
+	this->p_timer.t_prev = NULL;
+	this->p_forw = NULL;
+	this->p_back = NULL;
+	this->p_decay = 0;
 }
 
 Process::~Process()
@@ -23,18 +38,18 @@ void Process::SetRun()
 {
 	ProcessManager& procMgr = Kernel::Instance().GetProcessManager();
 
+	TRACE(Trace::TR_WAKEUP, this->p_pid, this->p_wchan);
+
 	/* ˯ԭתΪ״̬ */
 	this->p_wchan = 0;
 	this->p_stat = Process::SRUN;
+	/* ˯ڼp_cpu˥ٰ */
+	this->DecayCpu();
+	procMgr.AddRunQueue(this);
 	if ( this->p_pri < procMgr.CurPri )
 	{
 		procMgr.RunRun++;
 	}
-	if ( 0 != procMgr.RunOut && (this->p_flag & Process::SLOAD) == 0 )
-	{
-		procMgr.RunOut = 0;
-		procMgr.WakeUpAll((unsigned long)&procMgr.RunOut);
-	}
 }
 
 void Process::SetPri()
@@ -53,7 +68,39 @@ void Process::SetPri()
 	{
 		procMgr.RunRun++;
 	}
-	this->p_pri = priority;
+	procMgr.ChangePri(this, priority);
+}
+
+void Process::DecayCpu()
+{
+	ProcessManager& procMgr = Kernel::Instance().GetProcessManager();
+	unsigned int elapsed = procMgr.DecaySec - this->p_decay;
+
+	if ( 0 == elapsed )
+	{
+		return;
+	}
+	this->p_decay = procMgr.DecaySec;
+
+	/* p_cpu1024p_time127˯پҲֻ貹127 */
+	if ( elapsed > 127 )
+	{
+		elapsed = 127;
+	}
+	this->p_time = Utility::Min(this->p_time + elapsed, 127);
+
+	if ( this->p_cpu > (int)(Time::SCHMAG * elapsed) )
+	{
+		this->p_cpu -= Time::SCHMAG * elapsed;
+	}
+	else
+	{
+		this->p_cpu = 0;
+	}
+	if ( this->p_pri > ProcessManager::PUSER )
+	{
+		this->SetPri();
+	}
 }
 
 bool Process::IsSleepOn(unsigned long chan)
@@ -70,7 +117,8 @@ bool Process::IsSleepOn(unsigned long chan)
 void Process::Sleep(unsigned long chan, int pri)
 {
 	User& u = Kernel::Instance().GetUser();
-	ProcessManager& procMgr = Kernel::Instance().GetProcessManager();
+
+	TRACE(Trace::TR_SLEEP, chan, pri);
 
 	if ( pri > 0 )
 	{
@@ -95,11 +143,6 @@ void Process::Sleep(unsigned long chan, int pri)
 		this->p_pri = pri;
 		X86Assembly::STI();
 
-		if ( procMgr.RunIn != 0 )
-		{
-			procMgr.RunIn = 0;
-			procMgr.WakeUpAll((unsigned long)&procMgr.RunIn);
-		}
 		/* ǰ̷CPUл̨ */
 		//Diagnose::Write("Process %d Start Sleep!\n", this->p_pid);
 		Kernel::Instance().GetProcessManager().Swtch();
@@ -128,56 +171,6 @@ void Process::Sleep(unsigned long chan, int pri)
 	}
 }
 
-void Process::Expand(unsigned int newSize)
-{
-	UserPageManager& userPgMgr = Kernel::Instance().GetUserPageManager();
-	ProcessManager& procMgr = Kernel::Instance().GetProcessManager();
-	User& u = Kernel::Instance().GetUser();
-	Process* pProcess = u.u_procp;
-
-	unsigned int oldSize = pProcess->p_size;
-	p_size = newSize;
-	unsigned long oldAddress = pProcess->p_addr;
-	unsigned long newAddress;
-
-	/* ͼСͷŶڴ */
-	if ( oldSize >= newSize )
-	{
-		if(oldSize > newSize)
-			userPgMgr.FreeMemory(oldSize - newSize, oldAddress + newSize);
-		return;
-	}
-
-	/* ͼҪѰһСnewSizeڴ */
-	SaveU(u.u_rsav);
-	newAddress = userPgMgr.AllocMemory(newSize);
-	/* ڴʧܣʱ */
-	if ( NULL == newAddress )
-	{
-		SaveU(u.u_ssav);
-		procMgr.XSwap(pProcess, true, oldSize);
-		pProcess->p_flag |= Process::SSWAP;
-		procMgr.Swtch();
-		/* no return */
-	}
-	/* ڴɹͼ񿽱ڴȻתڴ */
-	pProcess->p_addr = newAddress;
-	for ( unsigned int i = 0; i < oldSize; i++ )
-	{
-		Utility::CopySeg(oldAddress + i, newAddress + i);
-	}
-
-	/* ͷԭռõڴ */
-	userPgMgr.FreeMemory(oldSize, oldAddress);
-	
-	X86Assembly::CLI();
-	SwtchUStruct(pProcess);
-	RetU();
-	X86Assembly::STI();
-
-	u.u_MemoryDescriptor.MapToPageTable();
-}
-
 void Process::Exit()
 {
 	int i;
@@ -186,10 +179,15 @@ void Process::Exit()
 	OpenFileTable& fileTable = *Kernel::Instance().GetFileManager().m_OpenFileTable;
 	InodeTable& inodeTable = *Kernel::Instance().GetFileManager().m_InodeTable;
 
-	Diagnose::Write("Process %d is exiting\n",u.u_procp->p_pid);
+	Process* current;
+
+	KernelLog::Printf(KernelLog::LOG_DEBUG, "Process %d is exiting\n", u.u_procp->p_pid);
 	/* Reset Tracing flag */
 	u.u_procp->p_flag &= (~Process::STRC);
 
+	/* źŴϵʱ˯߿δڵĶʱ */
+	Time::DelTimer(&u.u_procp->p_timer);
+
 	/* ̵źŴΪ1ʾԸźκδ */
 	for ( i = 0; i < User::NSIG; i++ )
 	{
@@ -219,56 +217,62 @@ void Process::Exit()
 		u.u_procp->p_textp = NULL;
 	}
 
-	/* uд뽻ȴƺ */
-	SwapperManager& swapperMgr = Kernel::Instance().GetSwapperManager();
-	BufferManager& bufMgr = Kernel::Instance().GetBufferManager();
-	/* uĴСᳬ512ֽڣֻдppdaǰ512ֽڣuṹȫϢ */
-	int blkno = swapperMgr.AllocSwap(BufferManager::BUFFER_SIZE);
-	if ( NULL == blkno )
+	/* ͷŽ˽ҳ棬Ҫȴҳûػ̻ҳ */
+	if ( u.u_MemoryDescriptor.m_UserPageTableArray != NULL )
 	{
-		Utility::Panic("Out of Swapper Space");
+		u.u_MemoryDescriptor.ClearUserPageTable();
 	}
-	Buf* pBuf = bufMgr.GetBlk(DeviceManager::ROOTDEV, blkno);
-	Utility::DWordCopy((int *)&u, (int *)pBuf->b_addr, BufferManager::BUFFER_SIZE / sizeof(int));
-	bufMgr.Bwrite(pBuf);
 
-	/* ͷڴԴ */
+	/* ƺֻҪֵʱͳƣProcessṹuppdaһͬͷ */
+	current = u.u_procp;
+	current->p_xstat = u.u_arg[0];
+	current->p_utime = u.u_utime;
+	current->p_stime = u.u_stime;
+	current->p_cutime = u.u_cutime;
+	current->p_cstime = u.u_cstime;
+
+	/* ͷڴԴݶΡջҳ棬Եַӳձppda */
+	current->p_pgtable = NULL;
+	current->p_pgdir = NULL;
 	u.u_MemoryDescriptor.Release();
-	Process* current = u.u_procp;
 	UserPageManager& userPageMgr = Kernel::Instance().GetUserPageManager();
 	userPageMgr.FreeMemory(current->p_size, current->p_addr);
-	current->p_addr = blkno;
+	current->p_addr = 0;
 	current->p_stat = Process::SZOMB;
 
-	/* Ѹ̽ƺ */
-	for ( i = 0; i < ProcessManager::NPROC; i++ )
-	{
-		if ( procMgr.process[i].p_pid == current->p_ppid )
-		{
-			procMgr.WakeUpAll((unsigned long)&procMgr.process[i]);
-			break;
-		}
-	}
-	/* ûҵ */
-	if ( ProcessManager::NPROC == i )
+	/*
+	 * Ѹ̽ƺWait()ԼProcessṹַΪ˯ԭ
+	 * ֻ鸸һ̣ɨ̱
+	 */
+	Process* parent = current->p_pptr;
+	if ( parent->IsSleepOn((unsigned long)parent) )
 	{
-		current->p_ppid = 1;
-		procMgr.WakeUpAll((unsigned long)&procMgr.process[1]);
+		parent->SetRun();
 	}
 
-	/* Լӽ̴Լĸ */
-	for ( i = 0; i < ProcessManager::NPROC; i++ )
+	/* Լӽ̸̹1# */
+	Process* pInit = &procMgr.process[1];
+	bool zombie = false;
+	Process* child;
+	while ( NULL != (child = current->p_cptr) )
 	{
-		if ( current->p_pid == procMgr.process[i].p_ppid )
+		KernelLog::Printf(KernelLog::LOG_DEBUG, "Process %d's child %d passed to 1#process\n", current->p_pid, child->p_pid);
+		procMgr.RemoveChild(child);
+		procMgr.AddChild(pInit, child);
+		if ( child->p_stat == Process::SSTOP )
+		{
+			child->SetRun();
+		}
+		else if ( child->p_stat == Process::SZOMB )
 		{
-			Diagnose::Write("My:%d 's child %d passed to 1#process",current->p_pid,procMgr.process[i].p_pid);
-			procMgr.process[i].p_ppid = 1;
-			if ( procMgr.process[i].p_stat == Process::SSTOP )
-			{
-				procMgr.process[i].SetRun();
-			}
+			zombie = true;
 		}
 	}
+	/* ̵ӽֹģ1#Ϊƺ */
+	if ( zombie && pInit->IsSleepOn((unsigned long)pInit) )
+	{
+		pInit->SetRun();
+	}
 
 	procMgr.Swtch();
 }
@@ -293,6 +297,9 @@ void Process::Clone(Process& proc)
 	/* ʼ̵سԱ */
 	proc.p_pri = 0;		/* ȷchildСȸлռCPU */
 	proc.p_time = 0;
+	proc.p_forw = NULL;
+	proc.p_back = NULL;
+	proc.p_decay = Kernel::Instance().GetProcessManager().DecaySec;
 	
 
 	/* ļƿFileṹü+1 */
@@ -329,25 +336,18 @@ void Process::SStack()
 	unsigned int change = 4096;
 	//unsigned int change = 0;
 	md.m_StackSize += change;
-	unsigned int newSize = ProcessManager::USIZE + md.m_DataSize + md.m_StackSize;
 
+	/* 
+	 * ݶΡջҳ水ҳ䣬չջƶԭҳ棺
+	 * Ķջҳȱҳ쳣غٴηʱ䲢0
+	 */
 	if ( false == u.u_MemoryDescriptor.EstablishUserPageTable(md.m_TextStartAddress,
 						md.m_TextSize, md.m_DataStartAddress, md.m_DataSize, md.m_StackSize) )
 	{
+		md.m_StackSize -= change;
 		u.u_error = User::ENOMEM;
 		return;
 	}
-
-	this->Expand(newSize);
-	int dst = u.u_procp->p_addr + newSize;
-	unsigned int count = md.m_StackSize - change;
-	while(count--)
-	{
-		dst--;
-		Utility::CopySeg(dst - change, dst);
-	}
-
-	u.u_MemoryDescriptor.MapToPageTable();
 }
 
 
@@ -364,6 +364,7 @@ void Process::SBreak()
 		return;
 	}
 
+	/* ݶСʱͷŶҳ棬ʱҳ水䣬ջҳ治Ӱ */
 	if ( false == u.u_MemoryDescriptor.EstablishUserPageTable(md.m_TextStartAddress, 
 						md.m_TextSize, md.m_DataStartAddress, newSize, md.m_StackSize) )
 	{
@@ -372,34 +373,7 @@ void Process::SBreak()
 		return;
 	}
 
-	int change = newSize - md.m_DataSize;
 	md.m_DataSize = newSize;
-	newSize += ProcessManager::USIZE + md.m_StackSize;
-
-	/* ݶС */
-	if ( change < 0 )
-	{
-		int dst = u.u_procp->p_addr + newSize - md.m_StackSize;
-		int count = md.m_StackSize;
-		while(count--)
-		{
-			Utility::CopySeg(dst - change, dst);
-			dst++;
-		}
-		this->Expand(newSize);
-	}
-	/* ݶ */
-	else if ( change > 0 )
-	{
-		this->Expand(newSize);
-		int dst = u.u_procp->p_addr + newSize;
-		int count = md.m_StackSize;
-		while(count--)
-		{
-			dst--;
-			Utility::CopySeg(dst - change, dst);
-		}
-	}
 	u.u_ar0[User::EAX] = md.m_DataStartAddress + md.m_DataSize;
 }
 
@@ -418,7 +392,7 @@ void Process::PSignal( int signal )
 	/* ̵PUSER(100)ΪPUSER */
 	if ( this->p_pri > ProcessManager::PUSER )
 	{
-		this->p_pri	= ProcessManager::PUSER;
+		Kernel::Instance().GetProcessManager().ChangePri(this, ProcessManager::PUSER);
 	}
 	/* ̵ĴڵȨ˯ߣ份 */
 	if ( this->p_stat == Process::SWAIT )
@@ -7,6 +7,9 @@
 #include "PEParser.h"
 #include "Regs.h"
 #include "MemoryDescriptor.h"
+#include "TimeInterrupt.h"
+#include "Trace.h"
+#include "KernelLog.h"
 
 unsigned int ProcessManager::m_NextUniquePid = 0;
 
@@ -14,10 +17,41 @@ ProcessManager::ProcessManager()
 {
 	CurPri = 0;
 	RunRun = 0;
-	RunIn = 0;
-	RunOut = 0;
+	PgWant = 0;
+	PgIn = 0;
+	PgOut = 0;
+	PgFault = 0;
+	ClockProc = NULL;
+	ClockPage = 0;
+	ProcList = NULL;
+	ProcFreeList = NULL;
+	for ( int i = 0; i < NPIDHASH; i++ )
+	{
+		PidHash[i] = NULL;
+	}
+	ProcCnt = 0;
+	ProcTableSize = 0;
+	TextCacheSize = 0;
+	TextLru = 0;
+	for ( int i = 0; i < NRUNQ; i++ )
+	{
+		RunQueue[i] = NULL;
+	}
+	for ( int i = 0; i < NRUNQWORD; i++ )
+	{
+		RunBitmap[i] = 0;
+	}
+	RunSummary = 0;
+	DecaySec = 0;
+	for ( int i = 0; i < NTEXTHASH; i++ )
+	{
+		TextHash[i] = NULL;
+	}
 	ExeCnt = 0;
 	SwtchNum = 0;
+	SwtchTraceCnt = 0;
+	SwtchStart = 0;
+	SwtchFrom = 0;
 }
 
 ProcessManager::~ProcessManager()
@@ -26,7 +60,13 @@ ProcessManager::~ProcessManager()
 
 void ProcessManager::Initialize()
 {
-	//nothing to do here
+	/* process[0]0#̣±˳ɿ */
+	for ( int i = NPROC - 1; i > 0; i-- )
+	{
+		this->process[i].p_next = this->ProcFreeList;
+		this->ProcFreeList = &this->process[i];
+	}
+	this->ProcTableSize = NPROC;
 }
 
 void ProcessManager::SetupProcessZero()
@@ -42,6 +82,8 @@ void ProcessManager::SetupProcessZero()
 	pProcZero->p_size = 0x1000;
 	pProcZero->p_addr = PROCESS_ZERO_PPDA_ADDRESS;
 	pProcZero->p_textp = NULL;
+	pProcZero->p_pgtable = NULL;
+	pProcZero->p_pgdir = NULL;
 
 	User& u = Kernel::Instance().GetUser();
 	u.u_procp = pProcZero;
@@ -51,7 +93,10 @@ void ProcessManager::SetupProcessZero()
 	u.u_MemoryDescriptor.m_DataSize = 0;
 	u.u_MemoryDescriptor.m_StackSize = 0;
 	u.u_MemoryDescriptor.m_UserPageTableArray = NULL;
+	u.u_MemoryDescriptor.m_PageDirectory = NULL;
 //	u.u_MemoryDescriptor.Initialize();
+
+	this->LinkProc(pProcZero, NULL);
 }
 
 unsigned int ProcessManager::NextUniquePid()
@@ -59,41 +104,210 @@ unsigned int ProcessManager::NextUniquePid()
 	return ProcessManager::m_NextUniquePid++;
 }
 
-int ProcessManager::NewProc()
+Process* ProcessManager::AllocProc()
 {
-	//Diagnose::Write("Start NewProc()\n");
-	Process* child = 0;
-	for (int i = 0; i < ProcessManager::NPROC; i++ )
+	if ( NULL == this->ProcFreeList )
 	{
-		if ( process[i].p_stat == Process::SNULL )
+		/* 
+		 * һҳڴ̱Ĳֲͷţ˯ԭʱָ
+		 * ProcessʼָЧڴ档
+		 */
+		unsigned long address = Kernel::Instance().GetKernelPageManager().AllocMemory(PageManager::PAGE_SIZE);
+		if ( 0 == address )
 		{
-			child = &process[i];
-			break;
+			return NULL;
+		}
+		Process* pChunk = (Process*)(address + Machine::KERNEL_SPACE_START_ADDRESS);
+		Process blank;
+		for ( unsigned int i = 0; i < PageManager::PAGE_SIZE / sizeof(Process); i++ )
+		{
+			pChunk[i] = blank;
+			pChunk[i].p_next = this->ProcFreeList;
+			this->ProcFreeList = &pChunk[i];
 		}
+		this->ProcTableSize += PageManager::PAGE_SIZE / sizeof(Process);
 	}
-	if ( !child ) 
+
+	Process* pProcess = this->ProcFreeList;
+	this->ProcFreeList = pProcess->p_next;
+	pProcess->p_next = NULL;
+	return pProcess;
+}
+
+void ProcessManager::LinkProc(Process* pProcess, Process* parent)
+{
+	/* жϴеWakeUpAll()Signal()ϵͳ޸ʱж */
+	unsigned long flags = X86Assembly::SaveFlagsCLI();
+	pProcess->p_prev = NULL;
+	pProcess->p_next = this->ProcList;
+	if ( NULL != this->ProcList )
 	{
-		Utility::Panic("No Proc Entry!");
+		this->ProcList->p_prev = pProcess;
+	}
+	this->ProcList = pProcess;
+	this->ProcCnt++;
+	X86Assembly::RestoreFlags(flags);
+
+	Process** pHead = &this->PidHash[pProcess->p_pid & (NPIDHASH - 1)];
+	pProcess->p_hash = *pHead;
+	*pHead = pProcess;
+
+	if ( NULL != parent )
+	{
+		this->AddChild(parent, pProcess);
+	}
+}
+
+void ProcessManager::FreeProc(Process* pProcess)
+{
+	this->RemoveChild(pProcess);
+
+	Process** pp = &this->PidHash[pProcess->p_pid & (NPIDHASH - 1)];
+	while ( *pp != pProcess )
+	{
+		pp = &(*pp)->p_hash;
+	}
+	*pp = pProcess->p_hash;
+	pProcess->p_hash = NULL;
+
+	unsigned long flags = X86Assembly::SaveFlagsCLI();
+	/* ʱָָͷŵĽʱƵϵͳеһ */
+	if ( this->ClockProc == pProcess )
+	{
+		this->ClockProc = pProcess->p_next;
+		this->ClockPage = 0;
+	}
+	if ( NULL != pProcess->p_prev )
+	{
+		pProcess->p_prev->p_next = pProcess->p_next;
+	}
+	else
+	{
+		this->ProcList = pProcess->p_next;
+	}
+	if ( NULL != pProcess->p_next )
+	{
+		pProcess->p_next->p_prev = pProcess->p_prev;
+	}
+	pProcess->p_prev = NULL;
+	this->ProcCnt--;
+	X86Assembly::RestoreFlags(flags);
+
+	pProcess->p_stat = Process::SNULL;
+	pProcess->p_pid = 0;
+	pProcess->p_ppid = -1;
+	pProcess->p_sig = 0;
+	pProcess->p_flag = 0;
+
+	pProcess->p_next = this->ProcFreeList;
+	this->ProcFreeList = pProcess;
+}
+
+Process* ProcessManager::PFind(int pid)
+{
+	Process* pProcess = this->PidHash[pid & (NPIDHASH - 1)];
+	while ( NULL != pProcess && pProcess->p_pid != pid )
+	{
+		pProcess = pProcess->p_hash;
+	}
+	return pProcess;
+}
+
+void ProcessManager::AddChild(Process* parent, Process* pProcess)
+{
+	pProcess->p_pptr = parent;
+	pProcess->p_ppid = parent->p_pid;
+	pProcess->p_ysptr = NULL;
+	pProcess->p_osptr = parent->p_cptr;
+	if ( NULL != parent->p_cptr )
+	{
+		parent->p_cptr->p_ysptr = pProcess;
+	}
+	parent->p_cptr = pProcess;
+}
+
+void ProcessManager::RemoveChild(Process* pProcess)
+{
+	Process* parent = pProcess->p_pptr;
+	if ( NULL == parent )
+	{
+		return;
+	}
+	if ( NULL != pProcess->p_ysptr )
+	{
+		pProcess->p_ysptr->p_osptr = pProcess->p_osptr;
+	}
+	else
+	{
+		parent->p_cptr = pProcess->p_osptr;
+	}
+	if ( NULL != pProcess->p_osptr )
+	{
+		pProcess->p_osptr->p_ysptr = pProcess->p_ysptr;
+	}
+	pProcess->p_pptr = NULL;
+	pProcess->p_ysptr = NULL;
+	pProcess->p_osptr = NULL;
+}
+
+int ProcessManager::NewProc()
+{
+	//Diagnose::Write("Start NewProc()\n");
+	Process* child = this->AllocProc();
+	if ( NULL == child )
+	{
+		return -1;
 	}
 
 	User& u = Kernel::Instance().GetUser();
 	Process* current = (Process*)u.u_procp;
+
+	/* 
+	 * Ϊӽ̷Եַӳձ˽ҳĿ¼ڴ治ʱ
+	 * ʱδκԴ賷ø̵MemoryDescriptorɷ䡣
+	 */
+	PageTable* pgTable = u.u_MemoryDescriptor.m_UserPageTableArray;
+	PageDirectory* pgDir = u.u_MemoryDescriptor.m_PageDirectory;
+	bool success = u.u_MemoryDescriptor.Initialize();
+	PageTable* childPgTable = u.u_MemoryDescriptor.m_UserPageTableArray;
+	PageDirectory* childPgDir = u.u_MemoryDescriptor.m_PageDirectory;
+	u.u_MemoryDescriptor.m_UserPageTableArray = pgTable;
+	u.u_MemoryDescriptor.m_PageDirectory = pgDir;
+	if ( false == success )
+	{
+		child->p_next = this->ProcFreeList;
+		this->ProcFreeList = child;
+		return -1;
+	}
+
 	//Newprocֳ֣cloneprocessṹڵ
 	current->Clone(*child);
+	/* ͼ֮ǰӽ̨̲ܱҲҳû */
+	child->p_stat = Process::SIDL;
+	child->p_pgtable = NULL;
+	child->p_pgdir = NULL;
+
+	/* 
+	 * Ϊӽppdaڴ档ڴ治ʱ̻˯ߵȴ
+	 * ˱SaveU()֮ǰɣ򱣴ֳᱻ˯ʱSwtch()ǡ
+	 */
+	child->p_addr = this->AllocUserMemory(ProcessManager::USIZE);
 
 	/* ҪSaveU()ֳuΪЩ̲һ
 	ù */
 	SaveU(u.u_rsav);
 
-	/* ̵û̬ҳָm_UserPageTableArraypgTable */
-	PageTable* pgTable = u.u_MemoryDescriptor.m_UserPageTableArray;
-	u.u_MemoryDescriptor.Initialize();
 	/* ̵Եַӳձӽ̣ҳĴС */
 	if ( NULL != pgTable )
 	{
-		// u.u_MemoryDescriptor.Initialize();
-		Utility::MemCopy((unsigned long)pgTable, (unsigned long)u.u_MemoryDescriptor.m_UserPageTableArray, sizeof(PageTable) * MemoryDescriptor::USER_SPACE_PAGE_TABLE_CNT);
+		Utility::MemCopy((unsigned long)pgTable, (unsigned long)childPgTable, sizeof(PageTable) * MemoryDescriptor::USER_SPACE_PAGE_TABLE_CNT);
 	}
+	child->p_pgtable = childPgTable;
+	child->p_pgdir = childPgDir;
+
+	/* ̵m_UserPageTableArraym_PageDirectoryʱָӽ̵ģʹƳuӽ */
+	u.u_MemoryDescriptor.m_UserPageTableArray = childPgTable;
+	u.u_MemoryDescriptor.m_PageDirectory = childPgDir;
 
 	//н̵uu_procpָnew process
 	//ڱƵʱֱӸu_procp
@@ -101,37 +315,77 @@ int ProcessManager::NewProc()
 	//޸u_procpĵַ
 	u.u_procp = child;
 
-	UserPageManager& userPageManager = Kernel::Instance().GetUserPageManager();
+	/* ppdaӽ̵uṹбSaveU()ʱֳ */
+	Utility::CopyPage(current->p_addr, child->p_addr);
 
-	unsigned long srcAddress = current->p_addr;
-	unsigned long desAddress = userPageManager.AllocMemory(current->p_size);
-	//Diagnose::Write("srcAddress %x\n", srcAddress);
-	//Diagnose::Write("desAddress %x\n", desAddress);
-	if ( desAddress == 0 ) /* ڴ治Ҫswap */
-	{
-		current->p_stat = Process::SIDL;
-		/* ӽp_addrָ򸸽ͼΪӽ̻ҪԸͼΪ */
-		child->p_addr = current->p_addr;
-		SaveU(u.u_ssav);
-		this->XSwap(child, false, 0);
-		child->p_flag |= Process::SSWAP;
-		current->p_stat = Process::SRUN;
-	}
-	else
+	u.u_procp = current;
+	/* 
+	 * ppdaڼ䣬̵m_UserPageTableArraym_PageDirectoryָӽ̵Եַӳձ
+	 * ҳĿ¼ɺָܻΪǰݵpgTablepgDir
+	 */
+	u.u_MemoryDescriptor.m_UserPageTableArray = pgTable;
+	u.u_MemoryDescriptor.m_PageDirectory = pgDir;
+
+	/* 
+	 * ҳƸ̵ݶΡջΡδװҳ踴ƣӽȱҳʱ
+	 * ͬexeļװ룻ҳֱӴӽӽ̵ҳ
+	 */
+	bool swapError = false;
+	if ( NULL != pgTable )
 	{
-		int n = current->p_size;
-		child->p_addr = desAddress;
-		while (n--)
+		PageTableEntry* srcEntrys = (PageTableEntry*)pgTable;
+		PageTableEntry* desEntrys = (PageTableEntry*)childPgTable;
+		for ( unsigned int i = 0; i < Machine::USER_PAGE_TABLE_CNT * PageTable::ENTRY_CNT_PER_PAGETABLE; i++ )
 		{
-			Utility::CopySeg(srcAddress++, desAddress++);
+			if ( 0 == desEntrys[i].m_Present || 0 == desEntrys[i].m_ReadWriter || (desEntrys[i].m_ForSystemUser & MemoryDescriptor::PG_DEMAND) )
+			{
+				continue;
+			}
+
+			unsigned long frame = this->AllocUserMemory(PageManager::PAGE_SIZE);
+			/* ҳڼ丸̵ҳܱ¼鸸ҳ */
+			while ( srcEntrys[i].m_ForSystemUser & MemoryDescriptor::PG_BUSY )
+			{
+				u.u_procp->Sleep((unsigned long)&PgOut, ProcessManager::PSWP);
+			}
+			if ( srcEntrys[i].m_ForSystemUser & MemoryDescriptor::PG_SWAP )
+			{
+				if ( false == Kernel::Instance().GetSwapperManager().SwapInPage(srcEntrys[i].m_PageBaseAddress, frame) )
+				{
+					/* ӽ̵һҳѶʧ0ҳӽ̨󼴱SIGKILLֹ */
+					Utility::ClearPage(frame);
+					swapError = true;
+				}
+			}
+			else
+			{
+				Utility::CopyPage(srcEntrys[i].m_PageBaseAddress * PageManager::PAGE_SIZE, frame);
+			}
+			desEntrys[i].m_ForSystemUser = 0;
+			desEntrys[i].m_Accessed = 0;
+			desEntrys[i].m_PageBaseAddress = frame / PageManager::PAGE_SIZE;
 		}
 	}
-	u.u_procp = current;
+
 	/* 
-	 * ͼڼ䣬̵m_UserPageTableArrayָӽ̵Եַӳձ
-	 * ɺָܻΪǰݵpgTable
+	 * ˽ҳ渴ɺһԽӽ̵û̬ҳӽ̨ʱֻҳĿ¼
+	 * ø̵MemoryDescriptorɣڼ䲻˯ߡ
 	 */
+	u.u_MemoryDescriptor.m_UserPageTableArray = childPgTable;
+	u.u_MemoryDescriptor.m_PageDirectory = childPgDir;
+	u.u_MemoryDescriptor.MapToPageTable(child->p_textp);
 	u.u_MemoryDescriptor.m_UserPageTableArray = pgTable;
+	u.u_MemoryDescriptor.m_PageDirectory = pgDir;
+
+	/* ӽ̼ϵͳΪӽ̣еȴ̨ */
+	child->p_stat = Process::SRUN;
+	this->LinkProc(child, current);
+	this->AddRunQueue(child);
+	if ( swapError )
+	{
+		KernelLog::Printf(KernelLog::LOG_ERR, "pid %d: swap I/O error in fork, child %d killed\n", current->p_pid, child->p_pid);
+		child->PSignal(User::SIGKILL);
+	}
 	//Diagnose::Write("End NewProc()\n");
 	return 0;
 }
@@ -143,30 +397,61 @@ int ProcessManager::Swtch()
 	User& u = Kernel::Instance().GetUser();
 	SaveU(u.u_rsav);
 
-	/* 0#̨*/
-	Process* procZero = &process[0];
+	/* ¼лʼʱ̨̺̣½ֳָ̻длټ¼ */
+	this->SwtchStart = (unsigned int)X86Assembly::RDTSC();
+	this->SwtchFrom = u.u_procp->p_pid;
+
+	/* Դھ̨̬(ռ)صӦеĩβ */
+	if ( Process::SRUN == u.u_procp->p_stat )
+	{
+		this->AddRunQueue(u.u_procp);
+	}
 
 	/* 
-	 * SwtchUStruct()RetU()Ϊٽֹжϴϡ
-	 * RetU()ָesp֮δָebpʱжϽᵼ
-	 * espebp̵ֱָͬĺջλá good comment
-	 *
-	 * Ϊʲô0#̳еѡ̨Ĳ
-	 * ӽлĽǶȣǫ̈̄ѡ̨ ǣʱжϡ
-	 * һĩ дϵͳidleʱִӦóУԷںִйС
-	 * жϣ
-	 * ںidleı־  0#˯ִ̬idle()ӳ
-	 *  TimeInterrupt.cppLine 82.
-	 * ǣ0#ִselect()
-	 *
+	 * ̵̨ĺջֱѡʺ̨Ḷֻ̌лһuҳĿ¼
+	 * ʹSelect()Ĵ޹أҪл0#̡
 	 */
-	X86Assembly::CLI();
-	SwtchUStruct(procZero);
-	RetU();
-	X86Assembly::STI();
+	Process* selected = this->Select();
+
+	if ( selected == u.u_procp )
+	{
+		/* ѡе̨Լֳָ */
+		this->TraceSwtch(selected);
+		return 1;
+	}
+
+	if ( NULL == selected )
+	{
+		/* 0#̨*/
+		Process* procZero = &process[0];
 
-	/* ѡʺ̨Ľ */
-	Process* selected = Select();
+		/* 
+		 * SwtchUStruct()RetU()Ϊٽֹжϴϡ
+		 * RetU()ָesp֮δָebpʱжϽᵼ
+		 * espebp̵ֱָͬĺջλá good comment
+		 *
+		 * ûоʱ0#̳ееȴ̵̨ppdaExit()ͷţ
+		 * һĩдϵͳidleʱУںidleı־0#˯̬ȴ
+		 *  TimeInterrupt.cppLine 82.
+		 */
+		X86Assembly::CLI();
+		SwtchUStruct(procZero);
+		RetU();
+
+		/* ˺0#̵ĺջϣֲthis0#̱ջ֡ */
+		ProcessManager& procMgr = Kernel::Instance().GetProcessManager();
+		while ( NULL == (selected = procMgr.Select()) )
+		{
+			/* ûжʱʱֹͣʱжϣٿʱѵĴ */
+			Time::IdleEnter();
+			/* stiһִָǰӦжϣhlt֮䲻ᶪʧ */
+			__asm__ __volatile__("sti; hlt; cli");
+			Time::IdleExit();
+		}
+		X86Assembly::STI();
+		/* еȴʱ䲻л */
+		procMgr.SwtchStart = (unsigned int)X86Assembly::RDTSC();
+	}
 
 	/* ̵ֳָ */
 	X86Assembly::CLI();
@@ -174,25 +459,11 @@ int ProcessManager::Swtch()
 	RetU();
 	X86Assembly::STI();
 
+	/* ÿӵ˽ҳĿ¼û̬ҳлַռֻ¼CR3 */
 	User& newu = Kernel::Instance().GetUser();
-	newu.u_MemoryDescriptor.MapToPageTable();
-	
-	/*
-	 * If the new process paused because it was
-	 * swapped out, set the stack level to the last call
-	 * to savu(u_ssav).  This means that the return
-	 * which is executed immediately after the call to aretu
-	 * actually returns from the last routine which did
-	 * the savu.
-	 *
-	 * You are not expected to understand this.
-	 */
-	if ( newu.u_procp->p_flag & Process::SSWAP )
-	{
-		newu.u_procp->p_flag &= ~Process::SSWAP;
-		aRetU(newu.u_ssav);
-	}
-	
+	newu.u_MemoryDescriptor.LoadPageDirectory();
+	Kernel::Instance().GetProcessManager().TraceSwtch(newu.u_procp);
+
 	/* 
 	 * forkĽ̨֮ǰڱ̨ʱ1
 	 * ͬʱصNewProc()ִеĵַ
@@ -202,200 +473,187 @@ int ProcessManager::Swtch()
 
 void ProcessManager::Sched()
 {
-	Process* pSelected;
 	User& u = Kernel::Instance().GetUser();
-	int seconds;
-	unsigned int size;
-	unsigned long desAddress;
 
-	/* 
-	 * ѡڽפʱھ״̬Ľ̻
-	 */
-	goto loop;
-
-sloop:
-	this->RunIn++;
-	u.u_procp->Sleep((unsigned long)&RunIn, ProcessManager::PSWP);
-
-loop:
-	X86Assembly::CLI();
-	seconds = -1;
-	for ( int i = 0; i < ProcessManager::NPROC; i++ )
+	while ( true )
 	{
-		if ( this->process[i].p_stat == Process::SRUN && (this->process[i].p_flag & Process::SLOAD) == 0 && this->process[i].p_time > seconds )
+		/* ûн̵ȴڴʱ˯ߵȴAllocUserMemory() */
+		X86Assembly::CLI();
+		while ( 0 == this->PgWant )
 		{
-			pSelected = &(this->process[i]);
-			seconds = pSelected->p_time;
+			u.u_procp->Sleep((unsigned long)&PgWant, ProcessManager::PSWP);
 		}
-	}
+		this->PgWant = 0;
+		X86Assembly::STI();
 
-	/* ûзḶ̌0#˯ߵȴҪĽ */
-	if ( -1 == seconds )
-	{
-		this->RunOut++;
-		u.u_procp->Sleep((unsigned long)&RunOut, ProcessManager::PSWP);
-		goto loop;
-	}
+		/* ûлκҳ棺ȴһʱٻѵȴߣڼнֹͷڴ򽻻 */
+		if ( 0 == this->ClockScan(ProcessManager::PAGEOUT_BATCH) )
+		{
+			Time::Delay(Time::HZ);
+		}
 
-	/* нҪ룬Ƿ㹻ڴ */
-	X86Assembly::STI();
-	/* ̻ҪڴС */
-	size = pSelected->p_size;
-	/* 
-	 * ڹĶΣûнͼڴУøĶεḶ̌
-	 * ĶβڴУʱҪĶڽеĸ
-	 */
-	if ( pSelected->p_textp != NULL && 0 == pSelected->p_textp->x_ccount )
-	{
-		size += pSelected->p_textp->x_size;
-	}
-	/* ڴɹʵʻ */
-	desAddress = Kernel::Instance().GetUserPageManager().AllocMemory(size);
-	if ( NULL != desAddress )
-	{
-		goto found2;
+		/* Ƿڳ㹻ڴ棬ѵȴ³Է */
+		this->WakeUpAll((unsigned long)&PgOut);
 	}
+}
 
-	/*
-	 * ڴʧ£ڴн̣ڳռ䡣
-	 * ԭ򣺴׵ѣνȨ˯״̬(SWAIT)-->
-	 * ͣ״̬(SSTOP)-->Ȩ˯״̬(SSLEEP)-->״̬(SRUN)̻
-	 */
-	X86Assembly::CLI();
-	for ( int i = 0; i < ProcessManager::NPROC; i++ )
+unsigned long ProcessManager::AllocUserMemory(unsigned long size)
+{
+	User& u = Kernel::Instance().GetUser();
+	UserPageManager& userPgMgr = Kernel::Instance().GetUserPageManager();
+	unsigned long address;
+
+	while ( 0 == (address = userPgMgr.AllocMemory(size)) )
 	{
-		if ( this->process[i].p_flag & (Process::SSYS | Process::SLOCK | Process::SLOAD) == Process::SLOAD && (this->process[i].p_stat == Process::SWAIT || this->process[i].p_stat == Process::SSTOP) )
+		/* Ȼ޽ʹõĻĶΣٿǻҳ */
+		if ( this->XShrink(true) )
 		{
-			goto found1;
+			continue;
 		}
+		this->PgWant++;
+		this->WakeUpAll((unsigned long)&PgWant);
+		u.u_procp->Sleep((unsigned long)&PgOut, ProcessManager::PSWP);
 	}
+	return address;
+}
 
-	/* 
-	 * ڻȨ˯״̬(SSLEEP)״̬(SRUN)̶ڳڴ֮ǰ
-	 * ڽפʱǷѴﵽ3룬軻
-	 */
-	if ( seconds < 3 )
-	{
-		goto sloop;
-	}
+int ProcessManager::ClockScan(int count)
+{
+	unsigned int entryCnt = Machine::USER_PAGE_TABLE_CNT * PageTable::ENTRY_CNT_PER_PAGETABLE;
+	int freed = 0;
 
-	seconds = -1;
-	for ( int i = 0; i < ProcessManager::NPROC; i++ )
+	/* ϵͳȦһȦλڶȦδʵҳ */
+	for ( int n = 0; n < this->ProcCnt * 2 && freed < count; n++ )
 	{
-		if ( this->process[i].p_flag & (Process::SSYS | Process::SLOCK | Process::SLOAD) == Process::SLOAD && (this->process[i].p_stat == Process::SWAIT || this->process[i].p_stat == Process::SSTOP) && pSelected->p_time > seconds )
+		if ( NULL == this->ClockProc )
 		{
-			pSelected = &(this->process[i]);
-			seconds = pSelected->p_time;
+			this->ClockProc = this->ProcList;
 		}
-	}
-
-	/* ҪSSLEEPSRUN״̬̣ȼýפڴʱǷ񳬹2룬軻 */
-	if ( seconds < 2 )
-	{
-		goto sloop;
-	}
+		Process* pProcess = this->ClockProc;
+		PageTable* pgTable = pProcess->p_pgtable;
 
-	/* pSelectedָıѡн */
-found1:
-	X86Assembly::STI();
-	pSelected->p_flag &= ~Process::SLOAD;
-	this->XSwap(pSelected, true, 0);
-	/* ڳڴռٴγԻ */
-	goto loop;
-
-	/* Ѿ㹻ڴ棬ʵʵĻ */
-found2:
-	BufferManager& bufMgr = Kernel::Instance().GetBufferManager();
-	/* 
-	* ڹĶΣûнͼڴУøĶεḶ̌
-	* ĶβڴУʱҪĶڽеĸ
-	*/
-	if ( pSelected->p_textp != NULL )
-	{
-		Text* pText = pSelected->p_textp;
-		if ( pText->x_ccount == 0 )
+		if ( NULL != pgTable && (pProcess->p_flag & (Process::SSYS | Process::SLOCK)) == 0
+			&& pProcess->p_stat != Process::SNULL && pProcess->p_stat != Process::SZOMB && pProcess->p_stat != Process::SIDL )
 		{
-			/* ΪĶΣͽppdaݶΡջڽǷֿŵģȻ빲Ķ */
-			if ( bufMgr.Swap(pText->x_daddr, desAddress, pText->x_size, Buf::B_READ) == false )
+			PageTableEntry* entrys = (PageTableEntry*)pgTable;
+			for ( ; this->ClockPage < entryCnt && freed < count; this->ClockPage++ )
 			{
-				goto err;
+				PageTableEntry* entry = &entrys[this->ClockPage];
+				PageTableEntry* pte = &((PageTableEntry*)MemoryDescriptor::GetPageTables(pProcess->p_pgdir))[this->ClockPage];
+
+				/* ֻפڴݶΡջҳ */
+				if ( 0 == entry->m_Present || 0 == entry->m_ReadWriter || 0 != entry->m_ForSystemUser )
+				{
+					continue;
+				}
+				/* 
+				 * λֱȡԸý̵û̬ҳػʱʹõһҳĿ¼
+				 * ý̵TLBлCR3ʱϣλˢTLB
+				 */
+				if ( 1 == entry->m_Accessed || 1 == pte->m_Accessed )
+				{
+					entry->m_Accessed = 0;
+					pte->m_Accessed = 0;
+					continue;
+				}
+				if ( false == this->PageOut(pProcess, entry) )
+				{
+					/* д̳ҳڴУʱָͣڸҳ棬´δ */
+					KernelLog::Printf(KernelLog::LOG_WARNING, "swap out failed: no space or I/O error\n");
+					return freed;
+				}
+				freed++;
+
+				/* ڼػ˯ߣ̿Ѿֹ */
+				if ( pProcess->p_pgtable != pgTable )
+				{
+					break;
+				}
+			}
+			/* ѻ㹻ҳ棬ʱָͣڵǰλ */
+			if ( freed >= count && pProcess->p_pgtable == pgTable && this->ClockPage < entryCnt )
+			{
+				break;
 			}
-			/* Ķڴеʼַ */
-			pText->x_caddr = desAddress;
-			desAddress += pText->x_size;
 		}
-		pText->x_ccount++;
+		/* ڼѱƺFreeProc()ѽʱָƵһ */
+		if ( this->ClockProc == pProcess )
+		{
+			this->ClockPage = 0;
+			this->ClockProc = pProcess->p_next;
+		}
 	}
-	/* ʣಿͼppdaݶΡջ */
-	if ( bufMgr.Swap(pSelected->p_addr /* blkno */, desAddress, pSelected->p_size, Buf::B_READ) == false )
+	return freed;
+}
+
+bool ProcessManager::PageOut(Process* pProcess, PageTableEntry* entry)
+{
+	/* 
+	 * ȽҳΪڽϲ˺̷ʸҳȱҳ
+	 * DemandPage()еȴExit()ͷҳʱͬҪȴ
+	 */
+	unsigned long frame = entry->m_PageBaseAddress * PageManager::PAGE_SIZE;
+	entry->m_ForSystemUser = MemoryDescriptor::PG_SWAP | MemoryDescriptor::PG_BUSY;
+	/* ͬʱýû̬ҳеӳ */
+	unsigned int idx = entry - (PageTableEntry*)pProcess->p_pgtable;
+	((PageTableEntry*)MemoryDescriptor::GetPageTables(pProcess->p_pgdir))[idx].m_Present = 0;
+
+	/* ѹڴ潻أд̽handle¼ҳĻλ */
+	int handle = Kernel::Instance().GetSwapperManager().SwapOutPage(frame);
+	if ( 0 == handle )
 	{
-		goto err;
+		/* ûпеĻλãҳڴУָҳӳ䣬ѵȴĽ */
+		entry->m_ForSystemUser = 0;
+		((PageTableEntry*)MemoryDescriptor::GetPageTables(pProcess->p_pgdir))[idx].m_Present = 1;
+		this->WakeUpAll((unsigned long)&PgOut);
+		return false;
 	}
-	Kernel::Instance().GetSwapperManager().FreeSwap(pSelected->p_size, pSelected->p_addr /* blkno */);
-	pSelected->p_addr = desAddress;
-	pSelected->p_flag |= Process::SLOAD;
-	pSelected->p_time = 0;
-	goto loop;
+	Kernel::Instance().GetUserPageManager().FreeMemory(PageManager::PAGE_SIZE, frame);
 
-err:
-	Utility::Panic("Swap Error");
+	entry->m_PageBaseAddress = handle;
+	entry->m_ForSystemUser &= ~MemoryDescriptor::PG_BUSY;
+	this->PgOut++;
+	this->WakeUpAll((unsigned long)&PgOut);
+	return true;
 }
 
 void ProcessManager::Wait()
 {
-	int i;
+	Process* child;
 	bool hasChild = false;
 	User& u = Kernel::Instance().GetUser();
-	SwapperManager& swapperMgr = Kernel::Instance().GetSwapperManager();
-	BufferManager& bufMgr = Kernel::Instance().GetBufferManager();
 	
-	Diagnose::Write("Process %d finding dead son. They are ",u.u_procp->p_pid);
 	while(true)
 	{
-		for ( i = 0; i < NPROC; i++ )
+		/* ֻԼӽ */
+		for ( child = u.u_procp->p_cptr; NULL != child; child = child->p_osptr )
 		{
-			if ( u.u_procp->p_pid == process[i].p_ppid )
+			hasChild = true;
+			/* ˯ߵȴֱӽ̽ */
+			if( Process::SZOMB == child->p_stat )
 			{
-				Diagnose::Write("Process %d (Status:%d)  ",process[i].p_pid,process[i].p_stat);
-				hasChild = true;
-				/* ˯ߵȴֱӽ̽ */
-				if( Process::SZOMB == process[i].p_stat )
-				{
-					/* wait()ϵͳ÷ӽ̵pid */
-					u.u_ar0[User::EAX] = process[i].p_pid;
-
-					process[i].p_stat = Process::SNULL;
-					process[i].p_pid = 0;
-					process[i].p_ppid = -1;
-					process[i].p_sig = 0;
-					process[i].p_flag = 0;
-
-					/* swapperӽuṹ */
-					Buf* pBuf = bufMgr.Bread(DeviceManager::ROOTDEV, process[i].p_addr);
-					swapperMgr.FreeSwap(BufferManager::BUFFER_SIZE, process[i].p_addr);
-					User* pUser = (User *)pBuf->b_addr;
-
-					/* ӽ̵ʱӵ */
-					u.u_cstime += pUser->u_cstime +	pUser->u_stime;
-					u.u_cutime += pUser->u_cutime + pUser->u_utime;
-
-					int* pInt = (int *)u.u_arg[0];
-					/* ȡӽexit(int status)ķֵ */
-					*pInt = pUser->u_arg[0];
-
-					/* ˴ûBrelse()ϵͳᷢʲô-_- */
-					bufMgr.Brelse(pBuf);
-					Diagnose::Write("end wait\n");
-					return;
-				}
+				/* wait()ϵͳ÷ӽ̵pid */
+				u.u_ar0[User::EAX] = child->p_pid;
+
+				/* ӽ̵ʱӵϣӽֹʱѼProcessṹ */
+				u.u_cstime += child->p_cstime + child->p_stime;
+				u.u_cutime += child->p_cutime + child->p_utime;
+
+				int* pInt = (int *)u.u_arg[0];
+				/* ȡӽexit(int status)ķֵ */
+				*pInt = child->p_xstat;
+
+				KernelLog::Printf(KernelLog::LOG_DEBUG, "Process %d reaped child %d\n", u.u_procp->p_pid, child->p_pid);
+
+				/* ӽ̵ProcessŻؿ */
+				this->FreeProc(child);
+				return;
 			}
 		}
 		if (true == hasChild)
 		{
 			/* ˯ߵȴֱӽ̽ */
-			Diagnose::Write("wait until child process Exit! ");
 			u.u_procp->Sleep((unsigned long)u.u_procp, ProcessManager::PWAIT);
-			Diagnose::Write("end sleep\n");
 			continue;	/* صwhile(true)ѭ */
 		}
 		else
@@ -410,25 +668,16 @@ void ProcessManager::Wait()
 void ProcessManager::Fork()
 {
 	User& u = Kernel::Instance().GetUser();
-	Process* child = NULL;;
 
-	/* ѰҿеprocessΪӽ̵Ľ̿ƿ */
-	for ( int i = 0; i < ProcessManager::NPROC; i++ )
-	{
-		if ( this->process[i].p_stat == Process::SNULL )
-		{
-			child = &this->process[i];
-			break;
-		}
-	}
-	if ( child == NULL )
+	int ret = this->NewProc();	/* ӽ̷1̷0 */
+	if ( ret < 0 )
 	{
-		/* ûпprocess */
+		/* ̱޷ڴ治㣬 */
 		u.u_error = User::EAGAIN;
 		return;
 	}
 
-	if ( this->NewProc() )	/* ӽ̷1̷0 */
+	if ( ret )
 	{
 		/* ӽfork()ϵͳ÷0 */
 		u.u_ar0[User::EAX] = 0;
@@ -439,8 +688,8 @@ void ProcessManager::Fork()
 	}
 	else
 	{
-		/* ̽fork()ϵͳ÷ӽPID */
-		u.u_ar0[User::EAX] = child->p_pid;
+		/* ̽fork()ϵͳ÷ӽPIDӽǸӽ */
+		u.u_ar0[User::EAX] = u.u_procp->p_cptr->p_pid;
 	}
 
 	return;
@@ -458,7 +707,6 @@ void ProcessManager::Exec()
 	FileManager& fileMgr = Kernel::Instance().GetFileManager();
 	UserPageManager& userPgMgr = Kernel::Instance().GetUserPageManager();
 	KernelPageManager& kernelPgMgr = Kernel::Instance().GetKernelPageManager();
-	BufferManager& bufMgr = Kernel::Instance().GetBufferManager();
 
 	// Diagnose::Write("Process %d execing\n",u.u_procp->p_pid);
 	pInode = fileMgr.NameI(FileManager::NextChar, FileManager::OPEN);
@@ -582,35 +830,63 @@ void ProcessManager::Exec()
 		u.u_procp->p_textp->XFree();
 		u.u_procp->p_textp = NULL;
 	}
-	u.u_procp->Expand(ProcessManager::USIZE);
+	/* ͷԭͼݶΡջҳ棬ppdaֲ */
+	u.u_MemoryDescriptor.ClearUserPageTable();
 
-	pText = NULL;
-	/* һTextṹߺ̹ͬһĶ */
-	for ( int i = 0; i < ProcessManager::NTEXT; i++ )
+	/* 
+	 * ΪĶηڴʱ̿˯ߣ˯ڼ̿Ѿװͬһexeļ
+	 * ˷䵽ڴ²ҿɹTextṹ
+	 */
+	unsigned long textAddress = 0;
+	int sharedText = 0;
+
+retry:
+	/* (dev, ino)ɢбʹûĶλеͬһִļĶ */
+	pText = this->XLookup(pInode);
+	if ( NULL != pText )
 	{
-		if ( NULL == this->text[i].x_iptr )     /* ҵĵһtextṹ */
+		/* еĶ±ʹãټ뻺 */
+		if ( pText->x_flag & Text::XCACHE )
 		{
-			if ( NULL == pText )
+			pText->x_flag &= ~Text::XCACHE;
+			this->TextCacheSize -= pText->x_size;
+		}
+		pText->x_count++;
+		pText->x_ccount++;
+		u.u_procp->p_textp = pText;
+		sharedText = 1;
+		if ( 0 != textAddress )
+		{
+			userPgMgr.FreeMemory(u.u_MemoryDescriptor.m_TextSize, textAddress);
+		}
+	}
+	else
+	{
+		if ( 0 == textAddress )
+		{
+			textAddress = this->AllocUserMemory(u.u_MemoryDescriptor.m_TextSize);
+			goto retry;
+		}
+
+		/* һTextṹṷ̂δõĶ */
+		for ( int i = 0; i < ProcessManager::NTEXT; i++ )
+		{
+			if ( NULL == this->text[i].x_iptr )
 			{
 				pText = &(this->text[i]);
+				break;
 			}
 		}
-		else if ( pInode == this->text[i].x_iptr )		/* ⲻһtextṹһtextṹָĿִļexecϵͳҪִеӦó */
+		if ( NULL == pText )
 		{
-			this->text[i].x_count++;
-			this->text[i].x_ccount++;
-			u.u_procp->p_textp = &(this->text[i]);
-			pText = NULL;	/* ̹ͬһĶΣpText㣬ָһTextṹ */
-			break;
+			if ( false == this->XShrink(true) )
+			{
+				Utility::Panic("Out of Text");
+			}
+			/* ̭ʱ˯ߣ² */
+			goto retry;
 		}
-	}
-
 
-	int sharedText = 0;
-
-	/* ûпɹֳTextṹӦʼ */
-	if ( NULL != pText )
-	{
 		/* 
 		 * ˴i_count++ƽXFree()еIPut(x_iptr)ֻExec()ʼ
 		 * NameI()IGet()ԼExec()βIPut()ͷexeļInodeصInode
@@ -619,49 +895,41 @@ void ProcessManager::Exec()
 		 * º֮ǰ̹ͬһTextṹͬһĶΣʵϱĳ
 		 */
 		pInode->i_count++;
+		pInode->i_flag |= Inode::ITEXT;
 
 		pText->x_ccount = 1;
 		pText->x_count = 1;
+		pText->x_flag = 0;
 		pText->x_iptr = pInode;
 		pText->x_size = u.u_MemoryDescriptor.m_TextSize;
-		/* ΪĶηڴ棬ĶݵĶҪȵҳӳ֮ٴmapAddressַʼexeļж */
-		pText->x_caddr = userPgMgr.AllocMemory(pText->x_size);
-		pText->x_daddr = Kernel::Instance().GetSwapperManager().AllocSwap(pText->x_size);
+		/* ΪĶηڴ棬Ķҳ״ηʱȱҳ쳣exeļж룬ϲٱ */
+		pText->x_caddr = textAddress;
+		this->XHashInsert(pText);
 		/* uTextṹĹϵ */
 		u.u_procp->p_textp = pText;
 	}
-	else
-	{
-		pText = u.u_procp->p_textp;
-		sharedText = 1;
-	}
 
-	unsigned int newSize = ProcessManager::USIZE + u.u_MemoryDescriptor.m_DataSize + u.u_MemoryDescriptor.m_StackSize;
-	/* ͼUSIZEΪUSIZE + dataSize + stackSize */
-	u.u_procp->Expand(newSize);
-
-	Diagnose::Write("Process %x, p_addr %x, x_addr %x, p_size %x, x_size %x\n",
+	KernelLog::Printf(KernelLog::LOG_DEBUG, "Process %d exec, p_addr %x, x_addr %x, p_size %x, x_size %x\n",
 			u.u_procp->p_pid,u.u_procp->p_addr,u.u_procp->p_textp->x_caddr,u.u_procp->p_size,u.u_procp->p_textp->x_size);
 
-	/* ĶΡݶΡջγȽԵַӳձصҳ */
-	u.u_MemoryDescriptor.EstablishUserPageTable(parser.TextAddress, parser.TextSize, parser.DataAddress, parser.DataSize, parser.StackSize);
-
-	u.u_MemoryDescriptor.DisplayPageTable();
+	/* ¼.textΡ.dataΡ.rdataexeļеλãҳ״ηʱװ */
+	parser.DemandLoad(pText, sharedText);
 
-	/* exeļζ.textΡ.dataΡ.rdataΡ.bss */
-	parser.Relocate(pInode, sharedText);
+	/* 
+	 * ĶΡݶΡջγȽԵַӳձصҳС
+	 * ݶΡջҳȫΪװ룬.bssջҳ״ηʱ0
+	 */
+	u.u_MemoryDescriptor.EstablishUserPageTable(parser.TextAddress, parser.TextSize, parser.DataAddress, parser.DataSize, parser.StackSize);
 
-	/* .textswap */
-	if(sharedText == 0)
+	/* ӡҳҪдǧĻֻڻԵϢʱ */
+	if ( KernelLog::ConsoleLevel >= KernelLog::LOG_DEBUG )
 	{
-		u.u_procp->p_flag |= Process::SLOCK;
-		bufMgr.Swap(pText->x_daddr, pText->x_caddr, pText->x_size, Buf::B_WRITE);
-		u.u_procp->p_flag &= ~Process::SLOCK;
+		u.u_MemoryDescriptor.DisplayPageTable();
 	}
 
-	/* fakeStackбݵûջƵ½ͼûջ */
+	/* fakeStackбݵûջƵ½ͼûջУֻʵʹõĲ֣ջҳ水 */
 	//Utility::MemCopy(fakeStack | 0xC0000000, MemoryDescriptor::USER_SPACE_SIZE - parser.StackSize, parser.StackSize);
-	Utility::MemCopy(fakeStack + allocLength - parser.StackSize | 0xC0000000, MemoryDescriptor::USER_SPACE_SIZE - parser.StackSize, parser.StackSize);
+	Utility::MemCopy(desAddress, esp, MemoryDescriptor::USER_SPACE_SIZE - esp);
 	/* ͷڶexeļͱûջڴ棺mapAddressfakeStack */
 	kernelPgMgr.FreeMemory(allocLength, fakeStack);
 
@@ -692,6 +960,10 @@ void ProcessManager::Exec()
 		u.u_signal[i] = 0;
 	}
 
+	/* ³ĵַռԭȲͬرprofil() */
+	u.u_prof.pr_scale = 0;
+	u.u_prof.pr_ticks = 0;
+
 	/* 0ͨüĴ  */
 	for (int i = User::EAX - 4; i < User::EAX - 4*7 ; i = i - 4)
 	{
@@ -713,48 +985,161 @@ void ProcessManager::Exec()
 
 Process* ProcessManager::Select ()
 {
-	/* ǰһѡ̨ */
-	static int lastSelect = 0;
-	
-	while (true)
+	this->RunRun = 0;
+
+	/* Сķǿվλͼֱӵó޹ */
+	unsigned long flags = X86Assembly::SaveFlagsCLI();
+	if ( 0 == this->RunSummary )
+	{
+		X86Assembly::RestoreFlags(flags);
+		return NULL;
+	}
+	int word = X86Assembly::BSF(this->RunSummary);
+	int idx = word * 32 + X86Assembly::BSF(this->RunBitmap[word]);
+
+	/* ȡ׽̣ͬһĽ̨ */
+	Process* selected = this->RunQueue[idx];
+	this->RemoveRunQueue(selected);
+	X86Assembly::RestoreFlags(flags);
+
+	SwtchNum++;
+	if ( SwtchNum & 0x80000000 ) 
+	{
+		SwtchNum = 0;	/* ΪΪ */
+	}
+	/* ѡȼߵĿн */
+	this->CurPri = selected->p_pri;
+	return selected;
+}
+
+void ProcessManager::TraceSwtch(Process* selected)
+{
+	unsigned int now = (unsigned int)X86Assembly::RDTSC();
+	struct swtrace* pTrace = &this->SwtchTrace[this->SwtchTraceCnt % ProcessManager::NSWTRACE];
+
+	pTrace->tsc = this->SwtchStart;
+	pTrace->from = this->SwtchFrom;
+	pTrace->to = selected->p_pid;
+	pTrace->cycles = now - this->SwtchStart;
+	this->SwtchTraceCnt++;
+
+	TRACE(Trace::TR_SWTCH, this->SwtchFrom, selected->p_pid);
+}
+
+void ProcessManager::AddRunQueue(Process* pProcess)
+{
+	unsigned long flags = X86Assembly::SaveFlagsCLI();
+
+	if ( NULL == pProcess->p_forw )
 	{
-		int priority = 256;
-		int best = -1;	/* ҵ̨ */
+		int idx = pProcess->p_pri - ProcessManager::PRI_MIN;
+		if ( idx < 0 )
+		{
+			idx = 0;
+		}
+		else if ( idx >= ProcessManager::NRUNQ )
+		{
+			idx = ProcessManager::NRUNQ - 1;
+		}
+		pProcess->p_rqidx = idx;
 
-		this->RunRun = 0;
+		Process* head = this->RunQueue[idx];
+		if ( NULL == head )
+		{
+			pProcess->p_forw = pProcess;
+			pProcess->p_back = pProcess;
+			this->RunQueue[idx] = pProcess;
+			this->RunBitmap[idx >> 5] |= 1 << (idx & 31);
+			this->RunSummary |= 1 << (idx >> 5);
+		}
+		else
+		{
+			/* β֮ǰ */
+			pProcess->p_forw = head;
+			pProcess->p_back = head->p_back;
+			head->p_back->p_forw = pProcess;
+			head->p_back = pProcess;
+		}
+	}
+
+	X86Assembly::RestoreFlags(flags);
+}
+
+void ProcessManager::RemoveRunQueue(Process* pProcess)
+{
+	unsigned long flags = X86Assembly::SaveFlagsCLI();
 
-		/* ȼߵĿн */
-		for ( int count = 0; count < NPROC ; count++ )
+	if ( NULL != pProcess->p_forw )
+	{
+		int idx = pProcess->p_rqidx;
+		if ( pProcess->p_forw == pProcess )
 		{
-			/* һαѡн̵һʼػɨ裬ÿδ0#̿ʼ֤̻ */
-			int i = (lastSelect + 1 + count) % NPROC;
-			if ( Process::SRUN == process[i].p_stat && (process[i].p_flag & Process::SLOAD) != 0 )
+			this->RunQueue[idx] = NULL;
+			this->RunBitmap[idx >> 5] &= ~(1 << (idx & 31));
+			if ( 0 == this->RunBitmap[idx >> 5] )
 			{
-				if ( process[i].p_pri < priority )
-				{
-					best = i;
-					priority = process[i].p_pri;
-				}
+				this->RunSummary &= ~(1 << (idx >> 5));
 			}
 		}
-		if ( -1 == best )
+		else
 		{
-			__asm__ __volatile__("hlt");
-			continue;
+			pProcess->p_back->p_forw = pProcess->p_forw;
+			pProcess->p_forw->p_back = pProcess->p_back;
+			if ( this->RunQueue[idx] == pProcess )
+			{
+				this->RunQueue[idx] = pProcess->p_forw;
+			}
 		}
+		pProcess->p_forw = NULL;
+		pProcess->p_back = NULL;
+	}
+
+	X86Assembly::RestoreFlags(flags);
+}
+
+void ProcessManager::ChangePri(Process* pProcess, int priority)
+{
+	unsigned long flags = X86Assembly::SaveFlagsCLI();
+
+	if ( NULL != pProcess->p_forw )
+	{
+		this->RemoveRunQueue(pProcess);
+		pProcess->p_pri = priority;
+		this->AddRunQueue(pProcess);
+	}
+	else
+	{
+		pProcess->p_pri = priority;
+	}
+
+	X86Assembly::RestoreFlags(flags);
+}
 
-		SwtchNum++;
-		if ( SwtchNum & 0x80000000 ) 
+void ProcessManager::DecayRunQueue()
+{
+	unsigned long flags = X86Assembly::SaveFlagsCLI();
+	this->DecaySec++;
+
+	/* 
+	 * DecayCpu()ʹƵСĶл򱾶ĩβȡúٴ
+	 * ˥ĽٴʱDecayCpu()ֱӷأȻ
+	 */
+	for ( int idx = 0; idx < ProcessManager::NRUNQ; idx++ )
+	{
+		if ( 0 == (this->RunBitmap[idx >> 5] & (1 << (idx & 31))) )
+		{
+			continue;
+		}
+		Process* pProcess = this->RunQueue[idx];
+		while ( NULL != pProcess && pProcess->p_decay != this->DecaySec )
 		{
-			SwtchNum = 0;	/* ΪΪ */
+			Process* next = pProcess->p_forw;
+			pProcess->DecayCpu();
+			pProcess = (NULL != this->RunQueue[idx]) ? next : NULL;
 		}
-		/* ѡȼߵĿн */
-		this->CurPri = priority;
-		lastSelect = best;
-		//Diagnose::Write("Process %d is running!",best);
-		return &process[best];
-
 	}
+
+	X86Assembly::RestoreFlags(flags);
 }
 
 void ProcessManager::Kill()
@@ -764,31 +1149,28 @@ void ProcessManager::Kill()
 	int signal = u.u_arg[1];
 	bool flag = false;
 
-	for ( int i = 0; i < ProcessManager::NPROC; i++ )
+	/* pidΪ0ʱɢбֱҵĿ̣ϵͳ */
+	Process* pProcess = ( pid != 0 ) ? this->PFind(pid) : this->ProcList;
+	for ( ; NULL != pProcess; pProcess = ( pid != 0 ) ? NULL : pProcess->p_next )
 	{
 		/* źŸ */
-		if ( u.u_procp == &process[i] )
-		{
-			continue;
-		}
-		/* źŵĽշĿ̣Ѱ */
-		if ( pid != 0 && process[i].p_pid != pid)
+		if ( u.u_procp == pProcess )
 		{
 			continue;
 		}
 		/* pidΪ0źŷ뷢ͽͬһն˵н̣0#̲ */
-		if ( pid == 0 && (process[i].p_ttyp != u.u_procp->p_ttyp || i == 0 ) )
+		if ( pid == 0 && (pProcess->p_ttyp != u.u_procp->p_ttyp || pProcess == &process[0] ) )
 		{
 			continue;
 		}
 		/* ǳûҪ͡սu.uidͬɸû̷ź */
-		if ( u.u_uid != 0 && u.u_uid != process[i].p_uid )
+		if ( u.u_uid != 0 && u.u_uid != pProcess->p_uid )
 		{
 			continue;
 		}
 		flag = true;
 		/* źŷ͸Ŀ */
-		process[i].PSignal(signal);
+		pProcess->PSignal(signal);
 	}
 	if ( false == flag )
 	{
@@ -798,64 +1180,174 @@ void ProcessManager::Kill()
 
 void ProcessManager::WakeUpAll(unsigned long chan)
 {
-	/* ϵͳchan˯ߵĽ */
-	for(int i = 0; i < ProcessManager::NPROC; i++)
+	/* ϵͳchan˯ߵḶֻ̌ϵͳ */
+	for ( Process* pProcess = this->ProcList; NULL != pProcess; pProcess = pProcess->p_next )
 	{
-		if( this->process[i].IsSleepOn(chan) )
+		if( pProcess->IsSleepOn(chan) )
 		{
-			this->process[i].SetRun();
+			pProcess->SetRun();
 		}
 	}
 }
 
-void ProcessManager::XSwap( Process* pProcess, bool bFreeMemory, int size )
+Text* ProcessManager::XLookup(Inode* pInode)
 {
-	if ( 0 == size)
+	Text* pText = this->TextHash[(pInode->i_dev ^ pInode->i_number) & (NTEXTHASH - 1)];
+
+	for ( ; NULL != pText; pText = pText->x_forw )
 	{
-		size = pProcess->p_size;
+		if ( pText->x_iptr->i_dev == pInode->i_dev && pText->x_iptr->i_number == pInode->i_number )
+		{
+			return pText;
+		}
 	}
+	return NULL;
+}
+
+void ProcessManager::XHashInsert(Text* pText)
+{
+	Text** head = &this->TextHash[(pText->x_iptr->i_dev ^ pText->x_iptr->i_number) & (NTEXTHASH - 1)];
+
+	pText->x_forw = *head;
+	*head = pText;
+	pText->x_flag |= Text::XHASH;
+}
 
-	/* blkno¼䵽Ľʼ */
-	int blkno = Kernel::Instance().GetSwapperManager().AllocSwap(pProcess->p_size);
-	if ( 0 == blkno )
+void ProcessManager::XHashRemove(Text* pText)
+{
+	if ( (pText->x_flag & Text::XHASH) == 0 )
 	{
-		Utility::Panic("Out of Swapper Space");
+		return;
 	}
-	/* ݼͼڴУøĶεĽ */
-	if ( pProcess->p_textp != NULL )
+
+	Text** pp = &this->TextHash[(pText->x_iptr->i_dev ^ pText->x_iptr->i_number) & (NTEXTHASH - 1)];
+	for ( ; NULL != *pp; pp = &(*pp)->x_forw )
 	{
-		pProcess->p_textp->XccDec();
+		if ( *pp == pText )
+		{
+			*pp = pText->x_forw;
+			break;
+		}
 	}
-	/* ֹͬһͼظ */
-	pProcess->p_flag |= Process::SLOCK;
-	if ( false == Kernel::Instance().GetBufferManager().Swap(blkno, pProcess->p_addr, size, Buf::B_WRITE) )
+	pText->x_forw = NULL;
+	pText->x_flag &= ~Text::XHASH;
+}
+
+void ProcessManager::XCache(Text* pText)
+{
+	Inode* pInode = pText->x_iptr;
+
+	/* Ķѱϣ߿ִļѱɾٻ */
+	if ( (pText->x_flag & Text::XHASH) == 0 || pInode->i_nlink <= 0 )
 	{
-		Utility::Panic("Swap I/O Error");
+		this->XRelease(pText);
+		Kernel::Instance().GetFileManager().m_InodeTable->IPut(pInode);
+		return;
 	}
-	if ( bFreeMemory )
+
+	pText->x_lru = ++this->TextLru;
+	/* ISVTXĶγפ棬ֻڴTextṹʱṷ̋ */
+	if ( pInode->i_mode & Inode::ISVTX )
+	{
+		return;
+	}
+
+	pText->x_flag |= Text::XCACHE;
+	this->TextCacheSize += pText->x_size;
+	while ( this->TextCacheSize > ProcessManager::TEXT_CACHE_SIZE )
+	{
+		if ( false == this->XShrink(false) )
+		{
+			break;
+		}
+	}
+}
+
+bool ProcessManager::XShrink(bool sticky)
+{
+	Text* pSelected = NULL;
+
+	/* ̭δõͨĶΣISVTXĶ */
+	for ( int i = 0; i < ProcessManager::NTEXT; i++ )
+	{
+		Text* pText = &this->text[i];
+		if ( NULL == pText->x_iptr || 0 != pText->x_count )
+		{
+			continue;
+		}
+		if ( (pText->x_flag & Text::XCACHE) == 0 && !sticky )
+		{
+			continue;
+		}
+		if ( NULL == pSelected
+			|| ((pText->x_flag & Text::XCACHE) && (pSelected->x_flag & Text::XCACHE) == 0)
+			|| ((pText->x_flag & Text::XCACHE) == (pSelected->x_flag & Text::XCACHE) && pText->x_lru < pSelected->x_lru) )
+		{
+			pSelected = pText;
+		}
+	}
+	if ( NULL == pSelected )
+	{
+		return false;
+	}
+
+	Inode* pInode = pSelected->x_iptr;
+	this->XRelease(pSelected);
+	Kernel::Instance().GetFileManager().m_InodeTable->IPut(pInode);
+	return true;
+}
+
+void ProcessManager::XInvalidate(Inode* pInode)
+{
+	Text* pText = this->XLookup(pInode);
+	if ( NULL == pText )
 	{
-		Kernel::Instance().GetUserPageManager().FreeMemory(size, pProcess->p_addr);
+		return;
 	}
-	/* ѽͼڽʼż¼p_addrУSLOAD0̽ϵĽ */
-	pProcess->p_addr = blkno;
-	pProcess->p_flag &= ~(Process::SLOAD | Process::SLOCK);
-	/* һα򻻳ڳ򽻻פʱ䳤 */
-	pProcess->p_time = 0;
 
-	if ( this->RunOut )
+	/* нʹõĶҳ水ӿִļ룬ļܱд */
+	if ( 0 != pText->x_count )
 	{
-		this->RunOut = 0;
-		Kernel::Instance().GetProcessManager().WakeUpAll((unsigned long)&RunOut);
+		return;
+	}
+
+	/* ߳pInodeòҿѾܾIPut()ͷţֱӵݼü */
+	this->XRelease(pText);
+	pInode->i_count--;
+}
+
+void ProcessManager::XRelease(Text* pText)
+{
+	Inode* pInode = pText->x_iptr;
+
+	this->XHashRemove(pText);
+	if ( pText->x_flag & Text::XCACHE )
+	{
+		this->TextCacheSize -= pText->x_size;
+	}
+	Kernel::Instance().GetUserPageManager().FreeMemory(pText->x_size, pText->x_caddr);
+	pText->ClearLoaded();
+	pText->x_flag = 0;
+	pText->x_iptr = NULL;
+
+	/* ûTextṹøÿִļʱInodeITEXT־ */
+	for ( int i = 0; i < ProcessManager::NTEXT; i++ )
+	{
+		if ( pInode == this->text[i].x_iptr )
+		{
+			return;
+		}
 	}
+	pInode->i_flag &= ~Inode::ITEXT;
 }
 
 void ProcessManager::Signal( TTy* pTTy, int signal )
 {
-	for ( int i = 0; i < ProcessManager::NPROC; i++ )
+	for ( Process* pProcess = this->ProcList; NULL != pProcess; pProcess = pProcess->p_next )
 	{
-		if ( this->process[i].p_ttyp == pTTy )
+		if ( pProcess->p_ttyp == pTTy )
 		{
-			this->process[i].PSignal(signal);
+			pProcess->PSignal(signal);
 		}
 	}
 }
@@ -16,24 +16,85 @@ void Text::XccDec()
 	if ( this->x_ccount == 0 )
 		return;
 
-	/* x_ccountݼ0ͷŸùĶռݵڴ档*/
-	if ( --this->x_ccount == 0 )
-	{
-		Kernel::Instance().GetUserPageManager().FreeMemory(this->x_size, this->x_caddr);
-	}
+	/* Ķڴ汣Ķλ̭Textṹʱͷ */
+	this->x_ccount--;
 }
 
 void Text::XFree()
 {
 	this->XccDec();
 	/* 
-	 * øùĶεĽΪ0̶ֹ
-	 * ûбҪڽϱ湲Ķεĸ
+	 * øùĶεĽΪ0̶ֹ
+	 * Ķλͷڴ漰ԿִļInodeá
 	 */
 	if ( --this->x_count == 0 )
 	{
-		Kernel::Instance().GetSwapperManager().FreeSwap(this->x_size, this->x_daddr);
-		Kernel::Instance().GetFileManager().m_InodeTable->IPut(this->x_iptr);
-		this->x_iptr = NULL;
+		Kernel::Instance().GetProcessManager().XCache(this);
+	}
+}
+
+bool Text::IsLoaded(unsigned int pageIdx)
+{
+	return ( this->x_loaded[pageIdx >> 5] & (1 << (pageIdx & 0x1F)) ) != 0;
+}
+
+void Text::SetLoaded(unsigned int pageIdx)
+{
+	this->x_loaded[pageIdx >> 5] |= (1 << (pageIdx & 0x1F));
+}
+
+void Text::ClearLoaded()
+{
+	for ( unsigned int i = 0; i < Text::NPAGEMAP; i++ )
+	{
+		this->x_loaded[i] = 0;
 	}
 }
+
+bool Text::ReadPage(unsigned long virtualAddress, unsigned char* buffer)
+{
+	User& u = Kernel::Instance().GetUser();
+	unsigned long pageEnd = virtualAddress + PageManager::PAGE_SIZE;
+	bool ok = true;
+
+	/* ҳ0.bssԼsection֮Ŀ϶Ϊ0 */
+	int* pInt = (int *)buffer;
+	for ( unsigned int i = 0; i < PageManager::PAGE_SIZE / sizeof(int); i++ )
+	{
+		pInt[i] = 0;
+	}
+
+	/* 
+	 * ȱҳܷϵͳûռ䴫ݵĹУ
+	 * 豣ֳu.u_IOParamu.u_error
+	 */
+	IOParameter savedParam = u.u_IOParam;
+	User::ErrorCode savedError = u.u_error;
+	u.u_error = User::NOERROR;
+
+	for ( unsigned int i = 0; i < Text::NSECTION; i++ )
+	{
+		/* ҳsectionļݵص[begin, end) */
+		unsigned long begin = Utility::Max(virtualAddress, this->x_secaddr[i]);
+		unsigned long end = Utility::Min(pageEnd, this->x_secaddr[i] + this->x_secsize[i]);
+		if ( begin >= end )
+		{
+			continue;
+		}
+		u.u_IOParam.m_Base = buffer + (begin - virtualAddress);
+		u.u_IOParam.m_Offset = this->x_secoff[i] + (begin - this->x_secaddr[i]);
+		u.u_IOParam.m_Count = end - begin;
+		this->x_iptr->ReadI();
+
+		/* ̳ļض̣ҳݲ */
+		if ( User::NOERROR != u.u_error || 0 != u.u_IOParam.m_Count )
+		{
+			ok = false;
+			break;
+		}
+	}
+
+	u.u_IOParam = savedParam;
+	u.u_error = savedError;
+	return ok;
+}
@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <sys.h>
+#include <file.h>
+#include <string.h>
+
+/*
+ * 文件复制吞吐量测试：
+ *   copybench [KB]
+ * 先写一个KB千字节的源文件(缺省2048，即2MB)，再分别用cp原先的read()/write()
+ * 512字节循环和sendfile()复制到另一个文件，按时钟中断计数报告耗时、系统调用
+ * 次数与MB/s。缓存只有十几块，第二次复制几乎得不到第一次读入的源文件块。
+ */
+#define SRCNAME		"copybench.src"
+#define DSTNAME		"copybench.dst"
+
+char buf[4096];
+
+int parse_count(char* str)
+{
+	int n = 0;
+	while ( *str >= '0' && *str <= '9' )
+	{
+		n = n * 10 + (*str - '0');
+		str++;
+	}
+	return n;
+}
+
+void report(char* name, struct idlestat* start, struct idlestat* end, int kb, int calls)
+{
+	unsigned int ms = (end->ticks - start->ticks) * 1000 / end->hz;
+	unsigned int kbps;
+
+	if ( 0 == ms )
+	{
+		ms = 1;
+	}
+	kbps = kb * 1000 / ms;
+	printf("copybench: %s %d KB, %d calls, %d ms, %d.%d MB/s\n", name, kb, calls, ms,
+		kbps / 1024, kbps % 1024 * 10 / 1024);
+}
+
+int main1(int argc, char* argv[])
+{
+	struct idlestat start, end;
+	int kb = 2048;
+	int fds, fdd, i, n, calls;
+
+	if ( argc > 1 )
+		kb = parse_count(argv[1]);
+	if ( kb <= 0 )
+		kb = 1;
+
+	fds = creat(SRCNAME, 0777);
+	if ( fds < 0 )
+	{
+		printf("copybench: cannot create %s\n", SRCNAME);
+		return -1;
+	}
+	for ( i = 0; i < sizeof(buf); i++ )
+		buf[i] = 'a' + i % 26;
+	for ( i = 0; i < kb; i += 4 )
+	{
+		if ( write(fds, buf, kb - i < 4 ? (kb - i) * 1024 : sizeof(buf)) < 0 )
+		{
+			printf("copybench: write %s failed\n", SRCNAME);
+			close(fds);
+			unlink(SRCNAME);
+			return -1;
+		}
+	}
+	close(fds);
+
+	/* read()/write()，每次512字节 */
+	fds = open(SRCNAME, 1);
+	fdd = creat(DSTNAME, 0777);
+	calls = 0;
+	idlestat(&start, -1);
+	while ( (n = read(fds, buf, 512)) > 0 )
+	{
+		write(fdd, buf, n);
+		calls += 2;
+	}
+	calls++;
+	idlestat(&end, -1);
+	close(fds);
+	close(fdd);
+	report("read/write", &start, &end, kb, calls);
+
+	/* sendfile() */
+	unlink(DSTNAME);
+	fds = open(SRCNAME, 1);
+	fdd = creat(DSTNAME, 0777);
+	calls = 0;
+	idlestat(&start, -1);
+	while ( (n = sendfile(fdd, fds, 0x100000)) > 0 )
+	{
+		calls++;
+	}
+	calls++;
+	idlestat(&end, -1);
+	close(fds);
+	close(fdd);
+	if ( n < 0 )
+	{
+		printf("copybench: sendfile failed\n");
+	}
+	report("sendfile  ", &start, &end, kb, calls);
+
+	unlink(SRCNAME);
+	unlink(DSTNAME);
+	return 0;
+}
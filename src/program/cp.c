@@ -31,6 +31,18 @@ void cpfile(char *source,char *dest)
 	
 	int rbytes = 0;
 	int wbytes = 0;
+
+	// copy inside the kernel, buffer to buffer; fall back to
+	// read/write only if the source cannot be sent (not a regular file)
+	while ( (rbytes = sendfile(fdd, fds, 0x100000)) > 0 )
+		;
+	if ( rbytes == 0 )
+	{
+		close(fds);
+		close(fdd);
+		return;
+	}
+
 	while ( rbytes = read(fds, buf, 512) )
 	{
 		if ( rbytes < 0 )
@@ -59,7 +71,8 @@ void cpdir(char * source,char * dest,char * filename)
     char sourcebuf[100];
     char destbuf[100];
     char answer[2];
-    char item[32];
+    char dents[512];
+    struct dirent *ent;
     struct st_inode inode,inodet;
     
     
@@ -119,29 +132,22 @@ void cpdir(char * source,char * dest,char * filename)
                }
                
           }
-          count=read(fd,item,32);
-          while(count!=0)
+          //getdents() returns many valid entries per call,
+          //deleted entries (inode number 0) are skipped
+          while((count=getdents(fd,dents,sizeof(dents),0))>0)
           {
-                     if(((int)item[0])==0)
-                     {
-                           for(j=0;j<32;j++)
-                           item[j]='\0';
-                           count=read(fd,item,32);
-                     }
-                     else
-                     {  
+                for(j=0;j<count;j+=sizeof(struct dirent))
+                {
+                           ent=(struct dirent *)(dents+j);
                            strcpy(sourcebuf,source);
                            strcat(sourcebuf,"/");
-                           strcat(sourcebuf,item+4);
-                           cpdir(sourcebuf,destbuf,item+4);
-                           for(j=0;j<100;j++)
+                           strcat(sourcebuf,ent->d_name);
+                           cpdir(sourcebuf,destbuf,ent->d_name);
+                           for(i=0;i<100;i++)
                            {
-                               sourcebuf[j]='\0';
+                               sourcebuf[i]='\0';
                            }     
-                           for(j=0;j<32;j++)
-                           item[j]='\0';
-                           count=read(fd,item,32);
-                     }
+                }
           }
        close(fd);          
    }
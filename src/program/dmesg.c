@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <sys.h>
+#include <file.h>
+#include <string.h>
+
+/*
+ * 显示内核日志：
+ *   dmesg            显示内核日志，去掉每条消息开头的"<级别>"
+ *   dmesg -r         原样显示，保留级别
+ *   dmesg -c         显示后清空内核日志
+ *   dmesg -n level   只把级别不大于level(0 ~ 7)的消息回显到屏幕
+ */
+char buf[16384];
+
+int main1(int argc, char* argv[])
+{
+	int raw = 0, clear = 0, n, i, old;
+	char* line;
+
+	if ( argc > 2 && strcmp(argv[1], "-n") == 0 )
+	{
+		if ( (old = klog(KLOG_CONSOLE, 0, argv[2][0] - '0')) < 0 )
+		{
+			printf("dmesg: cannot set console level %s\n", argv[2]);
+			return -1;
+		}
+		printf("console level %d -> %c\n", old, argv[2][0]);
+		return 0;
+	}
+	for ( i = 1; i < argc; i++ )
+	{
+		if ( strcmp(argv[i], "-r") == 0 )
+			raw = 1;
+		else if ( strcmp(argv[i], "-c") == 0 )
+			clear = 1;
+		else
+		{
+			printf("usage: dmesg [-r] [-c] | dmesg -n level\n");
+			return -1;
+		}
+	}
+
+	if ( (n = klog(KLOG_READ, buf, sizeof(buf) - 1)) < 0 )
+	{
+		printf("dmesg: no kernel log\n");
+		return -1;
+	}
+	buf[n] = 0;
+
+	/* 逐行输出 */
+	line = buf;
+	for ( i = 0; i < n; i++ )
+	{
+		if ( '\n' != buf[i] )
+			continue;
+		buf[i] = 0;
+		if ( !raw && '<' == line[0] && 0 != line[1] && '>' == line[2] )
+			line += 3;
+		printf("%s\n", line);
+		line = &buf[i + 1];
+	}
+
+	if ( clear && klog(KLOG_CLEAR, 0, 0) < 0 )
+	{
+		printf("dmesg: cannot clear kernel log\n");
+		return -1;
+	}
+	return 0;
+}
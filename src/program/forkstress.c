@@ -0,0 +1,79 @@
+#include <stdio.h>
+#include <sys.h>
+#include <string.h>
+
+/*
+ * 进程表压力测试：共创建total个立即退出的子进程，同时存活的子进程最多width个，
+ * 每创建width个统计一次TSC周期数，用于观察进程数增多时fork + exit + wait的开销是否上升。
+ *   forkstress [total] [width]
+ * fork失败(进程表无法扩充或内存不足)时先回收已有子进程，再继续创建。
+ */
+unsigned int rdtsc()
+{
+	unsigned int low, high;
+	__asm__ __volatile__("rdtsc" : "=a"(low), "=d"(high));
+	return low;
+}
+
+int parse_count(char* str)
+{
+	int n = 0;
+	while ( *str >= '0' && *str <= '9' )
+	{
+		n = n * 10 + (*str - '0');
+		str++;
+	}
+	return n;
+}
+
+int main1(int argc, char* argv[])
+{
+	int total = 2000, width = 200;
+	int created = 0, alive = 0, failed = 0;
+	int pid = 0, status;
+	unsigned int start;
+
+	if ( argc > 1 )
+		total = parse_count(argv[1]);
+	if ( argc > 2 )
+		width = parse_count(argv[2]);
+	if ( total <= 0 )
+		total = 1;
+	if ( width <= 0 )
+		width = 1;
+
+	while ( created < total )
+	{
+		start = rdtsc();
+		while ( alive < width && created < total )
+		{
+			pid = fork();
+			if ( 0 == pid )
+			{
+				exit(0);
+			}
+			if ( -1 == pid )
+			{
+				failed++;
+				break;
+			}
+			created++;
+			alive++;
+		}
+		if ( -1 == pid && 0 == alive )
+		{
+			printf("fork failed with no child alive!\n");
+			break;
+		}
+		printf("created %d, alive %d, %d cycles per fork\n", created, alive, (rdtsc() - start) / (alive ? alive : 1));
+
+		/* 回收本轮创建的全部子进程 */
+		while ( alive > 0 && -1 != wait(&status) )
+		{
+			alive--;
+		}
+	}
+
+	printf("forkstress: %d processes, %d fork failures\n", created, failed);
+	return 0;
+}
@@ -0,0 +1,51 @@
+#include <stdio.h>
+#include <sys.h>
+#include <string.h>
+
+/*
+ * 空闲统计：在空闲的系统上睡眠secs秒，报告期间每秒的时钟中断数与空闲唤醒次数，
+ * 用于比较空闲时停止周期性时钟中断前后的唤醒频率。
+ *   idlestat [on|off] [secs]
+ */
+int parse_count(char* str)
+{
+	int n = 0;
+	while ( *str >= '0' && *str <= '9' )
+	{
+		n = n * 10 + (*str - '0');
+		str++;
+	}
+	return n;
+}
+
+int main1(int argc, char* argv[])
+{
+	struct idlestat before, after;
+	int mode = -1, secs = 5, i;
+
+	for ( i = 1; i < argc; i++ )
+	{
+		if ( strcmp(argv[i], "on") == 0 )
+			mode = 1;
+		else if ( strcmp(argv[i], "off") == 0 )
+			mode = 0;
+		else
+			secs = parse_count(argv[i]);
+	}
+	if ( secs <= 0 )
+		secs = 1;
+
+	if ( idlestat(&before, mode) < 0 )
+	{
+		printf("idlestat failed\n");
+		return -1;
+	}
+	sleep(secs);
+	idlestat(&after, -1);
+
+	printf("tickless %s, HZ = %d\n", after.tickless ? "on" : "off", after.hz);
+	printf("%d s: %d ticks, %d idle wakeups (%d/s), %d ticks skipped while idle\n",
+		secs, after.ticks - before.ticks, after.wakeups - before.wakeups,
+		(after.wakeups - before.wakeups) / secs, after.idleticks - before.idleticks);
+	return 0;
+}
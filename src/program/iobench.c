@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <sys.h>
+#include <file.h>
+#include <string.h>
+
+/*
+ * 定位读写与分散/集中读写的系统调用次数测试：
+ *   iobench [records]
+ * 1. 写：每条64字节的记录由头部、键、数据、校验4个字段组成，分别用4次write()
+ *    和1次writev()写入records条记录；
+ * 2. 读：按伪随机顺序读records次记录，分别用seek()+read()和pread()；
+ * 按时钟中断计数报告每种方式的耗时与系统调用次数。records缺省2000。
+ */
+#define RECSIZE		64
+#define FILENAME	"iobench.dat"
+
+char head[8], key[24], data[28], sum[4];
+char rec[RECSIZE];
+
+int parse_count(char* str)
+{
+	int n = 0;
+	while ( *str >= '0' && *str <= '9' )
+	{
+		n = n * 10 + (*str - '0');
+		str++;
+	}
+	return n;
+}
+
+void report(char* name, struct idlestat* start, struct idlestat* end, int calls)
+{
+	unsigned int ticks = end->ticks - start->ticks;
+	printf("iobench: %s %d calls, %d ms\n", name, calls, ticks * 1000 / end->hz);
+}
+
+int main1(int argc, char* argv[])
+{
+	struct idlestat start, end;
+	struct iovec iov[4];
+	int records = 2000;
+	int fd, i, calls;
+	unsigned int seed;
+
+	if ( argc > 1 )
+		records = parse_count(argv[1]);
+	if ( records <= 0 )
+		records = 1;
+
+	iov[0].iov_base = head;	iov[0].iov_len = sizeof(head);
+	iov[1].iov_base = key;	iov[1].iov_len = sizeof(key);
+	iov[2].iov_base = data;	iov[2].iov_len = sizeof(data);
+	iov[3].iov_base = sum;	iov[3].iov_len = sizeof(sum);
+
+	/* 逐字段write() */
+	fd = creat(FILENAME, 0777);
+	if ( fd < 0 )
+	{
+		printf("iobench: cannot create %s\n", FILENAME);
+		return -1;
+	}
+	calls = 0;
+	idlestat(&start, -1);
+	for ( i = 0; i < records; i++ )
+	{
+		head[0] = i;
+		write(fd, head, sizeof(head));
+		write(fd, key, sizeof(key));
+		write(fd, data, sizeof(data));
+		write(fd, sum, sizeof(sum));
+		calls += 4;
+	}
+	idlestat(&end, -1);
+	close(fd);
+	report("write x4 ", &start, &end, calls);
+
+	/* 每条记录一次writev() */
+	fd = creat(FILENAME, 0777);
+	calls = 0;
+	idlestat(&start, -1);
+	for ( i = 0; i < records; i++ )
+	{
+		head[0] = i;
+		if ( writev(fd, iov, 4) != RECSIZE )
+		{
+			printf("iobench: short writev\n");
+			break;
+		}
+		calls++;
+	}
+	idlestat(&end, -1);
+	close(fd);
+	report("writev   ", &start, &end, calls);
+
+	fd = open(FILENAME, 1);
+	if ( fd < 0 )
+	{
+		printf("iobench: cannot open %s\n", FILENAME);
+		return -1;
+	}
+
+	/* seek()+read()随机读 */
+	calls = 0;
+	seed = 1;
+	idlestat(&start, -1);
+	for ( i = 0; i < records; i++ )
+	{
+		seed = seed * 1103515245 + 12345;
+		seek(fd, (seed >> 8) % records * RECSIZE, 0);
+		read(fd, rec, RECSIZE);
+		calls += 2;
+	}
+	idlestat(&end, -1);
+	report("seek+read", &start, &end, calls);
+
+	/* pread()随机读，顺序相同 */
+	calls = 0;
+	seed = 1;
+	idlestat(&start, -1);
+	for ( i = 0; i < records; i++ )
+	{
+		seed = seed * 1103515245 + 12345;
+		if ( pread(fd, rec, RECSIZE, (seed >> 8) % records * RECSIZE) != RECSIZE )
+		{
+			printf("iobench: short pread\n");
+			break;
+		}
+		calls++;
+	}
+	idlestat(&end, -1);
+	report("pread    ", &start, &end, calls);
+
+	close(fd);
+	unlink(FILENAME);
+	return 0;
+}
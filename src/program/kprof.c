@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <sys.h>
+#include <file.h>
+#include <string.h>
+
+/*
+ * 内核统计采样：开始采样后运行命令，命令结束后停止采样，把样本写入文件，
+ * 每行为"eip caller pid mode ticks"，eip、caller为十六进制，mode为k或u。
+ * 将文件从磁盘映像中取出后，在宿主机上用tools/kprofsym对照kernel.sym还原函数名。
+ *   kprof [-o file] command [args...]
+ * 内核缓冲区可容纳约20秒的样本，超出部分被丢弃并在结束时报告。
+ */
+struct profsample samples[256];
+
+int main1(int argc, char* argv[])
+{
+	char* out = "kprof.out";
+	char line[64];
+	int first = 1, fd, n, i, status, pid, total = 0, dropped;
+
+	if ( argc > 2 && strcmp(argv[1], "-o") == 0 )
+	{
+		out = argv[2];
+		first = 3;
+	}
+	if ( first >= argc )
+	{
+		printf("usage: kprof [-o file] command [args...]\n");
+		return -1;
+	}
+
+	if ( (fd = creat(out, 0666)) < 0 )
+	{
+		printf("kprof: cannot create %s\n", out);
+		return -1;
+	}
+
+	if ( kprof(PROF_START, 0, 0) < 0 )
+	{
+		printf("kprof: must be super-user\n");
+		close(fd);
+		return -1;
+	}
+	pid = fork();
+	if ( 0 == pid )
+	{
+		execv(argv[first], &argv[first]);
+		printf("kprof: cannot exec %s\n", argv[first]);
+		exit(-1);
+	}
+	if ( pid > 0 )
+	{
+		wait(&status);
+	}
+	dropped = kprof(PROF_STOP, 0, 0);
+
+	while ( (n = kprof(PROF_READ, samples, 256)) > 0 )
+	{
+		for ( i = 0; i < n; i++ )
+		{
+			sprintf(line, "%x %x %d %c %d\n", samples[i].eip, samples[i].caller,
+				samples[i].pid, samples[i].mode ? 'u' : 'k', samples[i].ticks);
+			write(fd, line, strlen(line));
+		}
+		total += n;
+	}
+	close(fd);
+
+	printf("kprof: %d samples written to %s, %d dropped\n", total, out, dropped);
+	return 0;
+}
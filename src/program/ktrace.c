@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <sys.h>
+#include <file.h>
+#include <string.h>
+
+/*
+ * 内核跟踪：开启跟踪点，把环形缓冲区中的记录写入文件。
+ *   ktrace on [mask]                开始跟踪，mask为十六进制事件位图，第n位对应事件n，缺省为全部
+ *   ktrace off [file]               停止跟踪并写出
+ *   ktrace [-o file] command [args...]  跟踪命令运行的全过程
+ * 文件缺省为ktrace.out，依次为："KTRC"、记录长度、struct traceinfo长度、struct traceinfo、
+ * 各条struct tracerec。将文件从磁盘映像中取出后，在宿主机上用tools/ktrace2json转换为
+ * Chrome trace_event格式。缓冲区满后最早的记录被覆盖，结束时报告丢失的条数。
+ */
+struct tracerec recs[128];
+
+unsigned int parse_hex(char* str)
+{
+	unsigned int n = 0;
+	if ( str[0] == '0' && (str[1] == 'x' || str[1] == 'X') )
+	{
+		str += 2;
+	}
+	while ( 1 )
+	{
+		if ( *str >= '0' && *str <= '9' )
+			n = n * 16 + (*str - '0');
+		else if ( *str >= 'a' && *str <= 'f' )
+			n = n * 16 + (*str - 'a' + 10);
+		else if ( *str >= 'A' && *str <= 'F' )
+			n = n * 16 + (*str - 'A' + 10);
+		else
+			break;
+		str++;
+	}
+	return n;
+}
+
+int dump(char* out)
+{
+	struct traceinfo info;
+	unsigned int header[2];
+	int fd, n, total = 0, lost;
+
+	ktrace(KTR_STOP, 0, 0);
+	ktrace(KTR_INFO, &info, 0);
+
+	if ( (fd = creat(out, 0666)) < 0 )
+	{
+		printf("ktrace: cannot create %s\n", out);
+		return -1;
+	}
+	header[0] = sizeof(struct tracerec);
+	header[1] = sizeof(struct traceinfo);
+	write(fd, "KTRC", 4);
+	write(fd, (char *)header, sizeof(header));
+	write(fd, (char *)&info, sizeof(info));
+
+	while ( (n = ktrace(KTR_READ, recs, 128)) > 0 )
+	{
+		write(fd, (char *)recs, n * sizeof(struct tracerec));
+		total += n;
+	}
+	close(fd);
+
+	lost = info.total - total;
+	printf("ktrace: %d records written to %s, %d lost\n", total, out, lost > 0 ? lost : 0);
+	return 0;
+}
+
+int main1(int argc, char* argv[])
+{
+	char* out = "ktrace.out";
+	int first = 1, pid, status;
+
+	if ( argc > 1 && strcmp(argv[1], "on") == 0 )
+	{
+		if ( ktrace(KTR_START, (void *)(argc > 2 ? parse_hex(argv[2]) : 0), 0) < 0 )
+		{
+			printf("ktrace: cannot start tracing (no buffer or not super-user)\n");
+			return -1;
+		}
+		return 0;
+	}
+	if ( argc > 1 && strcmp(argv[1], "off") == 0 )
+	{
+		return dump(argc > 2 ? argv[2] : out);
+	}
+
+	if ( argc > 2 && strcmp(argv[1], "-o") == 0 )
+	{
+		out = argv[2];
+		first = 3;
+	}
+	if ( first >= argc )
+	{
+		printf("usage: ktrace on [mask] | ktrace off [file] | ktrace [-o file] command [args...]\n");
+		return -1;
+	}
+
+	if ( ktrace(KTR_START, 0, 0) < 0 )
+	{
+		printf("ktrace: cannot start tracing (no buffer or not super-user)\n");
+		return -1;
+	}
+	pid = fork();
+	if ( 0 == pid )
+	{
+		execv(argv[first], &argv[first]);
+		printf("ktrace: cannot exec %s\n", argv[first]);
+		exit(-1);
+	}
+	if ( pid > 0 )
+	{
+		wait(&status);
+	}
+	return dump(out);
+}
@@ -64,13 +64,12 @@ void usage()
 void main1(int argc, char **argv)
 {
  int fd;
- struct st_inode inode;//Initially "struct st_inode *inode" is wrong!
- char item[32];//store directory infos. 
- char pathbuf[100];
+ char dents[1536];//store directory entries returned by getdents()
+ struct dirent *ent;
+ struct direntplus *entp;
  int i=0;
  int j=0;
  int count;
- int ret;
 
  struct option options[]=
 {
@@ -146,80 +145,41 @@ if(flag==1)
      
          if(flagl!=1)
           {
-               
-               //Get directory infos:
-               
-                 
-                   count=read(fd,item,32);
-                   while(count!=0)                     
-                         {  
-                           if(((int) item[0])==0)//This is very important!
-                          //When some dir has been deleted, their dir name may
-                  //still exit in the item. The fact that the inode number
-                  //of an directory is "0" indicates that the dir is invalid.
-                            {
-                                  
-                             for(j=0;j<32;j++)
-                             item[j]='\0';      
-                             count=read(fd,item,32);
-                            }    
-                           else
-                           {
-                           printf("%s\t" ,item+4);
-                     
-                           for(j=0;j<32;j++)
-                           item[j]='\0';      
-                           count=read(fd,item,32);
-                           }
-
-                         }
-                   printf("\n");
-              
+               //Get directory infos, many entries per call.
+               //getdents() skips the deleted entries (inode number 0).
+               while((count=getdents(fd,dents,sizeof(dents),0))>0)
+               {
+                   for(j=0;j<count;j+=sizeof(struct dirent))
+                   {
+                       ent=(struct dirent *)(dents+j);
+                       printf("%s\t",ent->d_name);
+                   }
+               }
+               printf("\n");
           }
           else
           {
                   printf("permission\tnlink\towner\tgroup\tsize\tname\n");
-                  count=read(fd,item,32);
-                  while(count!=0)
-                  {    
-                       if(((int)item[0])==0)
-                       {
-
-                           for(j=0;j<32;j++)
-                           item[j]='\0';      
-                           count=read(fd,item,32);
-                        }          
-                        //get current path:
-                       else
-                       {
-                       strcpy(pathbuf,path[i]);//Combine parent path 
-                                         //and current item path
-                       strcat(pathbuf,"/");
-                       strcat(pathbuf,item+4);//to get real path
-                       
-                      //get inode infos:
-                       ret=stat(pathbuf,&inode);
-                       if(ret==-1)
-                       {
-                                  printf("Cannot read inode!\n");
-                                  return;
-                        }
- 
-                       permissions(inode.st_mode);
-                       printf("\t");
-                       printf("%d\t",inode.st_nlink);
-                       printf("root\t");
-                       printf("root\t");
-                       printf("%d\t",inode.st_size);
-                       printf("%s\n",item+4);
-                       
- 
-
-                       for(j=0;j<32;j++)
-                           item[j]='\0';
-                       count=read(fd,item,32);
-                     }
-                 }//while
+                  //plus mode returns the inode of each entry as well,
+                  //so there is no stat() per file.
+                  while((count=getdents(fd,dents,sizeof(dents),1))>0)
+                  {
+                      for(j=0;j<count;j+=sizeof(struct direntplus))
+                      {
+                          entp=(struct direntplus *)(dents+j);
+                          permissions(entp->d_stat.st_mode);
+                          printf("\t");
+                          printf("%d\t",entp->d_stat.st_nlink);
+                          printf("root\t");
+                          printf("root\t");
+                          printf("%d\t",entp->d_stat.st_size);
+                          printf("%s\n",entp->d_ent.d_name);
+                      }
+                  }
+                  if(count==-1)
+                  {
+                      printf("Cannot read inode!\n");
+                  }
              }
      
        close(fd);
@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <sys.h>
+
+/*
+ * 空系统调用开销：分别用int $0x80和C库的getpid()(CPU支持时经SYSENTER快速入口)
+ * 调用n次getpid()，报告每次调用的平均周期数。getpid()在内核中走精简分派路径，
+ * 测得的基本上就是进入、退出核心态的开销。
+ *   nullcall [n]
+ * 只取TSC低32位，单次测量不会超过2^32个周期。
+ */
+unsigned int rdtsc()
+{
+	unsigned int low, high;
+	__asm__ __volatile__("rdtsc" : "=a"(low), "=d"(high));
+	return low;
+}
+
+int parse_count(char* str)
+{
+	int n = 0;
+	while ( *str >= '0' && *str <= '9' )
+	{
+		n = n * 10 + (*str - '0');
+		str++;
+	}
+	return n;
+}
+
+int getpid_int80()
+{
+	int res;
+	__asm__ __volatile__ ( "int $0x80":"=a"(res):"a"(20));
+	return res;
+}
+
+int main1(int argc, char* argv[])
+{
+	int n = 100000, i;
+	unsigned int start, int80, lib;
+
+	if ( argc > 1 )
+		n = parse_count(argv[1]);
+	if ( n <= 0 )
+		n = 1;
+
+	/* 预热，并让C库选定系统调用入口 */
+	getpid_int80();
+	getpid();
+
+	start = rdtsc();
+	for ( i = 0; i < n; i++ )
+	{
+		getpid_int80();
+	}
+	int80 = rdtsc() - start;
+
+	start = rdtsc();
+	for ( i = 0; i < n; i++ )
+	{
+		getpid();
+	}
+	lib = rdtsc() - start;
+
+	printf("getpid x %d\n", n);
+	printf("  int $0x80: %d cycles/call\n", int80 / n);
+	printf("  %s: %d cycles/call\n", fastsyscall() ? "sysenter " : "int $0x80", lib / n);
+	return 0;
+}
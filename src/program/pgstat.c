@@ -0,0 +1,45 @@
+#include <stdio.h>
+#include <sys.h>
+
+/* 打印换页统计：两级交换区的换入、换出页数，内存交换池的压缩率以及换入延迟分布 */
+void print_latency(char* name, int* lat)
+{
+	int i;
+
+	printf("%s swap-in latency (K cycles):\n", name);
+	for ( i = 0; i < 12; i++ )
+	{
+		if ( 0 == lat[i] )
+			continue;
+		if ( 0 == i )
+			printf("  [0, 2)      %d\n", lat[i]);
+		else if ( 11 == i )
+			printf("  [%d, ...)   %d\n", 1 << i, lat[i]);
+		else
+			printf("  [%d, %d)    %d\n", 1 << i, 1 << (i + 1), lat[i]);
+	}
+}
+
+int main1(int argc, char* argv[])
+{
+	struct pgstat st;
+
+	if ( -1 == getpgstat(&st) )
+	{
+		printf("pgstat system call failed!\n");
+		return 1;
+	}
+
+	printf("page faults: %d, pages in: %d, pages out: %d\n", st.pgfault, st.pgin, st.pgout);
+	printf("zpool: out %d, in %d\n", st.zpgout, st.zpgin);
+	printf("disk : out %d, in %d\n", st.dpgout, st.dpgin);
+	if ( st.zcomp != 0 )
+	{
+		/* 压缩率以原始大小的百分比表示 */
+		printf("zpool compression: %d bytes -> %d bytes, %d percent of original\n", st.zorig, st.zcomp, st.zcomp / (st.zorig / 100));
+	}
+	print_latency("zpool", st.zlat);
+	print_latency("disk", st.dlat);
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <sys.h>
+#include <file.h>
+#include <string.h>
+
+/*
+ * 管道吞吐量测试，相当于dd if=/dev/zero bs=bs count=count | dd of=/dev/null bs=bs：
+ *   pipebench [bs] [count]
+ * 子进程向管道写count次、每次bs字节，父进程每次读bs字节直到读到文件结束，
+ * 按时钟中断计数报告耗时与吞吐量。bs缺省4096，最大16384；count缺省1024。
+ */
+char buf[16384];
+
+int parse_count(char* str)
+{
+	int n = 0;
+	while ( *str >= '0' && *str <= '9' )
+	{
+		n = n * 10 + (*str - '0');
+		str++;
+	}
+	return n;
+}
+
+int main1(int argc, char* argv[])
+{
+	struct idlestat start, end;
+	int bs = 4096, count = 1024;
+	int fd[2], pid, status, n, reads = 0, i;
+	unsigned int total = 0, ticks;
+
+	if ( argc > 1 )
+		bs = parse_count(argv[1]);
+	if ( argc > 2 )
+		count = parse_count(argv[2]);
+	if ( bs <= 0 || bs > sizeof(buf) )
+		bs = 4096;
+	if ( count <= 0 )
+		count = 1;
+
+	if ( pipe(fd) < 0 )
+	{
+		printf("pipebench: cannot create pipe\n");
+		return -1;
+	}
+
+	idlestat(&start, -1);
+	pid = fork();
+	if ( 0 == pid )
+	{
+		close(fd[0]);
+		for ( i = 0; i < count; i++ )
+		{
+			if ( write(fd[1], buf, bs) != bs )
+			{
+				printf("pipebench: short write\n");
+				break;
+			}
+		}
+		close(fd[1]);
+		exit(0);
+	}
+	if ( pid < 0 )
+	{
+		printf("pipebench: cannot fork\n");
+		return -1;
+	}
+
+	close(fd[1]);
+	while ( (n = read(fd[0], buf, bs)) > 0 )
+	{
+		total += n;
+		reads++;
+	}
+	close(fd[0]);
+	wait(&status);
+	idlestat(&end, -1);
+
+	ticks = end.ticks - start.ticks;
+	if ( 0 == ticks )
+	{
+		ticks = 1;
+	}
+	printf("pipebench: %d bytes in %d reads, %d ms, %d KB/s\n", total, reads,
+		ticks * 1000 / end.hz, (total / 1024) * end.hz / ticks);
+	return 0;
+}
@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <sys.h>
+#include <file.h>
+#include <string.h>
+
+/*
+ * 用poll()同时等待终端和管道：
+ *   polltest [n]
+ * 子进程每秒向管道写一行，共n行(缺省5)；父进程用poll()同时等待键盘输入和管道，
+ * 哪个就绪就处理哪个，两秒内都没有就绪时报告超时，管道写端关闭后结束。
+ * 管道读端设为O_NONBLOCK，就绪后一直读到返回-1，即把管道中的数据取空。
+ */
+char buf[256];
+
+int parse_count(char* str)
+{
+	int n = 0;
+	while ( *str >= '0' && *str <= '9' )
+	{
+		n = n * 10 + (*str - '0');
+		str++;
+	}
+	return n;
+}
+
+int main1(int argc, char* argv[])
+{
+	struct pollfd fds[2];
+	int fd[2], pid, status, n, i, count = 5;
+
+	if ( argc > 1 )
+		count = parse_count(argv[1]);
+
+	if ( pipe(fd) < 0 )
+	{
+		printf("polltest: cannot create pipe\n");
+		return -1;
+	}
+
+	pid = fork();
+	if ( 0 == pid )
+	{
+		close(fd[0]);
+		for ( i = 0; i < count; i++ )
+		{
+			sleep(1);
+			sprintf(buf, "pipe line %d\n", i);
+			write(fd[1], buf, strlen(buf));
+		}
+		close(fd[1]);
+		exit(0);
+	}
+	if ( pid < 0 )
+	{
+		printf("polltest: cannot fork\n");
+		return -1;
+	}
+	close(fd[1]);
+	fcntl(fd[0], F_SETFL, fcntl(fd[0], F_GETFL, 0) | O_NONBLOCK);
+
+	fds[0].fd = 0;
+	fds[0].events = POLLIN;
+	fds[1].fd = fd[0];
+	fds[1].events = POLLIN;
+
+	while ( 1 )
+	{
+		if ( (n = poll(fds, 2, 2000)) < 0 )
+		{
+			printf("polltest: poll failed\n");
+			break;
+		}
+		if ( 0 == n )
+		{
+			printf("polltest: timeout\n");
+			continue;
+		}
+		if ( fds[0].revents & POLLIN )
+		{
+			n = read(0, buf, sizeof(buf) - 1);
+			buf[n > 0 ? n : 0] = 0;
+			printf("tty: %s", buf);
+		}
+		if ( fds[1].revents & POLLIN )
+		{
+			while ( (n = read(fd[0], buf, sizeof(buf) - 1)) > 0 )
+			{
+				buf[n] = 0;
+				printf("%s", buf);
+			}
+			if ( 0 == n )
+			{
+				printf("polltest: pipe closed\n");
+				break;
+			}
+		}
+	}
+	close(fd[0]);
+	wait(&status);
+	return 0;
+}
@@ -0,0 +1,65 @@
+#include <stdio.h>
+#include <sys.h>
+#include <time.h>
+
+/*
+ * 延时睡眠测试：n个子进程同时各自用nanosleep()睡眠rounds次，每次ms毫秒，
+ * 父进程等待全部子进程结束后报告实际耗时，用于检验大量睡眠进程下定时器的开销与精度。
+ *   sleepers [n] [ms] [rounds]
+ */
+int parse_count(char* str)
+{
+	int n = 0;
+	while ( *str >= '0' && *str <= '9' )
+	{
+		n = n * 10 + (*str - '0');
+		str++;
+	}
+	return n;
+}
+
+int main1(int argc, char* argv[])
+{
+	int n = 100, ms = 50, rounds = 20;
+	int i, j, status, started = 0;
+	unsigned int start;
+	struct timespec req;
+
+	if ( argc > 1 )
+		n = parse_count(argv[1]);
+	if ( argc > 2 )
+		ms = parse_count(argv[2]);
+	if ( argc > 3 )
+		rounds = parse_count(argv[3]);
+
+	req.tv_sec = ms / 1000;
+	req.tv_nsec = (ms % 1000) * 1000000;
+
+	start = gtime();
+	for ( i = 0; i < n; i++ )
+	{
+		int pid = fork();
+		if ( 0 == pid )
+		{
+			for ( j = 0; j < rounds; j++ )
+			{
+				nanosleep(&req);
+			}
+			exit(0);
+		}
+		if ( -1 == pid )
+		{
+			printf("fork failed after %d sleepers\n", started);
+			break;
+		}
+		started++;
+	}
+	for ( i = 0; i < started; i++ )
+	{
+		wait(&status);
+	}
+
+	printf("%d sleepers x %d rounds x %d ms: expected %d s, elapsed %d s\n",
+		started, rounds, ms, rounds * ms / 1000, gtime() - start);
+	return 0;
+}
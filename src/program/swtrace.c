@@ -0,0 +1,44 @@
+#include <stdio.h>
+#include <sys.h>
+
+/*
+ * 打印内核记录的最近64次进程切换：每次切换从Swtch()开始到上台进程恢复现场
+ * 所经历的时钟周期数，以及平均值、最小值和最大值。swtrace [n]只列出最近n条。
+ */
+int main1(int argc, char* argv[])
+{
+	struct swtrace trace[64];
+	int i, n, show = 16;
+	unsigned int sum16 = 0, min = 0xFFFFFFFF, max = 0;
+
+	if ( argc > 1 )
+	{
+		show = 0;
+		for ( i = 0; argv[1][i] >= '0' && argv[1][i] <= '9'; i++ )
+			show = show * 10 + (argv[1][i] - '0');
+	}
+
+	n = swtrace(trace, 64);
+	if ( n <= 0 )
+	{
+		printf("no switch recorded!\n");
+		return 1;
+	}
+
+	for ( i = 0; i < n; i++ )
+	{
+		sum16 += trace[i].cycles >> 4;
+		if ( trace[i].cycles < min )
+			min = trace[i].cycles;
+		if ( trace[i].cycles > max )
+			max = trace[i].cycles;
+	}
+	printf("switches %d, avg %d cycles, min %d cycles, max %d cycles\n", n, sum16 / n * 16, min, max);
+
+	if ( show > n )
+		show = n;
+	printf("tsc         from  to    cycles\n");
+	for ( i = n - show; i < n; i++ )
+		printf("%x  %d  %d  %d\n", trace[i].tsc, trace[i].from, trace[i].to, trace[i].cycles);
+	return 0;
+}
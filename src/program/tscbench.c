@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <sys.h>
+#include <file.h>
+#include <string.h>
+
+/*
+ * 用时间戳计数器(TSC)测量进程切换和exec的开销：
+ *   tscbench pipe [n]  父子进程经两个管道往返传递1字节n次，报告每次往返与每次切换的周期数；
+ *   tscbench exec [n]  重复n次fork + execv("/bin/trivialProg") + wait，报告每次的周期数。
+ * 只取TSC低32位，单次测量不会超过2^32个周期。
+ */
+unsigned int rdtsc()
+{
+	unsigned int low, high;
+	__asm__ __volatile__("rdtsc" : "=a"(low), "=d"(high));
+	return low;
+}
+
+int parse_count(char* str)
+{
+	int n = 0;
+	while ( *str >= '0' && *str <= '9' )
+	{
+		n = n * 10 + (*str - '0');
+		str++;
+	}
+	return n;
+}
+
+void report(char* name, unsigned int sum16, unsigned int min, int n, int div)
+{
+	/* sum16为各次周期数右移4位之和，避免32位累加溢出 */
+	printf("%s: rounds %d, avg %d cycles, min %d cycles\n",
+		name, n, (sum16 / n) * 16 / div, min / div);
+}
+
+void bench_pipe(int n)
+{
+	int ping[2], pong[2];
+	int i, status, swtch;
+	char c = 'x';
+	unsigned int start, diff, sum16 = 0, min = 0xFFFFFFFF;
+
+	if ( -1 == pipe(ping) || -1 == pipe(pong) )
+	{
+		printf("pipe failed!\n");
+		return;
+	}
+
+	if ( 0 == fork() )
+	{
+		for ( i = 0; i < n; i++ )
+		{
+			read(ping[0], &c, 1);
+			write(pong[1], &c, 1);
+		}
+		exit(0);
+	}
+
+	swtch = getswtch();
+	for ( i = 0; i < n; i++ )
+	{
+		start = rdtsc();
+		write(ping[1], &c, 1);
+		read(pong[0], &c, 1);
+		diff = rdtsc() - start;
+		sum16 += diff >> 4;
+		if ( diff < min )
+			min = diff;
+	}
+	swtch = getswtch() - swtch;
+	wait(&status);
+
+	/* 一次往返至少包含两次进程切换，同时打印内核统计的每次往返实际切换次数以便核对 */
+	report("pipe round trip", sum16, min, n, 1);
+	report("context switch", sum16, min, n, 2);
+	printf("switches per round trip: %d.%d\n", swtch / n, swtch * 10 / n % 10);
+}
+
+void bench_exec(int n)
+{
+	char* argv[2];
+	int i, status;
+	unsigned int start, diff, sum16 = 0, min = 0xFFFFFFFF;
+
+	argv[0] = "trivialProg";
+	argv[1] = 0;
+
+	for ( i = 0; i < n; i++ )
+	{
+		start = rdtsc();
+		if ( 0 == fork() )
+		{
+			execv("/bin/trivialProg", argv);
+			exit(1);
+		}
+		wait(&status);
+		diff = rdtsc() - start;
+		sum16 += diff >> 4;
+		if ( diff < min )
+			min = diff;
+	}
+
+	report("fork+exec+wait", sum16, min, n, 1);
+}
+
+int main1(int argc, char* argv[])
+{
+	int n = 1000;
+
+	if ( argc < 2 )
+	{
+		printf("Usage: tscbench pipe|exec [n]\n");
+		return 1;
+	}
+	if ( argc > 2 )
+		n = parse_count(argv[2]);
+	if ( n <= 0 )
+		n = 1;
+
+	if ( 0 == strcmp(argv[1], "pipe") )
+		bench_pipe(n);
+	else if ( 0 == strcmp(argv[1], "exec") )
+		bench_exec(n);
+	else
+		printf("Usage: tscbench pipe|exec [n]\n");
+	return 0;
+}
@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <sys.h>
+#include <file.h>
+#include <string.h>
+
+/*
+ * 终端输出吞吐量测试：
+ *   ttybench [lines] [bs]
+ * 向标准输出写lines行、每行79个字符加换行，每次write()最多bs字节，
+ * 按时钟中断计数报告耗时与每秒输出的字符数。lines缺省1000，bs缺省4096，最大16384。
+ */
+char buf[16384];
+
+int parse_count(char* str)
+{
+	int n = 0;
+	while ( *str >= '0' && *str <= '9' )
+	{
+		n = n * 10 + (*str - '0');
+		str++;
+	}
+	return n;
+}
+
+int main1(int argc, char* argv[])
+{
+	struct idlestat start, end;
+	int lines = 1000, bs = 4096;
+	int i, n = 0;
+	unsigned int total = 0, ticks;
+
+	if ( argc > 1 )
+		lines = parse_count(argv[1]);
+	if ( argc > 2 )
+		bs = parse_count(argv[2]);
+	if ( lines <= 0 )
+		lines = 1;
+	if ( bs < 80 || bs > sizeof(buf) )
+		bs = 4096;
+
+	idlestat(&start, -1);
+	for ( i = 0; i < lines; i++ )
+	{
+		/* 每行内容不同，便于看出是否丢字符 */
+		int col;
+		for ( col = 0; col < 79; col++ )
+			buf[n + col] = 'A' + (i + col) % 26;
+		buf[n + 79] = '\n';
+		n += 80;
+
+		if ( n + 80 > bs || i == lines - 1 )
+		{
+			write(1, buf, n);
+			total += n;
+			n = 0;
+		}
+	}
+	idlestat(&end, -1);
+
+	ticks = end.ticks - start.ticks;
+	if ( 0 == ticks )
+	{
+		ticks = 1;
+	}
+	printf("ttybench: %d chars, %d ms, %d chars/s\n", total,
+		ticks * 1000 / end.hz, total / ticks * end.hz);
+	return 0;
+}
@@ -1,5 +1,6 @@
 #include "CRT.h"
 #include "IOPort.h"
+#include "Utility.h"
 
 unsigned short* CRT::m_VideoMemory = (unsigned short *)(0xB8000 + 0xC0000000);
 unsigned int CRT::m_CursorX = 0;
@@ -14,6 +15,10 @@ static unsigned short g_HistoryBufferData[CRT::HISTORY_LINES * CRT::COLUMNS];
 unsigned short* CRT::m_HistoryBuffer = g_HistoryBufferData;
 unsigned int CRT::m_TotalLines = 0;
 unsigned int CRT::m_ViewStartLine = 0;
+unsigned int CRT::m_HeadLine = 0;
+unsigned int CRT::m_DirtyFirst = CRT::HISTORY_LINES;
+unsigned int CRT::m_DirtyEnd = 0;
+bool CRT::m_FullRefresh = false;
 bool CRT::m_AutoScroll = true;
 
 void CRT::CRTStart(TTy* pTTy)
@@ -27,7 +32,12 @@ void CRT::CRTStart(TTy* pTTy)
 	{
 		m_Position = m_BeginChar;
 	}
+	if ( 0 == m_TotalLines )
+	{
+		InitHistory();
+	}
 
+	/* 一次取完输出队列，只更新历史缓冲区并记录脏行，最后统一刷新显存和光标 */
 	while ( (ch = pTTy->t_outq.GetChar()) != TTy::GET_ERROR )
 	{
 		switch (ch)
@@ -55,12 +65,14 @@ void CRT::CRTStart(TTy* pTTy)
 			m_Position++;
 			break;
 
-		default:	/* ����Ļ�ϻ�����ͨ�ַ� */
+		default:	/* 在屏幕上显示普通字符 */
 			WriteChar(ch);
 			m_Position++;
 			break;
 		}
-   }
+	}
+
+	Flush();
 }
 
 void CRT::MoveCursor(unsigned int col, unsigned int row)
@@ -85,92 +97,69 @@ void CRT::NextLine()
 	m_CursorX = 0;
 	m_CursorY += 1;
 
-	/* ���������ǰ�ܺ������������һ�� */
+	/* 光标超出当前总行数，新增一行 */
 	if ( m_CursorY >= m_TotalLines )
 	{
-		/* ���ֻ����HISTORY_LINES������ʷ���в��� */
 		if ( m_TotalLines < HISTORY_LINES )
 		{
 			m_TotalLines++;
 		}
 		else
 		{
-			/* ��ʷ�����������������ܷ��أ�*/
+			/* 历史缓冲区已满，丢弃最早的一行，屏幕上所有行都随之上移 */
 			ScrollScreen();
 			m_CursorY = HISTORY_LINES - 1;
+			if ( m_AutoScroll )
+			{
+				m_FullRefresh = true;
+			}
 		}
 	}
 
-	/* �Զ���������ײ� */
-	if ( m_AutoScroll && m_TotalLines > ROWS )
+	/* 自动滚动到最底部 */
+	if ( m_AutoScroll && m_TotalLines > ROWS && m_ViewStartLine != m_TotalLines - ROWS )
 	{
 		m_ViewStartLine = m_TotalLines - ROWS;
-		RefreshScreen();
-	}
-	else if ( m_AutoScroll )
-	{
-		RefreshScreen();
+		m_FullRefresh = true;
 	}
-
-	MoveCursor(m_CursorX, m_CursorY - m_ViewStartLine);
 }
 
 void CRT::BackSpace()
 {
-	m_CursorX--;
-
-	/* �ƶ���꣬���Ҫ�ص���һ�еĻ� */
-	if ( m_CursorX < 0 )
+	/* 移动光标，必要时回到上一行末尾 */
+	if ( m_CursorX > 0 )
+	{
+		m_CursorX--;
+	}
+	else if ( m_CursorY > 0 )
 	{
 		m_CursorX = CRT::COLUMNS - 1;
 		m_CursorY--;
-		if ( m_CursorY < 0 )
-		{
-			m_CursorY = 0;
-		}
 	}
-
-	/* �����ֻ������ʷ���� */
-	unsigned int bufferPos = m_CursorY * COLUMNS + m_CursorX;
-	m_HistoryBuffer[bufferPos] = ' ' | CRT::COLOR;
-
-	/* ���AutoScroll����ˢ����ʾ�ڴ� */
-	if ( m_AutoScroll && m_CursorY >= m_ViewStartLine && m_CursorY < m_ViewStartLine + ROWS )
+	else
 	{
-		unsigned int displayY = m_CursorY - m_ViewStartLine;
-		m_VideoMemory[displayY * COLUMNS + m_CursorX] = ' ' | CRT::COLOR;
+		return;
 	}
 
-	MoveCursor(m_CursorX, m_CursorY - m_ViewStartLine);
+	/* 擦除历史缓冲区中的字符，显存由Flush()更新 */
+	HistoryLine(m_CursorY)[m_CursorX] = ' ' | CRT::COLOR;
+	MarkDirty(m_CursorY);
 }
 
 void CRT::Tab()
 {
-	m_CursorX &= 0xFFFFFFF8;	/* ������뵽ǰһ��Tab�߽� */
+	m_CursorX &= 0xFFFFFFF8;	/* 光标对齐到前一个Tab边界 */
 	m_CursorX += 8;
 	// const int TabWidth = 10;
 	// m_CursorX -= m_CursorX % TabWidth;
 	// m_CursorX += TabWidth;
 	if ( m_CursorX >= CRT::COLUMNS )
 		NextLine();
-	else
-		MoveCursor(m_CursorX, m_CursorY);
 }
 
 void CRT::WriteChar(char ch)
 {
-	/* ȷ����ʷ�������С */
-	if ( m_TotalLines == 0 )
-	{
-		m_TotalLines = ROWS;
-		/* ��ʼ����ʷ������Ϊ�հ� */
-		for ( unsigned int i = 0; i < HISTORY_LINES * COLUMNS; i++ )
-		{
-			m_HistoryBuffer[i] = (unsigned short)' ' | CRT::COLOR;
-		}
-	}
-
-	/* �����Զ������ر�����������������Զ���������ײ� */
+	/* 如果自动滚动被关闭(用户在查看历史)，有新输出时回到最底部 */
 	if ( !m_AutoScroll )
 	{
 		m_AutoScroll = true;
@@ -182,19 +171,12 @@ void CRT::WriteChar(char ch)
 		{
 			m_ViewStartLine = 0;
 		}
-		RefreshScreen();
+		m_FullRefresh = true;
 	}
 
-	/* д����ʷ���������ǰλ�� */
-	unsigned int bufferPos = m_CursorY * COLUMNS + m_CursorX;
-	m_HistoryBuffer[bufferPos] = (unsigned char) ch | CRT::COLOR;
-
-	/* ��ʾ����ʾ�ڴ� */
-	if ( m_CursorY >= m_ViewStartLine && m_CursorY < m_ViewStartLine + ROWS )
-	{
-		unsigned int displayY = m_CursorY - m_ViewStartLine;
-		m_VideoMemory[displayY * COLUMNS + m_CursorX] = m_HistoryBuffer[bufferPos];
-	}
+	/* 只写入历史缓冲区，显存由Flush()按脏行更新 */
+	HistoryLine(m_CursorY)[m_CursorX] = (unsigned char) ch | CRT::COLOR;
+	MarkDirty(m_CursorY);
 
 	m_CursorX++;
 
@@ -202,10 +184,6 @@ void CRT::WriteChar(char ch)
 	{
 		NextLine();
 	}
-    else
-    {
-    	MoveCursor(m_CursorX, m_CursorY - m_ViewStartLine);
-    }
 }
 
 void CRT::ClearScreen()
@@ -220,36 +198,27 @@ void CRT::ClearScreen()
 
 void CRT::ScrollScreen()
 {
-	unsigned int i;
+	/* 清空最早的一行并把环的起点后移一行，该行即成为新的最后一行，不移动其它行 */
+	unsigned short* line = HistoryLine(0);
 
-	/* ����ʷ�����������һ�е����ݸ��Ƶ���һ�� */
-	for ( i = 0; i < COLUMNS * (HISTORY_LINES - 1); i++ )
+	for ( unsigned int i = 0; i < COLUMNS; i++ )
 	{
-		m_HistoryBuffer[i] = m_HistoryBuffer[i + COLUMNS];
-	}
-
-	/* ��������һ�� */
-	for ( i = COLUMNS * (HISTORY_LINES - 1); i < COLUMNS * HISTORY_LINES; i++ )
-	{
-		m_HistoryBuffer[i] = (unsigned short)' ' | CRT::COLOR;
+		line[i] = (unsigned short)' ' | CRT::COLOR;
 	}
+	m_HeadLine = (m_HeadLine + 1) % HISTORY_LINES;
 }
 
 void CRT::RefreshScreen()
 {
-	/* ����ʷ���������ݸ��Ƶ���Ļ */
+	/* 把视图窗口中的各行从历史缓冲区复制到显存 */
 	unsigned int displayLines = (m_TotalLines < ROWS) ? m_TotalLines : ROWS;
 
 	for ( unsigned int row = 0; row < displayLines; row++ )
 	{
-		unsigned int historyRow = m_ViewStartLine + row;
-		for ( unsigned int col = 0; col < COLUMNS; col++ )
-		{
-			m_VideoMemory[row * COLUMNS + col] = m_HistoryBuffer[historyRow * COLUMNS + col];
-		}
+		CopyLine(m_ViewStartLine + row, row);
 	}
 
-	/* �������ж����հ��� */
+	/* 不足一屏的部分显示为空白 */
 	for ( unsigned int row = displayLines; row < ROWS; row++ )
 	{
 		for ( unsigned int col = 0; col < COLUMNS; col++ )
@@ -257,6 +226,71 @@ void CRT::RefreshScreen()
 			m_VideoMemory[row * COLUMNS + col] = (unsigned short)' ' | CRT::COLOR;
 		}
 	}
+
+	/* 整屏已经刷新，之前记录的脏行都不需要再复制 */
+	m_FullRefresh = false;
+	m_DirtyFirst = HISTORY_LINES;
+	m_DirtyEnd = 0;
+}
+
+void CRT::Flush()
+{
+	if ( m_FullRefresh )
+	{
+		RefreshScreen();
+	}
+	else if ( m_DirtyFirst < m_DirtyEnd )
+	{
+		/* 只复制落在视图窗口中的脏行 */
+		unsigned int first = (m_DirtyFirst > m_ViewStartLine) ? m_DirtyFirst : m_ViewStartLine;
+		unsigned int end = (m_DirtyEnd < m_ViewStartLine + ROWS) ? m_DirtyEnd : m_ViewStartLine + ROWS;
+
+		for ( unsigned int line = first; line < end; line++ )
+		{
+			CopyLine(line, line - m_ViewStartLine);
+		}
+		m_DirtyFirst = HISTORY_LINES;
+		m_DirtyEnd = 0;
+	}
+
+	/* 每批输出只设置一次硬件光标 */
+	if ( m_CursorY >= m_ViewStartLine )
+	{
+		MoveCursor(m_CursorX, m_CursorY - m_ViewStartLine);
+	}
+}
+
+void CRT::InitHistory()
+{
+	m_TotalLines = ROWS;
+	m_HeadLine = 0;
+	for ( unsigned int i = 0; i < HISTORY_LINES * COLUMNS; i++ )
+	{
+		m_HistoryBuffer[i] = (unsigned short)' ' | CRT::COLOR;
+	}
+}
+
+unsigned short* CRT::HistoryLine(unsigned int line)
+{
+	return &m_HistoryBuffer[((m_HeadLine + line) % HISTORY_LINES) * COLUMNS];
+}
+
+void CRT::MarkDirty(unsigned int line)
+{
+	if ( line < m_DirtyFirst )
+	{
+		m_DirtyFirst = line;
+	}
+	if ( line + 1 > m_DirtyEnd )
+	{
+		m_DirtyEnd = line + 1;
+	}
+}
+
+void CRT::CopyLine(unsigned int line, unsigned int row)
+{
+	/* 一行为COLUMNS个双字节字符，按双字复制 */
+	Utility::DWordCopy((int *)HistoryLine(line), (int *)&m_VideoMemory[row * COLUMNS], COLUMNS / 2);
 }
 
 void CRT::ScrollUp(unsigned int lines)
@@ -279,9 +279,9 @@ ScanCodeTranslate(unsigned char scanCode, int expand)
 					}
 
 					ProcessManager& procMgr = Kernel::Instance().GetProcessManager();
-					for ( int killed = 0; killed < ProcessManager::NPROC ; killed ++ )
-						if ( procMgr.process[killed].p_pid > 1)
-							procMgr.process[killed].PSignal(User::SIGINT);
+					for ( Process* pProcess = procMgr.ProcList; NULL != pProcess; pProcess = pProcess->p_next )
+						if ( pProcess->p_pid > 1 )
+							pProcess->PSignal(User::SIGINT);
 				}
 				else
 				{
@@ -0,0 +1,165 @@
+#include "Serial.h"
+#include "IOPort.h"
+#include "Assembly.h"
+#include "Kernel.h"
+#include "KernelLog.h"
+
+/* COM1不作控制台时使用的TTy对象实例 */
+TTy g_SerialTTy;
+extern TTy g_TTy;
+
+/* 静态成员变量初始化 */
+TTy* Serial::m_TTy = NULL;
+bool Serial::m_TxBusy = false;
+
+bool Serial::Initialize()
+{
+	unsigned short divisor = Serial::BAUD_BASE / Serial::BAUD_RATE;
+
+	/* 暂存寄存器读写不一致说明没有UART */
+	IOPort::OutByte(COM1_PORT + SCR, 0x5A);
+	if ( IOPort::InByte(COM1_PORT + SCR) != 0x5A )
+	{
+		return false;
+	}
+
+	IOPort::OutByte(COM1_PORT + IER, 0);
+
+	/* 波特率、数据格式 */
+	IOPort::OutByte(COM1_PORT + LCR, LCR_DLAB);
+	IOPort::OutByte(COM1_PORT + DLL, divisor & 0xFF);
+	IOPort::OutByte(COM1_PORT + DLM, divisor >> 8);
+	IOPort::OutByte(COM1_PORT + LCR, LCR_8N1);
+
+	IOPort::OutByte(COM1_PORT + FCR, FCR_ENABLE | FCR_CLEAR_RCVR | FCR_CLEAR_XMIT | FCR_TRIGGER_8);
+
+	/* 回环自检，失败说明UART不可用 */
+	IOPort::OutByte(COM1_PORT + MCR, MCR_LOOP | MCR_RTS | MCR_DTR);
+	IOPort::OutByte(COM1_PORT + THR, 0xAE);
+	for ( int i = 0; i < 10000 && (IOPort::InByte(COM1_PORT + LSR) & LSR_DR) == 0; i++ );
+	if ( IOPort::InByte(COM1_PORT + RBR) != 0xAE )
+	{
+		IOPort::OutByte(COM1_PORT + MCR, 0);
+		return false;
+	}
+
+	/* IIR高两位为11说明FIFO已启用，即16550A */
+	if ( (IOPort::InByte(COM1_PORT + IIR) & 0xC0) != 0xC0 )
+	{
+		KernelLog::Printf(KernelLog::LOG_WARNING, "Serial: COM1 has no FIFO, one interrupt per character\n");
+	}
+
+	Serial::m_TTy = Serial::CONSOLE ? &g_TTy : &g_SerialTTy;
+	Serial::m_TTy->t_oproc = Serial::Start;
+	Serial::m_TxBusy = false;
+
+	IOPort::OutByte(COM1_PORT + MCR, MCR_DTR | MCR_RTS | MCR_OUT2);
+	IOPort::OutByte(COM1_PORT + IER, IER_RDI | IER_THRI | IER_RLSI);
+
+	KernelLog::Printf(KernelLog::LOG_INFO, "Serial: COM1 at %u baud%s\n", Serial::BAUD_RATE, Serial::CONSOLE ? ", console" : "");
+	return true;
+}
+
+void Serial::SerialHandler(struct pt_regs* reg, struct pt_context* context)
+{
+	unsigned char iir;
+
+	/* 同一次中断中可能有多个原因，读IIR直至没有待处理的中断 */
+	while ( ((iir = IOPort::InByte(COM1_PORT + IIR)) & IIR_NO_INT) == 0 )
+	{
+		switch ( iir & IIR_ID )
+		{
+		case IIR_RDI:
+		case IIR_TIMEOUT:
+			/* 一次取空接收FIFO */
+			while ( IOPort::InByte(COM1_PORT + LSR) & LSR_DR )
+			{
+				Serial::Receive(IOPort::InByte(COM1_PORT + RBR));
+			}
+			break;
+
+		case IIR_THRI:
+			Serial::Transmit();
+			break;
+
+		case IIR_RLSI:
+			IOPort::InByte(COM1_PORT + LSR);	/* 读LSR清除错误状态 */
+			break;
+
+		default:
+			IOPort::InByte(COM1_PORT + MSR);
+			break;
+		}
+	}
+}
+
+void Serial::Start(TTy* pTTy)
+{
+	unsigned long flags = X86Assembly::SaveFlagsCLI();
+
+	/* 正在发送时，由发送完毕产生的中断继续取字符 */
+	if ( !Serial::m_TxBusy )
+	{
+		Serial::Transmit();
+	}
+	X86Assembly::RestoreFlags(flags);
+}
+
+void Serial::Transmit()
+{
+	TTy_Queue& outq = Serial::m_TTy->t_outq;
+	int before = outq.CharNum();
+	int n = 0;
+	bool raw = ( Serial::m_TTy->t_flags & TTy::RAW ) != 0;
+
+	while ( outq.CharNum() > 0 )
+	{
+		char ch = *outq.CurrentChar();
+
+		/* 终端上换行需要"\r\n"，退格需要"\b \b"才能擦去字符；原始方式原样发送 */
+		int need = raw ? 1 : ( '\n' == ch ) ? 2 : ( TTy::CERASE == ch ) ? 3 : 1;
+		if ( n + need > Serial::FIFO_SIZE )
+		{
+			break;
+		}
+		outq.GetChar();
+
+		if ( !raw && '\n' == ch )
+		{
+			IOPort::OutByte(COM1_PORT + THR, '\r');
+		}
+		else if ( !raw && TTy::CERASE == ch )
+		{
+			IOPort::OutByte(COM1_PORT + THR, '\b');
+			IOPort::OutByte(COM1_PORT + THR, ' ');
+		}
+		IOPort::OutByte(COM1_PORT + THR, ch);
+		n += need;
+	}
+	Serial::m_TxBusy = ( n > 0 );
+
+	/* 输出队列降到低水位，唤醒在TTy::TTWrite()中等待的进程 */
+	if ( before > TTy::TTLOWAT && outq.CharNum() <= TTy::TTLOWAT )
+	{
+		Kernel::Instance().GetProcessManager().WakeUpAll((unsigned long)&outq);
+		FileManager::PollWakeUp();
+	}
+}
+
+void Serial::Receive(char ch)
+{
+	/* 终端的回车、删除键分别对应换行和退格，原始方式下不转换 */
+	if ( (Serial::m_TTy->t_flags & TTy::RAW) == 0 )
+	{
+		if ( '\r' == ch )
+		{
+			ch = '\n';
+		}
+		else if ( 0x7F == ch )
+		{
+			ch = TTy::CERASE;
+		}
+	}
+
+	Serial::m_TTy->TTyInput(ch);
+}
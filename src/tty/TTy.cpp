@@ -58,13 +58,49 @@ char* TTy_Queue::CurrentChar()
 	return &this->m_CharBuf[m_Tail];
 }
 
+int TTy_Queue::FreeNum()
+{
+	return TTY_BUF_SIZE - 1 - this->CharNum();
+}
+
+int TTy_Queue::PutChars(const char* src, int count)
+{
+	int n = 0;
+
+	count = Utility::Min(count, this->FreeNum());
+	while ( n < count )
+	{
+		/* ÿθƵĩβΪֹݾλƶm_Headжϳ򲻻ȡδƵַ */
+		int run = Utility::Min(count - n, TTY_BUF_SIZE - this->m_Head);
+		Utility::MemCopy((unsigned long)(src + n), (unsigned long)&this->m_CharBuf[this->m_Head], run);
+		n += run;
+		this->m_Head = ( this->m_Head + run ) & (TTY_BUF_SIZE - 1);
+	}
+	return n;
+}
+
+int TTy_Queue::GetChars(char* dst, int count)
+{
+	int n = 0;
+
+	count = Utility::Min(count, this->CharNum());
+	while ( n < count )
+	{
+		int run = Utility::Min(count - n, TTY_BUF_SIZE - this->m_Tail);
+		Utility::MemCopy((unsigned long)&this->m_CharBuf[this->m_Tail], (unsigned long)(dst + n), run);
+		n += run;
+		this->m_Tail = ( this->m_Tail + run ) & (TTY_BUF_SIZE - 1);
+	}
+	return n;
+}
+
 /*==============================class TTy===============================*/
 /* ̨ʵĶ */
 TTy g_TTy;
 
 TTy::TTy()
 {
-
+	this->t_oproc = NULL;
 }
 
 TTy::~TTy()
@@ -77,23 +113,49 @@ TTy::~TTy()
  * ֱΪգӦó֮裨u.u_IOParam.m_Count Ϊ  0
  * 䣬п˯һ Ϊ׼Ϊգԭʼûж
  * ûûسܶԭʼеݽ޸ģ
+ * ԭʼʽ(RAW)²йֻҪԭʼֱַȡߡ
  * */
 void TTy::TTRead()
 {
+	User& u = Kernel::Instance().GetUser();
+	int n;
+
 	/* 豸ûпʼ */
 	if ( (this->t_state & TTy::CARR_ON) == 0 )
 	{
 		return;
 	}
 
-	if ( this->t_canq.CharNum() || this->Canon() )
+	if ( this->t_flags & TTy::RAW )
+	{
+		X86Assembly::CLI();
+		while ( 0 == this->t_rawq.CharNum() )
+		{
+			if ( (this->t_state & TTy::CARR_ON) == 0 )
+			{
+				X86Assembly::STI();
+				return;
+			}
+			u.u_procp->Sleep((unsigned long)&this->t_rawq, ProcessManager::TTIPRI);
+		}
+		X86Assembly::STI();
+
+		n = this->t_rawq.GetChars((char *)u.u_IOParam.m_Base, u.u_IOParam.m_Count);
+	}
+	else if ( this->t_canq.CharNum() || this->Canon() )
 	{
-		while ( this->t_canq.CharNum() && (this->PassC(this->t_canq.GetChar()) >= 0) );
+		n = this->t_canq.GetChars((char *)u.u_IOParam.m_Base, u.u_IOParam.m_Count);
 	}
+	else
+	{
+		return;
+	}
+	u.u_IOParam.m_Base += n;
+	u.u_IOParam.m_Count -= n;
 }
 
 /*
- * һһֽڵؽûеȴͱ׼С
+ * ûеȴݳɿ鸴Ƶ׼УÿθƵеĻƵΪֹ
  * ˢԴ档 ̻ˢ¡
  * CRT::m_BeginCharָдһַĵԪBackSpaceԲָ֮ǰκַ
  */
@@ -107,7 +169,8 @@ void TTy::TTWrite()
 	 * ܻᵼʱжӦӳ٣أ
 	 * û
 	 */
-	char ch;
+	int n;
+	User& u = Kernel::Instance().GetUser();
 	
 	 /* 豸ûпʼ */
 	if ( (this->t_state & TTy::CARR_ON) == 0 )
@@ -115,21 +178,39 @@ void TTy::TTWrite()
 		return;
 	}
 
-	while ( (ch = CPass()) > 0 )
+	while ( u.u_IOParam.m_Count > 0 )
 	{
-		/*г涨ַҪϿʾ */
-		if ( this->t_outq.CharNum() > TTy::TTHIWAT)
+		/* ҪϿʾ */
+		if ( 0 == this->t_outq.FreeNum() )
 		{
 			this->TTStart();
-			/* BeginCharַָУδȷϲֵʼ
-			 * ĿڲBackspaceɾдڱ׼ϵݣƩʾ֮ࡣ
-			 */
-			CRT::m_BeginChar = this->t_outq.CurrentChar();
+			if ( NULL != this->t_oproc )
+			{
+				/* ڵ豸жȡַȶнˮλټ */
+				X86Assembly::CLI();
+				while ( this->t_outq.CharNum() > TTy::TTLOWAT )
+				{
+					u.u_procp->Sleep((unsigned long)&this->t_outq, ProcessManager::TTOPRI);
+				}
+				X86Assembly::STI();
+			}
+			else
+			{
+				/* BeginCharַָУδȷϲֵʼ
+				 * ĿڲBackspaceɾдڱ׼ϵݣƩʾ֮ࡣ
+				 */
+				CRT::m_BeginChar = this->t_outq.CurrentChar();
+			}
 		}
-		this->TTyOutput(ch);
+		n = this->t_outq.PutChars((char *)u.u_IOParam.m_Base, u.u_IOParam.m_Count);
+		u.u_IOParam.m_Base += n;
+		u.u_IOParam.m_Count -= n;
 	}
 	this->TTStart();
-	CRT::m_BeginChar = this->t_outq.CurrentChar();
+	if ( NULL == this->t_oproc )
+	{
+		CRT::m_BeginChar = this->t_outq.CurrentChar();
+	}
 	/* BeginCharΪ˷ֹɾӡַҪʾ棬ǰ
 	 * ַڱɾʱܱɾʵѾɾˡ
 	 */
@@ -158,10 +239,19 @@ void TTy::TTyInput(char ch)
 	/* ַԭʼַ */
 	this->t_rawq.PutChar(ch);
 
-	//if ( this->t_flags & TTy::RAW || ch == '\n' || ch == TTy::CEOT )
-	if ( ch == '\n' || ch == TTy::CEOT )
+	if ( this->t_flags & TTy::RAW )
+	{
+		/* ԭʼʽ붨ֻڶΪʱ˯ */
+		if ( 1 == this->t_rawq.CharNum() )
+		{
+			Kernel::Instance().GetProcessManager().WakeUpAll((unsigned long)&this->t_rawq);
+			FileManager::PollWakeUp();
+		}
+	}
+	else if ( ch == '\n' || ch == TTy::CEOT )
 	{
 		Kernel::Instance().GetProcessManager().WakeUpAll((unsigned long)&this->t_rawq);
+		FileManager::PollWakeUp();
 		this->t_rawq.PutChar(0x7);
 		this->t_delct++;
 	}
@@ -195,6 +285,11 @@ void TTy::TTyOutput(char ch)
 
 void TTy::TTStart()
 {
+	if ( NULL != this->t_oproc )
+	{
+		this->t_oproc(this);
+		return;
+	}
 	CRT::CRTStart(this);
 }
 
@@ -262,38 +357,41 @@ int TTy::Canon()
     return 1;
 }
 
-int TTy::PassC(char ch)
+int TTy::SgTTy(int flags)
 {
-	User& u = Kernel::Instance().GetUser();
+	int old = this->t_flags;
 
-	/* ַûĿ */
-	if ( u.u_IOParam.m_Count > 0 )
+	if ( flags >= 0 )
 	{
-		*(u.u_IOParam.m_Base++) = ch;
-		//u.u_IOParam.m_Offset++;
-		u.u_IOParam.m_Count--;
-		return 0;
+		/* лԭʼʽʱԭȷʽ۵ */
+		if ( (flags ^ old) & TTy::RAW )
+		{
+			X86Assembly::CLI();
+			while ( this->t_canq.GetChar() >= 0 );
+			while ( this->t_rawq.GetChar() >= 0 );
+			this->t_delct = 0;
+			X86Assembly::STI();
+		}
+		this->t_flags = flags;
 	}
-	return -1;
+	return old;
 }
 
-char TTy::CPass()
+bool TTy::ReadReady()
 {
-	char ch;
-	User& u = Kernel::Instance().GetUser();
-
-	ch = *(u.u_IOParam.m_Base++);
-	if ( u.u_IOParam.m_Count > 0 )
+	/* 豸ûпʼʱ */
+	if ( (this->t_state & TTy::CARR_ON) == 0 )
 	{
-		u.u_IOParam.m_Count--;
-		//u.u_IOParam.m_Offset++;
-		return ch;
+		return true;
 	}
-	else
+	if ( this->t_flags & TTy::RAW )
 	{
-		return -1;
+		return this->t_rawq.CharNum() > 0;
 	}
+	return this->t_canq.CharNum() > 0 || this->t_delct > 0;
 }
 
-
-
+bool TTy::WriteReady()
+{
+	return this->t_outq.FreeNum() > 0;
+}
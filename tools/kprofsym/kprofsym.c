@@ -0,0 +1,219 @@
+/*
+ * kprofsym：在宿主机上还原UNIX V6++内核统计采样(kprof)的结果。
+ *
+ *   gcc -O2 -o kprofsym kprofsym.c
+ *   kprofsym kernel.sym kprof.out [top]
+ *
+ * kernel.sym为内核编译时nm生成的符号表(targets\UNIXV6++\kernel.sym)，kprof.out为
+ * 程序kprof写出的样本文件，每行"eip caller pid mode ticks"。输出：
+ *   1. 平面剖析：各内核函数的时钟中断数及比例，用户态样本按进程汇总；
+ *   2. 调用点剖析：核心态样本按"调用点 -> 被中断函数"汇总，调用点以函数+偏移表示。
+ * 每部分最多列出top项，默认30。C++符号名可经c++filt -_还原。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct symbol
+{
+	unsigned long addr;
+	char* name;
+};
+
+struct entry
+{
+	char* name;
+	unsigned long ticks;
+};
+
+static struct symbol* syms;
+static int nsyms;
+
+static struct entry* entries;
+static int nentries, capentries;
+
+static int cmp_symbol(const void* a, const void* b)
+{
+	unsigned long x = ((const struct symbol*)a)->addr, y = ((const struct symbol*)b)->addr;
+	return x < y ? -1 : x > y;
+}
+
+static int cmp_entry(const void* a, const void* b)
+{
+	unsigned long x = ((const struct entry*)a)->ticks, y = ((const struct entry*)b)->ticks;
+	return x > y ? -1 : x < y;
+}
+
+static void load_symbols(const char* path)
+{
+	FILE* fp = fopen(path, "r");
+	char line[1024], type, name[1024];
+	unsigned long addr;
+	int cap = 0;
+
+	if ( NULL == fp )
+	{
+		perror(path);
+		exit(1);
+	}
+	while ( fgets(line, sizeof(line), fp) )
+	{
+		/* 只取代码段符号，名字可能带空格(nm -C) */
+		if ( sscanf(line, "%lx %c %1023[^\r\n]", &addr, &type, name) != 3 || (type != 'T' && type != 't') )
+		{
+			continue;
+		}
+		if ( nsyms == cap )
+		{
+			cap = cap ? cap * 2 : 1024;
+			syms = realloc(syms, cap * sizeof(struct symbol));
+		}
+		syms[nsyms].addr = addr;
+		syms[nsyms].name = strdup(name);
+		nsyms++;
+	}
+	fclose(fp);
+	qsort(syms, nsyms, sizeof(struct symbol), cmp_symbol);
+}
+
+/* 返回addr所在函数，即起始地址不大于addr的最后一个符号 */
+static struct symbol* lookup(unsigned long addr)
+{
+	int lo = 0, hi = nsyms - 1, found = -1;
+
+	while ( lo <= hi )
+	{
+		int mid = (lo + hi) / 2;
+		if ( syms[mid].addr <= addr )
+		{
+			found = mid;
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid - 1;
+		}
+	}
+	return found < 0 ? NULL : &syms[found];
+}
+
+static void add_entry(const char* name, unsigned long ticks)
+{
+	int i;
+
+	for ( i = 0; i < nentries; i++ )
+	{
+		if ( strcmp(entries[i].name, name) == 0 )
+		{
+			entries[i].ticks += ticks;
+			return;
+		}
+	}
+	if ( nentries == capentries )
+	{
+		capentries = capentries ? capentries * 2 : 256;
+		entries = realloc(entries, capentries * sizeof(struct entry));
+	}
+	entries[nentries].name = strdup(name);
+	entries[nentries].ticks = ticks;
+	nentries++;
+}
+
+static void print_entries(const char* title, unsigned long total, int top)
+{
+	int i;
+
+	qsort(entries, nentries, sizeof(struct entry), cmp_entry);
+	printf("\n%s\n", title);
+	printf("%8s %7s  %s\n", "ticks", "%", "where");
+	for ( i = 0; i < nentries && i < top; i++ )
+	{
+		printf("%8lu %6.2f%%  %s\n", entries[i].ticks, total ? 100.0 * entries[i].ticks / total : 0.0, entries[i].name);
+	}
+	for ( i = 0; i < nentries; i++ )
+	{
+		free(entries[i].name);
+	}
+	nentries = 0;
+}
+
+static void format_addr(char* buf, size_t size, unsigned long addr)
+{
+	struct symbol* sym = lookup(addr);
+
+	if ( NULL == sym )
+		snprintf(buf, size, "0x%lx", addr);
+	else
+		snprintf(buf, size, "%s+0x%lx", sym->name, addr - sym->addr);
+}
+
+int main(int argc, char* argv[])
+{
+	FILE* fp;
+	char line[256], mode, name[2200], from[1100];
+	unsigned long eip, caller, ticks, total = 0, kernel = 0;
+	int pid, top = 30, pass;
+
+	if ( argc < 3 )
+	{
+		fprintf(stderr, "usage: %s kernel.sym kprof.out [top]\n", argv[0]);
+		return 1;
+	}
+	if ( argc > 3 )
+	{
+		top = atoi(argv[3]);
+	}
+	load_symbols(argv[1]);
+
+	/* 第一遍平面剖析，第二遍调用点剖析 */
+	for ( pass = 0; pass < 2; pass++ )
+	{
+		if ( NULL == (fp = fopen(argv[2], "r")) )
+		{
+			perror(argv[2]);
+			return 1;
+		}
+		while ( fgets(line, sizeof(line), fp) )
+		{
+			if ( sscanf(line, "%lx %lx %d %c %lu", &eip, &caller, &pid, &mode, &ticks) != 5 )
+			{
+				continue;
+			}
+			if ( 0 == pass )
+			{
+				total += ticks;
+				if ( 'u' == mode )
+				{
+					snprintf(name, sizeof(name), "[user] pid %d", pid);
+				}
+				else
+				{
+					struct symbol* sym = lookup(eip);
+					kernel += ticks;
+					snprintf(name, sizeof(name), "%s", sym ? sym->name : "[unknown]");
+				}
+				add_entry(name, ticks);
+			}
+			else if ( 'k' == mode && 0 != caller )
+			{
+				struct symbol* sym = lookup(eip);
+				format_addr(from, sizeof(from), caller);
+				snprintf(name, sizeof(name), "%s -> %s", from, sym ? sym->name : "[unknown]");
+				add_entry(name, ticks);
+			}
+		}
+		fclose(fp);
+
+		if ( 0 == pass )
+		{
+			printf("%lu ticks, kernel %lu (%.1f%%), user %lu\n",
+				total, kernel, total ? 100.0 * kernel / total : 0.0, total - kernel);
+			print_entries("Flat profile:", total, top);
+		}
+		else
+		{
+			print_entries("Call sites (kernel):", kernel, top);
+		}
+	}
+	return 0;
+}
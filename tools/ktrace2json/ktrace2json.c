@@ -0,0 +1,228 @@
+/*
+ * ktrace2json：在宿主机上把UNIX V6++内核跟踪(ktrace)的结果转换为Chrome trace_event格式，
+ * 用chrome://tracing或https://ui.perfetto.dev打开，按时间轴查看。
+ *
+ *   gcc -O2 -o ktrace2json ktrace2json.c
+ *   ktrace2json [-m MHz] ktrace.out > trace.json
+ *
+ * ktrace.out为程序ktrace写出的文件。时间戳由TSC换算为微秒，每微秒的时钟周期数按文件中
+ * 记录的时钟中断计数与TSC之比估算，虚拟机中不准时可用-m指定CPU主频。输出：
+ *   1. "CPU"轨道：按进程切换记录画出各进程占用CPU的时间片；
+ *   2. 每个进程一条轨道：系统调用的进入与返回、睡眠与被唤醒、页面换出与换入；
+ *   3. 块设备I/O：从Strategy()到IODone()的异步区间，按缓存控制块区分。
+ * 记录按内核中32位x86的结构布局逐字节解析，与宿主机的字长和对齐无关。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#define TR_SWTCH	1
+#define TR_SLEEP	2
+#define TR_WAKEUP	3
+#define TR_SYSCALL	4
+#define TR_SYSRET	5
+#define TR_STRATEGY	6
+#define TR_IODONE	7
+#define TR_SWAPOUT	8
+#define TR_SWAPIN	9
+
+#define CPU_TID		100000	/* "CPU"轨道的tid，不与进程pid冲突 */
+
+static const char* sysnames[64] =
+{
+	"indir", "exit", "fork", "read", "write", "open", "close", "wait",
+	"creat", "link", "unlink", "exec", "chdir", "time", "mknod", "chmod",
+	"chown", "sbreak", "stat", "seek", "getpid", "mount", "umount", "setuid",
+	"getuid", "stime", "ptrace", "pgstat", "fstat", "trace", "smdate", "stty",
+	"gtty", "nanosleep", "nice", "sleep", "sync", "kill", "switch", "pwd",
+	"idlestat", "dup", "pipe", "times", "prof", "kprof", "setgid", "getgid",
+	"sig", "swtrace", "ktrace"
+};
+
+static unsigned char insyscall[32768];	/* 各进程是否有未返回的系统调用 */
+static int seen[32768];					/* 已输出过thread_name的进程 */
+static int first = 1;
+
+static unsigned long get32(const unsigned char* p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+static unsigned long long get64(const unsigned char* p)
+{
+	return get32(p) | ((unsigned long long)get32(p + 4) << 32);
+}
+
+static void event(const char* fmt, ...)
+{
+	va_list ap;
+	printf(first ? "\n" : ",\n");
+	first = 0;
+	va_start(ap, fmt);
+	vprintf(fmt, ap);
+	va_end(ap);
+}
+
+static void name_thread(int pid)
+{
+	if ( pid < 0 || seen[pid] )
+	{
+		return;
+	}
+	seen[pid] = 1;
+	event("{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":\"pid %d\"}}", pid, pid);
+}
+
+static const char* sysname(unsigned long num)
+{
+	static char buf[16];
+	if ( num < 64 && sysnames[num] )
+	{
+		return sysnames[num];
+	}
+	snprintf(buf, sizeof(buf), "sys%lu", num);
+	return buf;
+}
+
+int main(int argc, char* argv[])
+{
+	FILE* fp;
+	unsigned char header[12], info[64], rec[64];
+	unsigned long recsize, infosize;
+	unsigned long long tsc0, tsc1, tsc;
+	unsigned long hz, ticks0, ticks1, arg0, arg1;
+	double mhz = 0, ts, runstart = 0;
+	int arg = 1, pid, running = -1;
+	unsigned int ev;
+
+	if ( argc > 2 && strcmp(argv[1], "-m") == 0 )
+	{
+		mhz = atof(argv[2]);
+		arg = 3;
+	}
+	if ( arg >= argc )
+	{
+		fprintf(stderr, "usage: %s [-m MHz] ktrace.out > trace.json\n", argv[0]);
+		return 1;
+	}
+	if ( NULL == (fp = fopen(argv[arg], "rb")) )
+	{
+		perror(argv[arg]);
+		return 1;
+	}
+
+	if ( fread(header, 1, sizeof(header), fp) != sizeof(header) || memcmp(header, "KTRC", 4) != 0 )
+	{
+		fprintf(stderr, "%s: not a ktrace file\n", argv[arg]);
+		return 1;
+	}
+	recsize = get32(header + 4);
+	infosize = get32(header + 8);
+	if ( recsize < 20 || recsize > sizeof(rec) || infosize < 36 || infosize > sizeof(info)
+		|| fread(info, 1, infosize, fp) != infosize )
+	{
+		fprintf(stderr, "%s: bad header\n", argv[arg]);
+		return 1;
+	}
+
+	/* struct traceinfo：tsc0、tsc1、hz、ticks0、ticks1、total、size */
+	tsc0 = get64(info);
+	tsc1 = get64(info + 8);
+	hz = get32(info + 16);
+	ticks0 = get32(info + 20);
+	ticks1 = get32(info + 24);
+	if ( 0 == mhz )
+	{
+		if ( ticks1 == ticks0 || 0 == hz )
+		{
+			fprintf(stderr, "trace too short to calibrate TSC, use -m MHz\n");
+			return 1;
+		}
+		mhz = (double)(tsc1 - tsc0) / ((double)(ticks1 - ticks0) * 1000000.0 / hz);
+	}
+	fprintf(stderr, "%.1f cycles/us\n", mhz);
+
+	printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+	event("{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"UNIX V6++\"}}");
+	event("{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":\"CPU\"}}", CPU_TID);
+	event("{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_sort_index\",\"args\":{\"sort_index\":-1}}", CPU_TID);
+
+	/* struct tracerec：tsc、event、pid、arg0、arg1 */
+	while ( fread(rec, 1, recsize, fp) == recsize )
+	{
+		tsc = get64(rec);
+		ev = rec[8] | (rec[9] << 8);
+		pid = (short)(rec[10] | (rec[11] << 8));
+		arg0 = get32(rec + 12);
+		arg1 = get32(rec + 16);
+		ts = (double)(long long)(tsc - tsc0) / mhz;
+		if ( pid < 0 )
+		{
+			continue;
+		}
+		name_thread(pid);
+
+		switch ( ev )
+		{
+		case TR_SWTCH:
+			if ( running >= 0 && ts > runstart )
+			{
+				event("{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"name\":\"pid %d\"}",
+					CPU_TID, runstart, ts - runstart, running);
+			}
+			running = arg1 & 0x7FFF;
+			runstart = ts;
+			break;
+
+		case TR_SLEEP:
+			event("{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"name\":\"sleep\",\"args\":{\"chan\":\"0x%lx\",\"pri\":%ld}}",
+				pid, ts, arg0, (long)(int)arg1);
+			break;
+
+		case TR_WAKEUP:
+			name_thread(arg0 & 0x7FFF);
+			event("{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%lu,\"ts\":%.3f,\"name\":\"wakeup\",\"args\":{\"chan\":\"0x%lx\",\"by\":%d}}",
+				arg0 & 0x7FFF, ts, arg1, pid);
+			break;
+
+		case TR_SYSCALL:
+			/* exit()等不返回的系统调用留下未配对的B，由下一次进入关闭 */
+			if ( insyscall[pid] )
+			{
+				event("{\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}", pid, ts);
+			}
+			insyscall[pid] = 1;
+			event("{\"ph\":\"B\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"name\":\"%s\"}", pid, ts, sysname(arg0));
+			break;
+
+		case TR_SYSRET:
+			/* 开始跟踪前进入的系统调用、fork()子进程的返回没有对应的进入 */
+			if ( insyscall[pid] )
+			{
+				insyscall[pid] = 0;
+				event("{\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"ret\":%ld}}", pid, ts, (long)(int)arg1);
+			}
+			break;
+
+		case TR_STRATEGY:
+		case TR_IODONE:
+			event("{\"ph\":\"%s\",\"cat\":\"disk\",\"id\":\"0x%lx\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"name\":\"%s %lu\"}",
+				TR_STRATEGY == ev ? "b" : "e", arg1, pid, ts,
+				(arg0 & 0x80000000) ? "read" : "write", arg0 & 0x7FFFFFFF);
+			break;
+
+		case TR_SWAPOUT:
+		case TR_SWAPIN:
+			event("{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"name\":\"%s\",\"args\":{\"handle\":%lu}}",
+				pid, ts - arg1 / mhz, arg1 / mhz, TR_SWAPOUT == ev ? "swapout" : "swapin", arg0);
+			break;
+
+		default:
+			break;
+		}
+	}
+	printf("\n]}\n");
+	fclose(fp);
+	return 0;
+}